@@ -124,6 +124,7 @@ macro(ev_loop_setup_options)
   option(ev_loop_BUILD_FUZZ_TESTS "Enable fuzz testing executable" ${DEFAULT_FUZZER})
   option(ev_loop_BUILD_BENCHMARKS "Build benchmark executables" ON)
   option(ev_loop_BUILD_EXAMPLES "Build example executables" ON)
+  option(ev_loop_ENABLE_USDT "Compile USDT probes into the queue and dispatch paths (needs sys/sdt.h)" OFF)
 
 endmacro()
 
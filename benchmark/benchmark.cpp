@@ -1,7 +1,9 @@
-#include <chrono>
+#include "harness.hpp"
+
 #include <cstddef>
 #include <ev_loop/ev.hpp>
 #include <print>
+#include <string_view>
 #include <tuple>
 
 // =============================================================================
@@ -62,94 +64,50 @@ struct B
 
 namespace {
 
-template<typename Count, typename Duration> auto events_per_second(Count event_count, Duration elapsed) -> long long
+constexpr int kIterations = 10'000'000;
+constexpr std::size_t kHybridSpinCount = 1000;
+
+// Starts the loop and times kIterations polls between run.start() and run.stop()
+template<template<typename> typename Strategy, typename Loop, typename... Args>
+void poll_iterations(Loop& loop, ev_bench::Run& run, Args... args)
 {
-  using seconds_double = std::chrono::duration<double>;
-  const auto seconds = std::chrono::duration_cast<seconds_double>(elapsed).count();
-  return static_cast<long long>(static_cast<double>(event_count) / seconds);
+  loop.start();
+  loop.emit(Ping{ 0 });
+  Strategy strategy{ loop, args... };
+  run.start();
+  for (int i = 0; i < kIterations; ++i) { std::ignore = strategy.poll(); }
+  run.stop();
 }
 
-} // namespace
-
-// NOLINTNEXTLINE(bugprone-exception-escape) - std::println may throw but we accept that in benchmarks
-int main()
+template<template<typename> typename Strategy, typename... Args>
+void benchmark_poll(ev_bench::Harness& harness, std::string_view name, Args... args)
 {
-  using namespace std::chrono;
-
-  constexpr int kIterations = 10'000'000;
-  constexpr std::size_t kHybridSpinCount = 1000;
-
-  // Spin strategy benchmark
-  {
+  harness.run(name, kIterations, [&](ev_bench::Run& run) {
     ev_loop::EventLoop<A, B> loop;
-    loop.start();
-    loop.emit(Ping{ 0 });
-
-    ev_loop::Spin strategy{ loop };
-    const auto started = steady_clock::now();
-    for (int i = 0; i < kIterations; ++i) { std::ignore = strategy.poll(); }
-    const auto elapsed = steady_clock::now() - started;
-
-    std::println("Spin::poll():   {} us ({} events/sec)",
-      duration_cast<microseconds>(elapsed).count(),
-      events_per_second(kIterations, elapsed));
-
+    poll_iterations<Strategy>(loop, run, args...);
     loop.stop();
-  }
-
-  // Yield strategy benchmark
-  {
-    ev_loop::EventLoop<A, B> loop;
-    loop.start();
-    loop.emit(Ping{ 0 });
-
-    ev_loop::Yield strategy{ loop };
-    const auto started = steady_clock::now();
-    for (int i = 0; i < kIterations; ++i) { std::ignore = strategy.poll(); }
-    const auto elapsed = steady_clock::now() - started;
-
-    std::println("Yield::poll():  {} us ({} events/sec)",
-      duration_cast<microseconds>(elapsed).count(),
-      events_per_second(kIterations, elapsed));
-
+  });
+
+  // --perf: PerfCounters makes the loop observed, so the counters come from a separate, untimed loop
+  if (harness.perf_pass(name)) {
+    ev_loop::EventLoop<A, B, ev_loop::PerfCounters> loop;
+    ev_bench::Run untimed;
+    poll_iterations<Strategy>(loop, untimed, args...);
+    // Hardware counters per event of every loop thread, or n/a where perf_event_open is not permitted
+    std::print("{}", loop.perf_counters().snapshot().table(kIterations));
     loop.stop();
   }
+}
 
-  // Hybrid strategy benchmark
-  {
-    ev_loop::EventLoop<A, B> loop;
-    loop.start();
-    loop.emit(Ping{ 0 });
-
-    ev_loop::Hybrid strategy{ loop, kHybridSpinCount };
-    const auto started = steady_clock::now();
-    for (int i = 0; i < kIterations; ++i) { std::ignore = strategy.poll(); }
-    const auto elapsed = steady_clock::now() - started;
-
-    std::println("Hybrid::poll(): {} us ({} events/sec)",
-      duration_cast<microseconds>(elapsed).count(),
-      events_per_second(kIterations, elapsed));
-
-    loop.stop();
-  }
-
-  // Wait strategy benchmark
-  {
-    ev_loop::EventLoop<A, B> loop;
-    loop.start();
-    loop.emit(Ping{ 0 });
-
-    ev_loop::Wait strategy{ loop };
-    const auto started = steady_clock::now();
-    for (int i = 0; i < kIterations; ++i) { std::ignore = strategy.poll(); }
-    const auto elapsed = steady_clock::now() - started;
-
-    std::println("Wait::poll():   {} us ({} events/sec)",
-      duration_cast<microseconds>(elapsed).count(),
-      events_per_second(kIterations, elapsed));
-
-    loop.stop();
-  }
+} // namespace
 
-  return 0;
+// NOLINTNEXTLINE(bugprone-exception-escape) - std::println may throw but we accept that in benchmarks
+int main(int argc, char** argv)
+{
+  ev_bench::Harness harness(argc, argv);
+  benchmark_poll<ev_loop::Spin>(harness, "Spin::poll");
+  benchmark_poll<ev_loop::Yield>(harness, "Yield::poll");
+  benchmark_poll<ev_loop::Hybrid>(harness, "Hybrid::poll", kHybridSpinCount);
+  benchmark_poll<ev_loop::Wait>(harness, "Wait::poll");
+  return harness.finish();
 }
@@ -0,0 +1,245 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+// Compile-time scaling: generates one translation unit per topology size and compiles it with the project's
+// compiler, recording wall time, compiler CPU time and peak compiler memory. Every generated loop has
+// `receivers` receivers and 8/3 as many event types (our production topology is around 150 and 400). Each
+// receiver handles three event types and emits three others, and every tenth is OwnThread, so the type-list
+// machinery, fast_dispatch and the OwnThread routing are instantiated at full width.
+//
+// The harness tracks compile wall time (ns/item is ns per compile), so --json/--baseline catch template-level
+// regressions; the table after each size adds CPU time, peak RSS and object size.
+//
+// Command line, besides the harness flags:
+//   --cxx PATH        compiler to run (default c++)
+//   --flag ARG        argument passed to the compiler, repeatable (e.g. --flag -std=c++23 --flag -Iinclude)
+//   --sizes LIST      comma-separated receiver counts (default 10,25,50,100,150)
+//   --work-dir DIR    where the generated sources and objects go (default ./compile_scaling)
+//
+// `cmake --build <dir> --target compile_scaling` runs it with the project's compiler, standard and includes.
+
+extern char** environ; // NOLINT(readability-redundant-declaration)
+
+namespace {
+
+constexpr std::size_t kReceivesPerReceiver = 3;
+constexpr std::size_t kEmitsPerReceiver = 3;
+constexpr std::size_t kOwnThreadEvery = 10;
+
+struct Options
+{
+  std::string cxx = "c++";
+  std::vector<std::string> flags;
+  std::vector<std::size_t> sizes{ 10, 25, 50, 100, 150 };
+  std::filesystem::path work_dir = "compile_scaling";
+  std::vector<char*> harness_args;
+};
+
+[[nodiscard]] std::size_t events_for(std::size_t receivers) noexcept
+{
+  return std::max<std::size_t>((receivers * 8) / 3, kReceivesPerReceiver + kEmitsPerReceiver);
+}
+
+// Receiver idx handles kReceivesPerReceiver consecutive events and emits the ones right after them
+[[nodiscard]] std::string generate(std::size_t receivers)
+{
+  const std::size_t events = events_for(receivers);
+  std::string out;
+  out += "// Generated by ev_benchmark_compile: " + std::to_string(receivers) + " receivers, "
+         + std::to_string(events) + " event types\n#include <cstdint>\n#include <ev_loop/ev.hpp>\n\n";
+  for (std::size_t event = 0; event < events; ++event) {
+    out += "struct E" + std::to_string(event) + " { std::uint64_t value; };\n";
+  }
+  const auto event_name = [&](std::size_t idx) { return "E" + std::to_string(idx % events); };
+  for (std::size_t idx = 0; idx < receivers; ++idx) {
+    const std::size_t first = idx * kReceivesPerReceiver;
+    const std::size_t first_emit = first + kReceivesPerReceiver;
+    out += "\nstruct R" + std::to_string(idx) + "\n{\n  using receives = ev_loop::type_list<";
+    for (std::size_t each = 0; each < kReceivesPerReceiver; ++each) {
+      out += (each == 0 ? "" : ", ") + event_name(first + each);
+    }
+    out += ">;\n  using emits = ev_loop::type_list<";
+    for (std::size_t each = 0; each < kEmitsPerReceiver; ++each) {
+      out += (each == 0 ? "" : ", ") + event_name(first_emit + each);
+    }
+    out += ">;\n  using thread_mode = ev_loop::";
+    out += idx % kOwnThreadEvery == kOwnThreadEvery - 1 ? "OwnThread" : "SameThread";
+    out += ";\n  std::uint64_t sum = 0;\n";
+    for (std::size_t each = 0; each < kReceivesPerReceiver; ++each) {
+      out += "  template<typename D> void on_event(" + event_name(first + each) + " e, D& d)\n  {\n"
+             + "    sum += e.value;\n    d.emit(" + event_name(first_emit + (each % kEmitsPerReceiver))
+             + "{ e.value + 1 });\n  }\n";
+    }
+    out += "};\n";
+  }
+  out += "\nusing Loop = ev_loop::EventLoop<";
+  for (std::size_t idx = 0; idx < receivers; ++idx) { out += (idx == 0 ? "R" : ", R") + std::to_string(idx); }
+  out += ">;\n\nint main()\n{\n  Loop loop;\n  loop.start();\n  loop.emit(E0{ 0 });\n"
+         "  ev_loop::Spin spin{ loop };\n  static_cast<void>(spin.poll());\n  loop.stop();\n"
+         "  return static_cast<int>(loop.get<R0>().sum);\n}\n";
+  return out;
+}
+
+struct Compile
+{
+  bool ok = false;
+  std::chrono::duration<double, std::nano> wall{};
+  std::chrono::duration<double> cpu{};
+  std::uint64_t peak_rss_bytes = 0;
+};
+
+[[nodiscard]] double seconds_of(const timeval& value) noexcept
+{
+  return static_cast<double>(value.tv_sec) + (static_cast<double>(value.tv_usec) / 1e6); // NOLINT
+}
+
+// Runs the compiler and reads its resource usage from wait4(); that covers the driver and the cc1plus it waits for
+[[nodiscard]] Compile compile(const Options& options, const std::filesystem::path& source,
+  const std::filesystem::path& object)
+{
+  std::vector<std::string> args{ options.cxx };
+  args.insert(args.end(), options.flags.begin(), options.flags.end());
+  args.insert(args.end(), { "-c", source.string(), "-o", object.string() });
+  std::vector<char*> argv;
+  argv.reserve(args.size() + 1);
+  for (auto& arg : args) { argv.push_back(arg.data()); }
+  argv.push_back(nullptr);
+
+  Compile result;
+  const auto started = std::chrono::steady_clock::now();
+  pid_t pid = 0;
+  if (posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ) != 0) { return result; }
+  int status = 0;
+  rusage usage{};
+  if (wait4(pid, &status, 0, &usage) != pid) { return result; }
+  result.wall = std::chrono::steady_clock::now() - started;
+  result.cpu = std::chrono::duration<double>{ seconds_of(usage.ru_utime) + seconds_of(usage.ru_stime) };
+#if defined(__APPLE__)
+  result.peak_rss_bytes = static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+  result.peak_rss_bytes = static_cast<std::uint64_t>(usage.ru_maxrss) * 1024; // NOLINT(readability-magic-numbers)
+#endif
+  result.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  return result;
+}
+
+[[nodiscard]] bool parse_sizes(std::string_view list, std::vector<std::size_t>& out)
+{
+  out.clear();
+  while (!list.empty()) {
+    const auto comma = list.find(',');
+    const std::string item(list.substr(0, comma));
+    char* end = nullptr;
+    const auto value = std::strtoull(item.c_str(), &end, 10); // NOLINT(readability-magic-numbers)
+    if (end == item.c_str() || *end != '\0' || value == 0) { return false; }
+    out.push_back(static_cast<std::size_t>(value));
+    list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+  }
+  return !out.empty();
+}
+
+// Takes this benchmark's flags out of argv and leaves the rest for the harness
+[[nodiscard]] Options parse(int argc, char** argv)
+{
+  Options options;
+  const std::span<char*> args(argv, static_cast<std::size_t>(argc));
+  options.harness_args.push_back(args[0]);
+  for (std::size_t idx = 1; idx < args.size(); ++idx) {
+    const std::string_view flag = args[idx];
+    const char* value = idx + 1 < args.size() ? args[idx + 1] : nullptr;
+    bool ok = value != nullptr;
+    if (ok && flag == "--cxx") {
+      options.cxx = value;
+    } else if (ok && flag == "--flag") {
+      options.flags.emplace_back(value);
+    } else if (ok && flag == "--sizes") {
+      ok = parse_sizes(value, options.sizes);
+    } else if (ok && flag == "--work-dir") {
+      options.work_dir = value;
+    } else {
+      options.harness_args.push_back(args[idx]);
+      continue;
+    }
+    if (!ok) {
+      std::fprintf(stderr,
+        "usage: %s [--cxx PATH] [--flag ARG]... [--sizes N,N,...] [--work-dir DIR] [harness flags]\n",
+        args[0]);
+      std::exit(2); // NOLINT(concurrency-mt-unsafe)
+    }
+    ++idx;
+  }
+  return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options = parse(argc, argv);
+  ev_bench::Harness harness(static_cast<int>(options.harness_args.size()), options.harness_args.data());
+  std::filesystem::create_directories(options.work_dir);
+
+  std::printf(
+    "%-10s %8s %12s %12s %14s %12s\n", "receivers", "events", "wall s", "cpu s", "peak RSS MiB", "object KiB");
+  bool failed = false;
+  for (const std::size_t receivers : options.sizes) {
+    const auto source = options.work_dir / ("topology_" + std::to_string(receivers) + ".cpp");
+    const auto object = options.work_dir / ("topology_" + std::to_string(receivers) + ".o");
+    std::ofstream(source) << generate(receivers);
+
+    std::vector<Compile> compiles;
+    const std::string name = "compile " + std::to_string(receivers) + " receivers";
+    harness.run(name, 1, [&](ev_bench::Run& run) {
+      const Compile result = compile(options, source, object);
+      if (!result.ok) {
+        run.set_items(0);
+        failed = true;
+        return;
+      }
+      run.set_elapsed(result.wall);
+      if (!run.warmup()) { compiles.push_back(result); }
+    });
+    if (compiles.empty()) {
+      std::fprintf(stderr, "error: %s did not compile %s\n", options.cxx.c_str(), source.string().c_str());
+      continue;
+    }
+
+    // Medians over the measured repetitions
+    const auto median = [&](auto field) {
+      std::vector<double> values;
+      for (const Compile& each : compiles) { values.push_back(field(each)); }
+      return ev_bench::median_of(values);
+    };
+    std::error_code error;
+    const auto object_bytes = std::filesystem::file_size(object, error);
+    std::printf("%-10zu %8zu %12.2f %12.2f %14.1f %12.1f\n",
+      receivers,
+      events_for(receivers),
+      median([](const Compile& each) { return each.wall.count() / 1e9; }), // NOLINT(readability-magic-numbers)
+      median([](const Compile& each) { return each.cpu.count(); }),
+      median([](const Compile& each) {
+        return static_cast<double>(each.peak_rss_bytes) / (1024.0 * 1024.0); // NOLINT(readability-magic-numbers)
+      }),
+      error ? 0.0 : static_cast<double>(object_bytes) / 1024.0); // NOLINT(readability-magic-numbers)
+    std::fflush(stdout);
+  }
+
+  const int status = harness.finish();
+  return failed ? 1 : status;
+}
@@ -0,0 +1,212 @@
+#include "harness.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ev_loop/ev.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Open-loop load: a generator thread sends requests through a TypedExternalEmitter on a fixed schedule and
+// never waits for the loop. A closed loop sends the next request only after a reply, which hides queueing;
+// here a slow loop makes requests pile up, and that shows in the latency.
+//
+// Each request carries the tick it was meant to be sent (its slot in the schedule) and the tick it was sent.
+// The server records completion - intended and completion - sent. When the generator falls behind, it sends
+// late requests straight away but keeps their intended ticks, so the intended latency still counts the delay.
+// That avoids coordinated omission: "actual" is what a closed-loop benchmark would report, and "intended" is
+// what a client on the schedule would see.
+//
+// Each poll strategy runs at a range of offered rates around the server's nominal capacity (one request per
+// kServiceTime). The harness's items/s is the achieved throughput, and the histograms give the latency at
+// that load.
+
+namespace {
+
+constexpr auto kServiceTime = std::chrono::nanoseconds{ 1000 };
+constexpr auto kDurationPerPoint = std::chrono::milliseconds{ 100 };
+constexpr auto kSpinBeforeSend = std::chrono::microseconds{ 50 };
+constexpr auto kDoneRetry = std::chrono::milliseconds{ 1 };
+constexpr std::size_t kHybridSpinCount = 1000;
+
+// Offered load in percent of nominal capacity; past 100% the loop saturates and its ring starts dropping
+constexpr std::array kLoadPercent{ 10, 30, 50, 70, 80, 90, 95, 100, 120 };
+
+[[nodiscard]] std::uint64_t ticks_of(std::chrono::nanoseconds duration) noexcept
+{
+  return static_cast<std::uint64_t>(
+    static_cast<double>(duration.count()) / ev_loop::detail::TickClock::ns_per_tick());
+}
+
+} // namespace
+
+// =============================================================================
+// Define event types
+// =============================================================================
+
+struct Request
+{
+  std::uint64_t intended; // TickClock ticks
+  std::uint64_t sent;
+};
+
+struct Done
+{
+};
+
+struct LoadGenerator
+{
+  using emits = ev_loop::type_list<Request, Done>;
+};
+
+// Busy for service_ticks per request, then records how long the request took end to end
+struct Server
+{
+  using receives = ev_loop::type_list<Request, Done>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::SameThread;
+
+  std::uint64_t service_ticks = 0;
+  std::uint64_t received = 0;
+  bool finished = false;
+  ev_loop::LatencyHistogram intended;
+  ev_loop::LatencyHistogram actual;
+
+  template<typename Dispatcher> void on_event(Request request, Dispatcher& /*dispatcher*/)
+  {
+    const auto until = ev_loop::detail::TickClock::now() + service_ticks;
+    while (ev_loop::detail::TickClock::now() < until) { ev_loop::detail::cpu_pause(); }
+    const auto now = ev_loop::detail::TickClock::now();
+    intended.record(now - request.intended);
+    actual.record(now - request.sent);
+    ++received;
+  }
+
+  // cppcheck-suppress functionStatic ; on_event must be member function for ev library
+  template<typename Dispatcher> void on_event(Done /*done*/, Dispatcher& /*dispatcher*/) { finished = true; }
+};
+
+// =============================================================================
+// Main
+// =============================================================================
+
+namespace {
+
+using Loop = ev_loop::SharedEventLoopPtr<Server, LoadGenerator>;
+
+// Sends count requests, one every interval_ticks, then Done until the server has seen it. Done is resent
+// because an overloaded loop may drop it with the other events that no longer fit its ring.
+void generate(Loop& loop, std::uint64_t count, std::uint64_t interval_ticks, const std::atomic<bool>& finished)
+{
+  using ev_loop::detail::TickClock;
+  auto emitter = loop.get_external_emitter<LoadGenerator>();
+  const auto spin_ticks = ticks_of(kSpinBeforeSend);
+  const auto start = TickClock::now();
+  for (std::uint64_t idx = 0; idx < count; ++idx) {
+    const auto intended = start + (idx * interval_ticks);
+    for (auto now = TickClock::now(); now < intended; now = TickClock::now()) {
+      if (intended - now > spin_ticks) {
+        std::this_thread::yield();
+      } else {
+        ev_loop::detail::cpu_pause();
+      }
+    }
+    emitter.emit(Request{ intended, TickClock::now() });
+  }
+  while (!finished.load(std::memory_order_acquire)) {
+    emitter.emit(Done{});
+    std::this_thread::sleep_for(kDoneRetry);
+  }
+}
+
+struct Latencies
+{
+  ev_loop::LatencyHistogram intended;
+  ev_loop::LatencyHistogram actual;
+  std::uint64_t sent = 0;
+  std::uint64_t received = 0;
+};
+
+[[nodiscard]] double micros(std::chrono::nanoseconds value) noexcept
+{
+  return static_cast<double>(value.count()) / 1e3; // NOLINT(readability-magic-numbers)
+}
+
+void print_latencies(const Latencies& latencies)
+{
+  const auto print_row = [](const char* label, const ev_loop::LatencyHistogram& histogram) {
+    std::printf("    %-9s p50 %9.1f us  p99 %9.1f us  p99.9 %9.1f us  max %9.1f us\n",
+      label,
+      micros(histogram.percentile(0.5)), // NOLINT(readability-magic-numbers)
+      micros(histogram.percentile(0.99)), // NOLINT(readability-magic-numbers)
+      micros(histogram.percentile(0.999)), // NOLINT(readability-magic-numbers)
+      micros(histogram.max()));
+  };
+  print_row("intended", latencies.intended);
+  print_row("actual", latencies.actual);
+  if (latencies.received < latencies.sent) {
+    std::printf("    dropped   %llu of %llu\n",
+      static_cast<unsigned long long>(latencies.sent - latencies.received), // NOLINT(google-runtime-int)
+      static_cast<unsigned long long>(latencies.sent)); // NOLINT(google-runtime-int)
+  }
+}
+
+template<template<typename> typename Strategy, typename... Args>
+void sweep(ev_bench::Harness& harness, std::string_view strategy, Args... args)
+{
+  const auto capacity = std::chrono::nanoseconds{ std::chrono::seconds{ 1 } } / kServiceTime;
+  for (const int percent : kLoadPercent) {
+    const auto rate = capacity * percent / 100; // NOLINT(readability-magic-numbers)
+    const auto count = static_cast<std::uint64_t>(rate * kDurationPerPoint / std::chrono::seconds{ 1 });
+    const auto interval = ticks_of(std::chrono::nanoseconds{ std::chrono::seconds{ 1 } } / rate);
+    const std::string name = std::string(strategy) + " offered=" + std::to_string(rate) + "/s";
+
+    Latencies latencies;
+    harness.run(name, count, [&](ev_bench::Run& run) {
+      Loop loop;
+      auto& server = loop.get<Server>();
+      server.service_ticks = ticks_of(kServiceTime);
+      std::atomic<bool> finished{ false };
+      loop.start();
+
+      run.start();
+      std::jthread generator([&] {
+        ev_bench::pin_current_thread(harness.cpu(1));
+        generate(loop, count, interval, finished);
+      });
+      Strategy{ *loop, args... }.run_while([&] { return !server.finished; });
+      run.stop();
+      finished.store(true, std::memory_order_release);
+      generator.join();
+      loop.stop();
+
+      run.set_items(server.received);
+      if (run.warmup()) { return; }
+      latencies.intended.merge(server.intended);
+      latencies.actual.merge(server.actual);
+      latencies.sent += count;
+      latencies.received += server.received;
+    });
+    print_latencies(latencies);
+  }
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(bugprone-exception-escape) - std::thread may throw but we accept that in benchmarks
+int main(int argc, char** argv)
+{
+  ev_bench::Harness harness(argc, argv);
+  std::printf("service time %lld ns per request, %lld ms per load point; items/s is the achieved rate\n\n",
+    static_cast<long long>(kServiceTime.count()), // NOLINT(google-runtime-int)
+    static_cast<long long>(kDurationPerPoint.count())); // NOLINT(google-runtime-int)
+  sweep<ev_loop::Spin>(harness, "Spin");
+  sweep<ev_loop::Yield>(harness, "Yield");
+  sweep<ev_loop::Hybrid>(harness, "Hybrid", kHybridSpinCount);
+  sweep<ev_loop::Wait>(harness, "Wait");
+  return harness.finish();
+}
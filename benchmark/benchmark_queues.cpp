@@ -0,0 +1,334 @@
+#include "harness.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ev_loop/ev.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Queue-level benchmarks of the detail queues, with no loop or dispatch around them:
+//   single    one thread pushes a batch, then pops it
+//   stream    producer threads push while the main thread pops
+//   pingpong  one event bounces between two queues and two threads (time per round trip)
+//   burst     producers fill the queue while the consumer waits, then the consumer drains it
+// Each runs per capacity, payload size and producer count. With --pin, producers go on the CPUs after the main one.
+
+namespace {
+
+constexpr std::uint64_t kSingleOps = 1U << 22U;
+constexpr std::uint64_t kStreamEvents = 1U << 20U;
+constexpr std::uint64_t kRoundTrips = 1U << 15U;
+constexpr std::uint64_t kBursts = 256;
+constexpr std::uint32_t kBatch = 32;
+constexpr int kSpinsBeforeYield = 64;
+constexpr std::size_t kDualCapacity = 4096; // DualQueue's local ring is not configurable
+constexpr std::uint64_t kDualWindow = kDualCapacity / 2; // remote events in flight, so a drain always fits the ring
+constexpr std::uint64_t kCreditBatch = 64;
+
+template<std::size_t Bytes> struct Payload
+{
+  static_assert(Bytes >= 2 * sizeof(std::uint32_t), "Payload holds at least producer and sequence");
+
+  std::uint32_t producer = 0;
+  std::uint32_t sequence = 0;
+  std::array<std::byte, Bytes - (2 * sizeof(std::uint32_t))> bytes{};
+};
+
+// Spins briefly, then yields, so oversubscribed machines still make progress
+class Backoff
+{
+public:
+  void pause() noexcept
+  {
+    if (++spins_ < kSpinsBeforeYield) {
+      ev_loop::detail::cpu_pause();
+      return;
+    }
+    spins_ = 0;
+    std::this_thread::yield();
+  }
+
+private:
+  int spins_ = 0;
+};
+
+// =============================================================================
+// Queue adapters
+// =============================================================================
+
+// push() is the owning thread's push, push_remote() the one other threads use. Unbounded queues never refuse
+// a push, so the streaming producers hold back on their own.
+
+template<std::size_t Capacity, typename P> struct Ring
+{
+  using queue_type = ev_loop::detail::RingBuffer<P, Capacity>;
+  static constexpr std::string_view name = "RingBuffer";
+  static constexpr bool threaded = false;
+  static constexpr bool multi_producer = false;
+  static constexpr bool bounded = true;
+
+  static bool push(queue_type& queue, P event) { return queue.push(std::move(event)); }
+  static P* pop(queue_type& queue) { return queue.try_pop(); }
+};
+
+template<std::size_t Capacity, typename P> struct Spsc
+{
+  using queue_type = ev_loop::detail::spsc::Queue<P, Capacity>;
+  static constexpr std::string_view name = "spsc";
+  static constexpr bool threaded = true;
+  static constexpr bool multi_producer = false;
+  static constexpr bool bounded = true;
+
+  static bool push(queue_type& queue, P event) { return queue.push(std::move(event)); }
+  static bool push_remote(queue_type& queue, P event) { return queue.push(std::move(event)); }
+  static P* pop(queue_type& queue) { return queue.try_pop(); }
+};
+
+template<std::size_t Capacity, typename P> struct Mpsc
+{
+  using queue_type = ev_loop::detail::mpsc::Queue<P, Capacity>;
+  static constexpr std::string_view name = "mpsc";
+  static constexpr bool threaded = true;
+  static constexpr bool multi_producer = true;
+  static constexpr bool bounded = true;
+
+  static bool push(queue_type& queue, P event) { return queue.push(std::move(event)); }
+  static bool push_remote(queue_type& queue, P event) { return queue.push(std::move(event)); }
+  static P* pop(queue_type& queue) { return queue.try_pop(); }
+};
+
+template<std::size_t Capacity, typename P> struct Dual
+{
+  static_assert(Capacity == kDualCapacity, "DualQueue runs with its fixed local ring capacity");
+
+  using queue_type = ev_loop::detail::DualQueue<ev_loop::detail::TaggedEvent<P>>;
+  static constexpr std::string_view name = "DualQueue";
+  static constexpr bool threaded = true;
+  static constexpr bool multi_producer = true;
+  static constexpr bool bounded = false;
+
+  static bool push(queue_type& queue, P event)
+  {
+    queue.push_local_event(std::move(event));
+    return true;
+  }
+  static bool push_remote(queue_type& queue, P event)
+  {
+    queue.push_remote_event(std::move(event));
+    return true;
+  }
+  static P* pop(queue_type& queue)
+  {
+    auto* event = queue.try_pop();
+    return event != nullptr ? &event->template get<0>() : nullptr;
+  }
+};
+
+template<typename Kind> auto pop_wait(typename Kind::queue_type& queue)
+{
+  auto* event = Kind::pop(queue);
+  for (Backoff idle; event == nullptr; event = Kind::pop(queue)) { idle.pause(); }
+  return event;
+}
+
+template<typename Kind, typename P> void push_wait(typename Kind::queue_type& queue, const P& event)
+{
+  for (Backoff full; !Kind::push_remote(queue, event);) { full.pause(); }
+}
+
+// =============================================================================
+// Scenarios
+// =============================================================================
+
+template<typename Kind, typename P> void single(ev_bench::Harness& harness, const std::string& name)
+{
+  harness.run(name, kSingleOps, [&](ev_bench::Run& run) {
+    auto queue = std::make_unique<typename Kind::queue_type>();
+    std::uint32_t sum = 0;
+    run.start();
+    for (std::uint64_t done = 0; done < kSingleOps; done += kBatch) {
+      for (std::uint32_t idx = 0; idx < kBatch; ++idx) { std::ignore = Kind::push(*queue, P{ 0, idx, {} }); }
+      for (std::uint32_t idx = 0; idx < kBatch; ++idx) {
+        if (const auto* event = Kind::pop(*queue)) { sum += event->sequence; }
+      }
+    }
+    run.stop();
+    ev_bench::do_not_optimize(sum);
+  });
+}
+
+template<typename Kind, typename P> void stream(ev_bench::Harness& harness, const std::string& name, int producers)
+{
+  const auto share = kStreamEvents / static_cast<std::uint64_t>(producers);
+  harness.run(name, share * static_cast<std::uint64_t>(producers), [&](ev_bench::Run& run) {
+    auto queue = std::make_unique<typename Kind::queue_type>();
+    std::atomic<bool> go{ false };
+    std::atomic<std::uint64_t> in_flight{ 0 }; // unbounded queues only
+    std::vector<std::jthread> threads;
+    for (int producer = 0; producer < producers; ++producer) {
+      threads.emplace_back([&, producer] {
+        ev_bench::pin_current_thread(harness.cpu(producer + 1));
+        for (Backoff idle; !go.load(std::memory_order_acquire);) { idle.pause(); }
+        for (std::uint64_t seq = 0; seq < share; ++seq) {
+          if constexpr (!Kind::bounded) {
+            for (Backoff full; in_flight.load(std::memory_order_acquire) >= kDualWindow;) { full.pause(); }
+            in_flight.fetch_add(1, std::memory_order_relaxed);
+          }
+          push_wait<Kind>(*queue, P{ static_cast<std::uint32_t>(producer), static_cast<std::uint32_t>(seq), {} });
+        }
+      });
+    }
+
+    run.start();
+    go.store(true, std::memory_order_release);
+    std::uint32_t sum = 0;
+    for (std::uint64_t received = 1; received <= share * static_cast<std::uint64_t>(producers); ++received) {
+      sum += pop_wait<Kind>(*queue)->sequence;
+      if constexpr (!Kind::bounded) {
+        if (received % kCreditBatch == 0) { in_flight.fetch_sub(kCreditBatch, std::memory_order_release); }
+      }
+    }
+    run.stop();
+    ev_bench::do_not_optimize(sum);
+  });
+}
+
+template<typename Kind, typename P> void pingpong(ev_bench::Harness& harness, const std::string& name)
+{
+  harness.run(name, kRoundTrips, [&](ev_bench::Run& run) {
+    auto there = std::make_unique<typename Kind::queue_type>();
+    auto back = std::make_unique<typename Kind::queue_type>();
+    std::jthread echo([&] {
+      ev_bench::pin_current_thread(harness.cpu(1));
+      for (std::uint64_t trip = 0; trip < kRoundTrips; ++trip) { push_wait<Kind>(*back, *pop_wait<Kind>(*there)); }
+    });
+
+    run.start();
+    for (std::uint64_t trip = 0; trip < kRoundTrips; ++trip) {
+      push_wait<Kind>(*there, P{ 0, static_cast<std::uint32_t>(trip), {} });
+      std::ignore = pop_wait<Kind>(*back);
+    }
+    run.stop();
+  });
+}
+
+// Producers fill `capacity` events between them per round; the consumer waits for all of them, then drains
+template<typename Kind, typename P, std::size_t Capacity>
+void burst(ev_bench::Harness& harness, const std::string& name, int producers)
+{
+  const auto share = Capacity / static_cast<std::size_t>(producers);
+  const auto per_round = share * static_cast<std::size_t>(producers);
+  harness.run(name, kBursts * per_round, [&](ev_bench::Run& run) {
+    auto queue = std::make_unique<typename Kind::queue_type>();
+    std::uint32_t sum = 0;
+    if constexpr (!Kind::threaded) {
+      run.start();
+      for (std::uint64_t round = 0; round < kBursts; ++round) {
+        for (std::size_t idx = 0; idx < per_round; ++idx) {
+          std::ignore = Kind::push(*queue, P{ 0, static_cast<std::uint32_t>(idx), {} });
+        }
+        for (std::size_t idx = 0; idx < per_round; ++idx) {
+          if (const auto* event = Kind::pop(*queue)) { sum += event->sequence; }
+        }
+      }
+      run.stop();
+    } else {
+      std::atomic<std::uint64_t> round{ 0 };
+      std::atomic<std::uint64_t> filled{ 0 };
+      std::vector<std::jthread> threads;
+      for (int producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&, producer] {
+          ev_bench::pin_current_thread(harness.cpu(producer + 1));
+          for (std::uint64_t next = 1; next <= kBursts; ++next) {
+            for (Backoff idle; round.load(std::memory_order_acquire) < next;) { idle.pause(); }
+            for (std::size_t idx = 0; idx < share; ++idx) {
+              push_wait<Kind>(*queue, P{ static_cast<std::uint32_t>(producer), static_cast<std::uint32_t>(idx), {} });
+            }
+            filled.fetch_add(1, std::memory_order_release);
+          }
+        });
+      }
+
+      run.start();
+      for (std::uint64_t next = 1; next <= kBursts; ++next) {
+        round.store(next, std::memory_order_release);
+        const auto expected = next * static_cast<std::uint64_t>(producers);
+        for (Backoff idle; filled.load(std::memory_order_acquire) < expected;) { idle.pause(); }
+        for (std::size_t idx = 0; idx < per_round; ++idx) { sum += pop_wait<Kind>(*queue)->sequence; }
+      }
+      run.stop();
+    }
+    ev_bench::do_not_optimize(sum);
+  });
+}
+
+// =============================================================================
+// Parameter grid
+// =============================================================================
+
+constexpr std::array kProducerCounts{ 1, 2, 4 };
+
+std::string label(std::string_view queue,
+  std::string_view scenario,
+  std::size_t capacity,
+  std::size_t bytes,
+  int producers)
+{
+  return std::string(queue) + " " + std::string(scenario) + " cap=" + std::to_string(capacity)
+         + " payload=" + std::to_string(bytes) + "B producers=" + std::to_string(producers);
+}
+
+template<template<std::size_t, typename> typename Adapter, std::size_t Capacity, std::size_t Bytes>
+void run_queue(ev_bench::Harness& harness)
+{
+  using Kind = Adapter<Capacity, Payload<Bytes>>;
+  using P = Payload<Bytes>;
+
+  single<Kind, P>(harness, label(Kind::name, "single", Capacity, Bytes, 1));
+  if constexpr (Kind::threaded) {
+    pingpong<Kind, P>(harness, label(Kind::name, "pingpong", Capacity, Bytes, 1));
+    for (const int producers : kProducerCounts) {
+      if (producers > 1 && !Kind::multi_producer) { break; }
+      stream<Kind, P>(harness, label(Kind::name, "stream", Capacity, Bytes, producers), producers);
+      burst<Kind, P, Capacity>(harness, label(Kind::name, "burst", Capacity, Bytes, producers), producers);
+    }
+  } else {
+    burst<Kind, P, Capacity>(harness, label(Kind::name, "burst", Capacity, Bytes, 1), 1);
+  }
+}
+
+template<std::size_t Capacity, std::size_t Bytes> void run_all(ev_bench::Harness& harness)
+{
+  run_queue<Ring, Capacity, Bytes>(harness);
+  run_queue<Spsc, Capacity, Bytes>(harness);
+  run_queue<Mpsc, Capacity, Bytes>(harness);
+  if constexpr (Capacity == kDualCapacity) { run_queue<Dual, Capacity, Bytes>(harness); }
+}
+
+template<std::size_t Bytes> void run_payload(ev_bench::Harness& harness)
+{
+  constexpr std::size_t small_capacity = 64;
+  run_all<small_capacity, Bytes>(harness);
+  run_all<kDualCapacity, Bytes>(harness);
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(bugprone-exception-escape) - label() may throw but we accept that in benchmarks
+int main(int argc, char** argv)
+{
+  ev_bench::Harness harness(argc, argv);
+  constexpr std::size_t small_payload = 8;
+  constexpr std::size_t line_payload = 64;
+  constexpr std::size_t large_payload = 256;
+  run_payload<small_payload>(harness);
+  run_payload<line_payload>(harness);
+  run_payload<large_payload>(harness);
+  return harness.finish();
+}
@@ -0,0 +1,193 @@
+#include "harness.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ev_loop/ev.hpp>
+#include <functional>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+// Request/reply round trips: a SameThread requester issues one request at a time and each continuation issues
+// the next, so every round trip pays the full request -> responder -> reply path. dispatcher.request<Answer>()
+// with its pooled continuations runs against an OwnThread and a SameThread responder, and against a hand-rolled
+// version built from ids and an unordered_map of std::function.
+//
+// The harness's ns/item is the mean round trip. After each benchmark the round-trip latency of its measured
+// runs is printed as percentiles.
+
+namespace {
+
+constexpr int kRoundTrips = 200'000;
+
+} // namespace
+
+// =============================================================================
+// Define event types
+// =============================================================================
+
+struct Kick
+{
+};
+
+struct Query
+{
+  ev_loop::correlation_id correlation_id;
+  std::uint64_t sent; // TickClock ticks
+};
+
+struct Answer
+{
+  ev_loop::correlation_id correlation_id;
+  std::uint64_t sent;
+};
+
+// =============================================================================
+// Benchmark 1/2: dispatcher.request<Answer>() against an OwnThread or SameThread responder
+// =============================================================================
+
+struct Requester
+{
+  using receives = ev_loop::type_list<Kick, Answer>;
+  using emits = ev_loop::type_list<Query>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::SameThread;
+
+  ev_loop::LatencyHistogram latency;
+  int completed = 0;
+
+  template<typename Dispatcher> void on_event(Kick /*event*/, Dispatcher& dispatcher) { issue(dispatcher); }
+
+  // Unmatched replies - none expected
+  template<typename Dispatcher> void on_event(Answer /*event*/, Dispatcher& /*dispatcher*/) {}
+
+  // Closed loop: each continuation issues the next request
+  template<typename Dispatcher> void issue(Dispatcher& dispatcher)
+  {
+    std::ignore = dispatcher.template request<Answer>(
+      Query{ .correlation_id = 0, .sent = ev_loop::detail::TickClock::now() }, [this, &dispatcher](Answer answer) {
+        latency.record(ev_loop::detail::TickClock::now() - answer.sent);
+        if (++completed < kRoundTrips) { issue(dispatcher); }
+      });
+  }
+};
+
+template<typename Mode> struct Responder
+{
+  using receives = ev_loop::type_list<Query>;
+  using emits = ev_loop::type_list<Answer>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = Mode;
+
+  template<typename Dispatcher> void on_event(Query query, Dispatcher& dispatcher)
+  {
+    dispatcher.reply(query, Answer{ .correlation_id = 0, .sent = query.sent });
+  }
+};
+
+// =============================================================================
+// Benchmark 3: hand-rolled correlation (IDs + hash map of std::function)
+// =============================================================================
+
+struct ManualRequester
+{
+  using receives = ev_loop::type_list<Kick, Answer>;
+  using emits = ev_loop::type_list<Query>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::SameThread;
+
+  ev_loop::LatencyHistogram latency;
+  int completed = 0;
+  ev_loop::correlation_id next_id = 1;
+  std::unordered_map<ev_loop::correlation_id, std::function<void(Answer)>> pending;
+
+  template<typename Dispatcher> void on_event(Kick /*event*/, Dispatcher& dispatcher) { issue(dispatcher); }
+
+  template<typename Dispatcher> void on_event(Answer answer, Dispatcher& /*dispatcher*/)
+  {
+    const auto found = pending.find(answer.correlation_id);
+    if (found == pending.end()) { return; }
+    auto callback = std::move(found->second);
+    pending.erase(found);
+    callback(answer);
+  }
+
+  template<typename Dispatcher> void issue(Dispatcher& dispatcher)
+  {
+    const ev_loop::correlation_id id = next_id++;
+    pending.emplace(id, [this, &dispatcher](Answer answer) {
+      latency.record(ev_loop::detail::TickClock::now() - answer.sent);
+      if (++completed < kRoundTrips) { issue(dispatcher); }
+    });
+    dispatcher.emit(Query{ .correlation_id = id, .sent = ev_loop::detail::TickClock::now() });
+  }
+};
+
+struct ManualResponder
+{
+  using receives = ev_loop::type_list<Query>;
+  using emits = ev_loop::type_list<Answer>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename Dispatcher> void on_event(Query query, Dispatcher& dispatcher)
+  {
+    dispatcher.emit(Answer{ .correlation_id = query.correlation_id, .sent = query.sent });
+  }
+};
+
+// =============================================================================
+// Main
+// =============================================================================
+
+namespace {
+
+[[nodiscard]] double micros(std::chrono::nanoseconds value) noexcept
+{
+  return static_cast<double>(value.count()) / 1e3; // NOLINT(readability-magic-numbers)
+}
+
+template<typename Requesting, typename Loop, template<typename> class Strategy>
+void round_trips(ev_bench::Harness& harness, std::string_view name)
+{
+  ev_loop::LatencyHistogram latency;
+  harness.run(name, kRoundTrips, [&](ev_bench::Run& run) {
+    Loop loop;
+    auto& requester = loop.template get<Requesting>();
+    loop.start();
+    run.start();
+    loop.emit(Kick{});
+    Strategy<Loop>{ loop }.run_while([&] { return requester.completed < kRoundTrips; });
+    run.stop();
+    loop.stop();
+    if (!run.warmup()) { latency.merge(requester.latency); }
+  });
+  if (latency.count() == 0) { return; }
+  std::printf("    round trip: p50 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us\n",
+    micros(latency.percentile(0.5)), // NOLINT(readability-magic-numbers)
+    micros(latency.percentile(0.99)), // NOLINT(readability-magic-numbers)
+    micros(latency.percentile(0.999)), // NOLINT(readability-magic-numbers)
+    micros(latency.max()));
+}
+
+using OwnThreadLoop = ev_loop::EventLoop<Requester, Responder<ev_loop::OwnThread>, ev_loop::RequestReply<>>;
+using SameThreadLoop = ev_loop::EventLoop<Requester, Responder<ev_loop::SameThread>, ev_loop::RequestReply<>>;
+using ManualLoop = ev_loop::EventLoop<ManualRequester, ManualResponder>;
+
+} // namespace
+
+// NOLINTNEXTLINE(bugprone-exception-escape) - std::thread may throw but we accept that in benchmarks
+int main(int argc, char** argv)
+{
+  ev_bench::Harness harness(argc, argv);
+
+  round_trips<Requester, OwnThreadLoop, ev_loop::Spin>(harness, "request -> OwnThread, Spin");
+  round_trips<Requester, OwnThreadLoop, ev_loop::Yield>(harness, "request -> OwnThread, Yield");
+  round_trips<Requester, OwnThreadLoop, ev_loop::Wait>(harness, "request -> OwnThread, Wait");
+  round_trips<Requester, SameThreadLoop, ev_loop::Spin>(harness, "request -> SameThread, Spin");
+  round_trips<ManualRequester, ManualLoop, ev_loop::Spin>(harness, "ids + unordered_map -> OwnThread, Spin");
+  round_trips<ManualRequester, ManualLoop, ev_loop::Wait>(harness, "ids + unordered_map -> OwnThread, Wait");
+
+  return harness.finish();
+}
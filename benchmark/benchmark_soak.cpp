@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ev_loop/ev.hpp>
+#include <fstream>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Soak: runs a mixed topology for --duration seconds and appends one CSV row per --interval. A row has RSS,
+// heap allocations, the depth and high-water mark of every queue, and queue-wait/handler percentiles of the
+// interval. Short benchmarks never show slow leaks (such as the remote std::queue of DualQueue growing while
+// the loop falls behind) or latency that creeps up over hours.
+//
+//   Feed (external thread)     --Quote-->   Router (SameThread) --Update--> Book (SameThread) --Summary--> Publisher
+//   Control (external thread)  --Command-->   |                                                             (OwnThread)
+//                                             +--Audit--> Journal (OwnThread)
+//
+// Feed sends --rate quotes per second in 1 ms slices; Control sends a burst of commands every 10 ms.
+//
+// Command line:
+//   --duration SECONDS   how long to run (default 60)
+//   --interval SECONDS   time between samples (default 1)
+//   --rate N             quotes per second (default 200000)
+//   --csv PATH           where the samples go (default soak.csv)
+//
+// Percentiles are over the interval only (the difference of two cumulative DispatchLatency snapshots), so drift
+// shows up as a trend down the column instead of being averaged away.
+
+// =============================================================================
+// Allocation counting - replaces the global operator new/delete of this program
+// =============================================================================
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{ 0 }; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<std::uint64_t> g_deallocations{ 0 }; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+void* counted_alloc(std::size_t size, std::size_t alignment)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  size = std::max<std::size_t>(size, 1);
+  void* ptr = alignment <= alignof(std::max_align_t)
+                ? std::malloc(size) // NOLINT(cppcoreguidelines-no-malloc)
+                : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+  if (ptr == nullptr) { throw std::bad_alloc{}; }
+  return ptr;
+}
+
+void counted_free(void* ptr) noexcept
+{
+  if (ptr == nullptr) { return; }
+  g_deallocations.fetch_add(1, std::memory_order_relaxed);
+  std::free(ptr); // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+} // namespace
+
+// NOLINTBEGIN(misc-new-delete-overloads,cert-dcl54-cpp,hicpp-new-delete-operators)
+void* operator new(std::size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  return counted_alloc(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+  return counted_alloc(size, static_cast<std::size_t>(align));
+}
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::size_t /*size*/) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t /*align*/) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t /*align*/) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::size_t /*size*/, std::align_val_t /*align*/) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t /*size*/, std::align_val_t /*align*/) noexcept { counted_free(ptr); }
+// NOLINTEND(misc-new-delete-overloads,cert-dcl54-cpp,hicpp-new-delete-operators)
+
+// =============================================================================
+// Define event types
+// =============================================================================
+
+struct Quote
+{
+  std::uint32_t instrument;
+  std::int64_t price;
+};
+
+struct Command
+{
+  std::uint32_t instrument;
+  bool halt;
+};
+
+struct Update
+{
+  std::uint32_t instrument;
+  std::int64_t price;
+};
+
+struct Audit
+{
+  std::uint32_t instrument;
+  std::uint64_t seq;
+};
+
+struct Summary
+{
+  std::uint64_t updates;
+  std::int64_t last_price;
+};
+
+struct Feed
+{
+  using emits = ev_loop::type_list<Quote>;
+};
+
+struct Control
+{
+  using emits = ev_loop::type_list<Command>;
+};
+
+namespace {
+
+constexpr std::uint32_t kInstruments = 256;
+constexpr std::uint64_t kAuditEvery = 16;
+constexpr std::uint64_t kSummaryEvery = 64;
+constexpr std::size_t kCommandBurst = 32;
+constexpr auto kFeedSlice = std::chrono::milliseconds{ 1 };
+constexpr auto kControlPeriod = std::chrono::milliseconds{ 10 };
+constexpr std::size_t kHybridSpinCount = 1000;
+
+} // namespace
+
+struct Router
+{
+  using receives = ev_loop::type_list<Quote, Command>;
+  using emits = ev_loop::type_list<Update, Audit>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::SameThread;
+
+  std::array<bool, kInstruments> halted{};
+  std::uint64_t seq = 0;
+
+  template<typename Dispatcher> void on_event(Quote quote, Dispatcher& dispatcher)
+  {
+    if (halted[quote.instrument % kInstruments]) { return; }
+    dispatcher.emit(Update{ quote.instrument, quote.price });
+    if (++seq % kAuditEvery == 0) { dispatcher.emit(Audit{ quote.instrument, seq }); }
+  }
+
+  template<typename Dispatcher> void on_event(Command command, Dispatcher& dispatcher)
+  {
+    halted[command.instrument % kInstruments] = command.halt;
+    dispatcher.emit(Audit{ command.instrument, seq });
+  }
+};
+
+// Last price per instrument; the map stops allocating once every instrument has been seen
+struct Book
+{
+  using receives = ev_loop::type_list<Update>;
+  using emits = ev_loop::type_list<Summary>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::SameThread;
+
+  std::unordered_map<std::uint32_t, std::int64_t> prices;
+  std::uint64_t updates = 0;
+
+  template<typename Dispatcher> void on_event(Update update, Dispatcher& dispatcher)
+  {
+    prices[update.instrument] = update.price;
+    if (++updates % kSummaryEvery == 0) { dispatcher.emit(Summary{ updates, update.price }); }
+  }
+};
+
+struct Journal
+{
+  using receives = ev_loop::type_list<Audit>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::OwnThread;
+
+  std::uint64_t checksum = 0;
+
+  template<typename Dispatcher> void on_event(Audit audit, Dispatcher& /*dispatcher*/)
+  {
+    checksum ^= (audit.seq * 0x9E3779B97F4A7C15ULL) + audit.instrument; // NOLINT(readability-magic-numbers)
+  }
+};
+
+struct Publisher
+{
+  using receives = ev_loop::type_list<Summary>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = ev_loop::OwnThread;
+
+  std::int64_t last_price = 0;
+
+  template<typename Dispatcher> void on_event(Summary summary, Dispatcher& /*dispatcher*/)
+  {
+    last_price = summary.last_price;
+  }
+};
+
+// =============================================================================
+// Sampling
+// =============================================================================
+
+namespace {
+
+using Loop = ev_loop::SharedEventLoopPtr<Router,
+  Book,
+  Journal,
+  Publisher,
+  Feed,
+  Control,
+  ev_loop::Metrics,
+  ev_loop::DispatchLatency>;
+
+struct Settings
+{
+  std::chrono::duration<double> duration{ 60.0 }; // NOLINT(readability-magic-numbers)
+  std::chrono::duration<double> interval{ 1.0 };
+  std::uint64_t rate = 200'000; // NOLINT(readability-magic-numbers)
+  std::string csv = "soak.csv";
+};
+
+[[nodiscard]] std::uint64_t resident_bytes()
+{
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  std::uint64_t size = 0;
+  std::uint64_t resident = 0;
+  if (!(statm >> size >> resident)) { return 0; }
+  return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+// Percentile of the samples recorded between two cumulative snapshots of the same histogram, in ns
+[[nodiscard]] std::uint64_t interval_percentile(
+  const ev_loop::LatencyHistogram& before, const ev_loop::LatencyHistogram& after, double fraction)
+{
+  const std::uint64_t total = after.count() - before.count();
+  if (total == 0) { return 0; }
+  const auto wanted =
+    std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * static_cast<double>(total)));
+  std::uint64_t seen = 0;
+  std::size_t bucket = 0;
+  for (; bucket + 1 < ev_loop::LatencyHistogram::bucket_count; ++bucket) {
+    seen += after.count_in_bucket(bucket) - before.count_in_bucket(bucket);
+    if (seen >= wanted) { break; }
+  }
+  return static_cast<std::uint64_t>(static_cast<double>(ev_loop::LatencyHistogram::bucket_upper(bucket))
+                                    * ev_loop::detail::TickClock::ns_per_tick());
+}
+
+class Sampler
+{
+public:
+  Sampler(Loop& loop, const std::string& path) : loop_(loop), out_(path), started_(std::chrono::steady_clock::now())
+  {
+    previous_ = loop_->latency().merged();
+  }
+
+  [[nodiscard]] bool ok() const { return static_cast<bool>(out_); }
+
+  void sample()
+  {
+    const auto metrics = loop_->metrics().snapshot();
+    const auto latency = loop_->latency().merged();
+    const auto rss = resident_bytes();
+    const auto allocations = g_allocations.load(std::memory_order_relaxed);
+    const auto deallocations = g_deallocations.load(std::memory_order_relaxed);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started_;
+    if (!header_written_) { write_header(metrics); }
+
+    const auto wait_p50 = interval_percentile(previous_.queue_wait, latency.queue_wait, 0.5);
+    const auto wait_p99 = interval_percentile(previous_.queue_wait, latency.queue_wait, 0.99);
+    const auto wait_p999 = interval_percentile(previous_.queue_wait, latency.queue_wait, 0.999);
+    const auto handler_p99 = interval_percentile(previous_.handler, latency.handler, 0.99);
+    const auto dispatched = latency.handler.count() - previous_.handler.count();
+
+    out_ << elapsed.count() << ',' << rss << ',' << allocations << ',' << deallocations << ','
+         << (allocations - deallocations) << ',' << dispatched << ',' << wait_p50 << ',' << wait_p99 << ','
+         << wait_p999 << ',' << handler_p99;
+    std::uint64_t deepest = 0;
+    for (const auto& queue : metrics.queues) {
+      out_ << ',' << queue.depth << ',' << queue.high_water << ',' << queue.dropped;
+      deepest = std::max(deepest, queue.high_water);
+    }
+    out_ << '\n' << std::flush;
+
+    std::printf("%8.1f s  rss %8.1f MiB  live allocs %8llu  dispatched %9llu  wait p99 %8.1f us  high water %6llu\n",
+      elapsed.count(),
+      static_cast<double>(rss) / (1024.0 * 1024.0), // NOLINT(readability-magic-numbers)
+      static_cast<unsigned long long>(allocations - deallocations), // NOLINT(google-runtime-int)
+      static_cast<unsigned long long>(dispatched), // NOLINT(google-runtime-int)
+      static_cast<double>(wait_p99) / 1e3, // NOLINT(readability-magic-numbers)
+      static_cast<unsigned long long>(deepest)); // NOLINT(google-runtime-int)
+    std::fflush(stdout);
+
+    if (rows_ == 0) {
+      first_ = { .rss = rss, .live = allocations - deallocations, .wait_p99 = wait_p99 };
+    }
+    last_ = { .rss = rss, .live = allocations - deallocations, .wait_p99 = wait_p99 };
+    ++rows_;
+    previous_ = latency;
+  }
+
+  // First sample against last, which is where a leak or creep shows
+  void summary() const
+  {
+    if (rows_ < 2) { return; }
+    const auto delta = [](std::uint64_t from, std::uint64_t to) {
+      return static_cast<double>(to) - static_cast<double>(from);
+    };
+    std::printf("\ndrift over %zu samples: rss %+.1f MiB, live allocations %+.0f, queue-wait p99 %+.1f us\n",
+      rows_,
+      delta(first_.rss, last_.rss) / (1024.0 * 1024.0), // NOLINT(readability-magic-numbers)
+      delta(first_.live, last_.live),
+      delta(first_.wait_p99, last_.wait_p99) / 1e3); // NOLINT(readability-magic-numbers)
+  }
+
+private:
+  struct Point
+  {
+    std::uint64_t rss = 0;
+    std::uint64_t live = 0;
+    std::uint64_t wait_p99 = 0;
+  };
+
+  void write_header(const ev_loop::MetricsSnapshot& metrics)
+  {
+    out_ << "elapsed_s,rss_bytes,allocations,deallocations,live_allocations,dispatched,"
+            "queue_wait_p50_ns,queue_wait_p99_ns,queue_wait_p999_ns,handler_p99_ns";
+    for (const auto& queue : metrics.queues) {
+      out_ << ',' << queue.name << "_depth," << queue.name << "_high_water," << queue.name << "_dropped";
+    }
+    out_ << '\n';
+    header_written_ = true;
+  }
+
+  Loop& loop_;
+  std::ofstream out_;
+  std::chrono::steady_clock::time_point started_;
+  ev_loop::ReceiverLatency previous_;
+  bool header_written_ = false;
+  std::size_t rows_ = 0;
+  Point first_;
+  Point last_;
+};
+
+// =============================================================================
+// Producers
+// =============================================================================
+
+void feed(Loop& loop, std::uint64_t rate, const std::atomic<bool>& running)
+{
+  auto emitter = loop.get_external_emitter<Feed>();
+  const std::uint64_t per_slice = std::max<std::uint64_t>(1, rate * kFeedSlice.count() / 1000);
+  std::uint64_t seq = 0;
+  auto next = std::chrono::steady_clock::now();
+  while (running.load(std::memory_order_acquire)) {
+    for (std::uint64_t idx = 0; idx < per_slice; ++idx, ++seq) {
+      emitter.emit(Quote{ static_cast<std::uint32_t>(seq % kInstruments), static_cast<std::int64_t>(seq) });
+    }
+    next += kFeedSlice;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+void control(Loop& loop, const std::atomic<bool>& running)
+{
+  auto emitter = loop.get_external_emitter<Control>();
+  std::uint32_t instrument = 0;
+  auto next = std::chrono::steady_clock::now();
+  while (running.load(std::memory_order_acquire)) {
+    for (std::size_t idx = 0; idx < kCommandBurst; ++idx, ++instrument) {
+      emitter.emit(Command{ instrument % kInstruments, false });
+    }
+    next += kControlPeriod;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+[[noreturn]] void usage(const char* program)
+{
+  std::fprintf(stderr, "usage: %s [--duration SECONDS] [--interval SECONDS] [--rate N] [--csv PATH]\n", program);
+  std::exit(2); // NOLINT(concurrency-mt-unsafe)
+}
+
+[[nodiscard]] Settings parse(int argc, char** argv)
+{
+  Settings settings;
+  const std::span<char*> args(argv, static_cast<std::size_t>(argc));
+  const auto seconds = [](const char* value) {
+    char* end = nullptr;
+    const double parsed = std::strtod(value, &end);
+    return end != value && *end == '\0' && parsed > 0.0 ? parsed : -1.0;
+  };
+  for (std::size_t idx = 1; idx < args.size(); ++idx) {
+    const std::string_view flag = args[idx];
+    const char* value = idx + 1 < args.size() ? args[idx + 1] : nullptr;
+    if (value == nullptr) { usage(args[0]); }
+    if (flag == "--duration" && seconds(value) > 0.0) {
+      settings.duration = std::chrono::duration<double>{ seconds(value) };
+    } else if (flag == "--interval" && seconds(value) > 0.0) {
+      settings.interval = std::chrono::duration<double>{ seconds(value) };
+    } else if (flag == "--rate" && seconds(value) >= 1.0) {
+      settings.rate = static_cast<std::uint64_t>(seconds(value));
+    } else if (flag == "--csv") {
+      settings.csv = value;
+    } else {
+      usage(args[0]);
+    }
+    ++idx;
+  }
+  return settings;
+}
+
+} // namespace
+
+// =============================================================================
+// Main
+// =============================================================================
+
+// NOLINTNEXTLINE(bugprone-exception-escape) - std::thread may throw but we accept that in benchmarks
+int main(int argc, char** argv)
+{
+  const Settings settings = parse(argc, argv);
+  Loop loop;
+  Sampler sampler(loop, settings.csv);
+  if (!sampler.ok()) {
+    std::fprintf(stderr, "error: could not open %s\n", settings.csv.c_str());
+    return 1;
+  }
+  std::printf("soak for %.0f s at %llu quotes/s, sampling every %.1f s into %s\n\n",
+    settings.duration.count(),
+    static_cast<unsigned long long>(settings.rate), // NOLINT(google-runtime-int)
+    settings.interval.count(),
+    settings.csv.c_str());
+
+  std::atomic<bool> running{ true };
+  loop.start();
+  {
+    std::jthread feeder([&] { feed(loop, settings.rate, running); });
+    std::jthread controller([&] { control(loop, running); });
+    std::jthread sampling([&] {
+      const auto started = std::chrono::steady_clock::now();
+      const auto until = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(settings.duration);
+      const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(settings.interval);
+      for (auto next = started + step; next <= until; next += step) {
+        std::this_thread::sleep_until(next);
+        sampler.sample();
+      }
+      running.store(false, std::memory_order_release);
+      loop.stop(); // wakes the loop thread if it is parked
+    });
+    ev_loop::Hybrid{ *loop, kHybridSpinCount }.run();
+  }
+  sampler.summary();
+  return 0;
+}
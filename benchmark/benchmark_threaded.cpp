@@ -1,20 +1,12 @@
+#include "harness.hpp"
+
 #include <atomic>
-#include <chrono>
+#include <cstdint>
 #include <ev_loop/ev.hpp>
 #include <print>
+#include <string_view>
 #include <thread>
 
-namespace {
-
-template<typename Count, typename Duration> auto events_per_second(Count event_count, Duration elapsed) -> long long
-{
-  using seconds_double = std::chrono::duration<double>;
-  const auto seconds = std::chrono::duration_cast<seconds_double>(elapsed).count();
-  return static_cast<long long>(static_cast<double>(event_count) / seconds);
-}
-
-} // namespace
-
 // =============================================================================
 // Define event types
 // =============================================================================
@@ -146,155 +138,138 @@ struct D_OwnThread_Starter
 // =============================================================================
 
 namespace {
+
 constexpr int kOwnThreadTargetCount = 10'000'000;
 constexpr int kMixedTargetCount = 1'000'000;
-} // namespace
 
-void benchmark_ownthread_to_ownthread()
+// Bounces events between C and D until counter reaches kOwnThreadTargetCount; returns the events handled
+template<typename Loop> std::uint64_t ping_pong(Loop& loop, ev_bench::Run& run)
 {
-  std::println("=== Benchmark 1: OwnThread C <-> OwnThread D ===");
-
-  ev_loop::EventLoop<C_OwnThread, D_OwnThread> loop;
-
   std::atomic<int> counter{ 0 };
-  loop.get<C_OwnThread>().counter = &counter;
-  loop.get<D_OwnThread>().counter = &counter;
+  loop.template get<C_OwnThread>().counter = &counter;
+  loop.template get<D_OwnThread>().counter = &counter;
 
   loop.start();
-
-  using namespace std::chrono;
-
+  run.start();
   loop.emit(Ping{ 0 });
 
-  const auto started = steady_clock::now();
-
   while (counter.load(std::memory_order_relaxed) < kOwnThreadTargetCount) { std::this_thread::yield(); }
 
-  const auto elapsed = steady_clock::now() - started;
-
+  run.stop();
   loop.stop();
-
-  const auto final_count = counter.load();
-  std::println("  Events:     {}", final_count);
-  std::println("  Time:       {} us", duration_cast<microseconds>(elapsed).count());
-  std::println("  Throughput: {} events/sec\n", events_per_second(final_count, elapsed));
+  return static_cast<std::uint64_t>(counter.load());
 }
 
-void benchmark_samethread_to_ownthread()
+void benchmark_ownthread_to_ownthread(ev_bench::Harness& harness)
 {
-  std::println("=== Benchmark 2: SameThread A -> OwnThread D -> A ===");
-
-  using Loop = ev_loop::EventLoop<A_SameThread, D_OwnThread_ForMixed>;
-  using namespace std::chrono;
-
-  // Test with Spin strategy
-  {
-    Loop loop;
-    loop.start();
-    loop.emit(Ping{ 0 });
-    const auto started = steady_clock::now();
-
-    ev_loop::Spin{ loop }.run_while([&] { return loop.get<A_SameThread>().counter < kMixedTargetCount; });
-
-    const auto elapsed = steady_clock::now() - started;
-    loop.stop();
-    const auto total = loop.get<A_SameThread>().counter + loop.get<D_OwnThread_ForMixed>().counter.load();
-    std::println("  Spin:   {} events/sec", events_per_second(total, elapsed));
-  }
-
-  // Test with Yield strategy
-  {
-    Loop loop;
-    loop.start();
-    loop.emit(Ping{ 0 });
-    const auto started = steady_clock::now();
-
-    ev_loop::Yield{ loop }.run_while([&] { return loop.get<A_SameThread>().counter < kMixedTargetCount; });
+  std::println("=== Benchmark 1: OwnThread C <-> OwnThread D ===");
 
-    const auto elapsed = steady_clock::now() - started;
-    loop.stop();
-    const auto total = loop.get<A_SameThread>().counter + loop.get<D_OwnThread_ForMixed>().counter.load();
-    std::println("  Yield:  {} events/sec", events_per_second(total, elapsed));
+  constexpr std::string_view name = "OwnThread C <-> OwnThread D";
+  harness.run(name, kOwnThreadTargetCount, [&](ev_bench::Run& run) {
+    ev_loop::EventLoop<C_OwnThread, D_OwnThread> loop;
+    run.set_items(ping_pong(loop, run));
+  });
+
+  // --perf: PerfCounters makes the loop observed, so the counters come from a separate, untimed loop
+  if (harness.perf_pass(name)) {
+    ev_loop::EventLoop<C_OwnThread, D_OwnThread, ev_loop::PerfCounters> loop;
+    ev_bench::Run untimed;
+    const std::uint64_t events = ping_pong(loop, untimed);
+    // Hardware counters per event of every loop thread, or n/a where perf_event_open is not permitted
+    std::print("{}", loop.perf_counters().snapshot().table(events));
   }
+  std::println("");
+}
 
-  // Test with Wait strategy
-  {
-    Loop loop;
-    loop.start();
-    loop.emit(Ping{ 0 });
-    const auto started = steady_clock::now();
+// Bounces events between a SameThread and an OwnThread receiver under one poll strategy until Counted::count
+// reaches kMixedTargetCount; First is the event that starts the exchange. Returns the events handled.
+template<template<typename> typename Strategy, typename Counted, typename First, typename Loop>
+std::uint64_t bounce(Loop& loop, ev_bench::Run& run)
+{
+  loop.start();
+  run.start();
+  loop.emit(First{ 0 });
 
-    ev_loop::Wait{ loop }.run_while([&] { return loop.get<A_SameThread>().counter < kMixedTargetCount; });
+  Strategy{ loop }.run_while([&] { return Counted::count(loop) < kMixedTargetCount; });
 
-    const auto elapsed = steady_clock::now() - started;
-    loop.stop();
-    const auto total = loop.get<A_SameThread>().counter + loop.get<D_OwnThread_ForMixed>().counter.load();
-    std::println("  Wait:   {} events/sec\n", events_per_second(total, elapsed));
-  }
+  run.stop();
+  loop.stop();
+  return static_cast<std::uint64_t>(Counted::total(loop));
 }
 
-void benchmark_ownthread_to_samethread()
+template<template<typename> typename Strategy,
+  template<typename...> typename Loop,
+  typename Counted,
+  typename First>
+void benchmark_mixed(ev_bench::Harness& harness, std::string_view name)
 {
-  std::println("=== Benchmark 3: OwnThread D -> SameThread A -> D ===");
+  harness.run(name, kMixedTargetCount, [&](ev_bench::Run& run) {
+    Loop<> loop;
+    run.set_items(bounce<Strategy, Counted, First>(loop, run));
+  });
+
+  if (harness.perf_pass(name)) {
+    Loop<ev_loop::PerfCounters> loop;
+    ev_bench::Run untimed;
+    const std::uint64_t events = bounce<Strategy, Counted, First>(loop, untimed);
+    std::print("{}", loop.perf_counters().snapshot().table(events));
+  }
+}
 
-  using Loop = ev_loop::EventLoop<A_SameThread_Relay, D_OwnThread_Starter>;
-  using namespace std::chrono;
+// Options... is empty for the timed runs and PerfCounters for the --perf pass
+template<typename... Options>
+using SameToOwnLoop = ev_loop::EventLoop<A_SameThread, D_OwnThread_ForMixed, Options...>;
+template<typename... Options>
+using OwnToSameLoop = ev_loop::EventLoop<A_SameThread_Relay, D_OwnThread_Starter, Options...>;
 
-  // Test with Spin strategy
+struct SameToOwnCount
+{
+  template<typename Loop> static int count(Loop& loop) { return loop.template get<A_SameThread>().counter; }
+  template<typename Loop> static int total(Loop& loop)
   {
-    Loop loop;
-    loop.start();
-    loop.emit(Pong{ 0 });
-    const auto started = steady_clock::now();
-
-    ev_loop::Spin{ loop }.run_while(
-      [&] { return loop.get<D_OwnThread_Starter>().counter.load(std::memory_order_relaxed) < kMixedTargetCount; });
-
-    const auto elapsed = steady_clock::now() - started;
-    loop.stop();
-    const auto total = loop.get<A_SameThread_Relay>().counter + loop.get<D_OwnThread_Starter>().counter.load();
-    std::println("  Spin:   {} events/sec", events_per_second(total, elapsed));
+    return loop.template get<A_SameThread>().counter + loop.template get<D_OwnThread_ForMixed>().counter.load();
   }
+};
 
-  // Test with Yield strategy
+struct OwnToSameCount
+{
+  template<typename Loop> static int count(Loop& loop)
   {
-    Loop loop;
-    loop.start();
-    loop.emit(Pong{ 0 });
-    const auto started = steady_clock::now();
-
-    ev_loop::Yield{ loop }.run_while(
-      [&] { return loop.get<D_OwnThread_Starter>().counter.load(std::memory_order_relaxed) < kMixedTargetCount; });
-
-    const auto elapsed = steady_clock::now() - started;
-    loop.stop();
-    const auto total = loop.get<A_SameThread_Relay>().counter + loop.get<D_OwnThread_Starter>().counter.load();
-    std::println("  Yield:  {} events/sec", events_per_second(total, elapsed));
+    return loop.template get<D_OwnThread_Starter>().counter.load(std::memory_order_relaxed);
   }
-
-  // Test with Wait strategy
+  template<typename Loop> static int total(Loop& loop)
   {
-    Loop loop;
-    loop.start();
-    loop.emit(Pong{ 0 });
-    const auto started = steady_clock::now();
-
-    ev_loop::Wait{ loop }.run_while(
-      [&] { return loop.get<D_OwnThread_Starter>().counter.load(std::memory_order_relaxed) < kMixedTargetCount; });
-
-    const auto elapsed = steady_clock::now() - started;
-    loop.stop();
-    const auto total = loop.get<A_SameThread_Relay>().counter + loop.get<D_OwnThread_Starter>().counter.load();
-    std::println("  Wait:   {} events/sec\n", events_per_second(total, elapsed));
+    return loop.template get<A_SameThread_Relay>().counter + loop.template get<D_OwnThread_Starter>().counter.load();
   }
+};
+
+void benchmark_samethread_to_ownthread(ev_bench::Harness& harness)
+{
+  std::println("=== Benchmark 2: SameThread A -> OwnThread D -> A ===");
+  benchmark_mixed<ev_loop::Spin, SameToOwnLoop, SameToOwnCount, Ping>(harness, "SameThread -> OwnThread Spin");
+  benchmark_mixed<ev_loop::Yield, SameToOwnLoop, SameToOwnCount, Ping>(harness, "SameThread -> OwnThread Yield");
+  benchmark_mixed<ev_loop::Wait, SameToOwnLoop, SameToOwnCount, Ping>(harness, "SameThread -> OwnThread Wait");
+  std::println("");
 }
 
+void benchmark_ownthread_to_samethread(ev_bench::Harness& harness)
+{
+  std::println("=== Benchmark 3: OwnThread D -> SameThread A -> D ===");
+  benchmark_mixed<ev_loop::Spin, OwnToSameLoop, OwnToSameCount, Pong>(harness, "OwnThread -> SameThread Spin");
+  benchmark_mixed<ev_loop::Yield, OwnToSameLoop, OwnToSameCount, Pong>(harness, "OwnThread -> SameThread Yield");
+  benchmark_mixed<ev_loop::Wait, OwnToSameLoop, OwnToSameCount, Pong>(harness, "OwnThread -> SameThread Wait");
+  std::println("");
+}
+
+} // namespace
+
 // NOLINTNEXTLINE(bugprone-exception-escape) - std::println may throw but we accept that in benchmarks
-int main()
+int main(int argc, char** argv)
 {
+  ev_bench::Harness harness(argc, argv);
   std::println("");
-  benchmark_ownthread_to_ownthread();
-  benchmark_samethread_to_ownthread();
-  benchmark_ownthread_to_samethread();
-  return 0;
+  benchmark_ownthread_to_ownthread(harness);
+  benchmark_samethread_to_ownthread(harness);
+  benchmark_ownthread_to_samethread(harness);
+  return harness.finish();
 }
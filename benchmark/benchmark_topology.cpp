@@ -0,0 +1,351 @@
+#include "harness.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ev_loop/ev.hpp>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Topology zoo: compile-time generated receiver graphs, larger than the two-node ping-pongs elsewhere.
+//   chain    N stages, each SameThread or OwnThread, passing one event down the line
+//   fan-out  one event delivered to K receivers (fanout_copy_n / push_copy_n)
+//   fan-in   M external producer threads feeding one receiver; an OwnThread one gets an mpsc inbox
+//   diamond  one event split to two branches whose halves meet again at a join
+// The main thread injects root events, keeping at most kWindow of them in flight so no ring overflows,
+// and polls the loop with Spin. Each completion records root-emit-to-completion latency. The harness
+// reports root events per second, followed by p50/p99 latency.
+
+namespace {
+
+constexpr std::uint64_t kEvents = 200'000;
+constexpr std::uint64_t kWindow = 256;
+constexpr std::size_t kMaxProducers = 8;
+
+using ev_loop::OwnThread;
+using ev_loop::SameThread;
+using ev_loop::detail::TickClock;
+
+// Where an event finishes: counts completions and records their latency. Only the receiver's own thread writes.
+struct Sink
+{
+  ev_loop::LatencyHistogram latency;
+  std::atomic<std::uint64_t> completed{ 0 };
+
+  void complete(std::uint64_t sent) noexcept
+  {
+    latency.record(TickClock::now() - sent);
+    completed.fetch_add(1, std::memory_order_release);
+  }
+};
+
+} // namespace
+
+// =============================================================================
+// Chain: Hop<0> -> Stage 0 -> Hop<1> -> ... -> Stage N-1
+// =============================================================================
+
+template<std::size_t I> struct Hop
+{
+  std::uint64_t sent; // TickClock ticks at root emit
+};
+
+template<std::size_t I, std::size_t N, typename Mode> struct ChainStage : Sink
+{
+  using receives = ev_loop::type_list<Hop<I>>;
+  using emits = std::conditional_t<(I + 1 < N), ev_loop::type_list<Hop<I + 1>>, ev_loop::type_list<>>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = Mode;
+
+  template<typename Dispatcher> void on_event(Hop<I> hop, Dispatcher& dispatcher)
+  {
+    if constexpr (I + 1 < N) {
+      dispatcher.emit(Hop<I + 1>{ hop.sent });
+    } else {
+      complete(hop.sent);
+    }
+  }
+};
+
+template<typename... Modes> struct Chain
+{
+  static constexpr std::size_t stages = sizeof...(Modes);
+
+  template<std::size_t... Is>
+  static auto make(std::index_sequence<Is...> /*unused*/)
+    -> ev_loop::SharedEventLoopPtr<ChainStage<Is, stages, Modes>...>;
+
+  using loop_type = decltype(make(std::index_sequence_for<Modes...>{}));
+  using sinks = ev_loop::type_list<
+    ChainStage<stages - 1, stages, ev_loop::detail::type_list_at_t<stages - 1, ev_loop::type_list<Modes...>>>>;
+  static constexpr std::uint64_t completions = 1;
+
+  static Hop<0> root(std::uint64_t /*seq*/, std::uint64_t now) noexcept { return Hop<0>{ now }; }
+};
+
+// =============================================================================
+// Fan-out: Fan -> K leaves
+// =============================================================================
+
+struct Fan
+{
+  std::uint64_t sent;
+};
+
+template<std::size_t I, typename Mode> struct Leaf : Sink
+{
+  using receives = ev_loop::type_list<Fan>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = Mode;
+
+  template<typename Dispatcher> void on_event(Fan fan, Dispatcher& /*dispatcher*/) { complete(fan.sent); }
+};
+
+template<typename... Modes> struct FanOut
+{
+  template<std::size_t... Is>
+  static auto make(std::index_sequence<Is...> /*unused*/) -> ev_loop::SharedEventLoopPtr<Leaf<Is, Modes>...>;
+  template<std::size_t... Is>
+  static auto make_sinks(std::index_sequence<Is...> /*unused*/) -> ev_loop::type_list<Leaf<Is, Modes>...>;
+
+  using loop_type = decltype(make(std::index_sequence_for<Modes...>{}));
+  using sinks = decltype(make_sinks(std::index_sequence_for<Modes...>{}));
+  static constexpr std::uint64_t completions = sizeof...(Modes);
+
+  static Fan root(std::uint64_t /*seq*/, std::uint64_t now) noexcept { return Fan{ now }; }
+};
+
+// =============================================================================
+// Diamond: Split -> Left, Right -> Half -> Join
+// =============================================================================
+
+struct Split
+{
+  std::uint64_t sent;
+  std::uint64_t seq;
+};
+
+struct Half
+{
+  std::uint64_t sent;
+  std::uint64_t seq;
+};
+
+template<std::size_t Side, typename Mode> struct Branch
+{
+  using receives = ev_loop::type_list<Split>;
+  using emits = ev_loop::type_list<Half>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = Mode;
+
+  // cppcheck-suppress functionStatic ; on_event must be member function for ev library
+  template<typename Dispatcher> void on_event(Split split, Dispatcher& dispatcher)
+  {
+    dispatcher.emit(Half{ split.sent, split.seq });
+  }
+};
+
+// Completes an event once both of its halves arrived. Both branches emit the same Half type, so an OwnThread
+// join counts two producers and gets an mpsc inbox.
+template<typename Mode> struct Join : Sink
+{
+  using receives = ev_loop::type_list<Half>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = Mode;
+
+  std::vector<std::uint8_t> arrived = std::vector<std::uint8_t>(kEvents);
+
+  template<typename Dispatcher> void on_event(Half half, Dispatcher& /*dispatcher*/)
+  {
+    if (++arrived[half.seq] == 2) { complete(half.sent); }
+  }
+};
+
+template<typename LeftMode, typename RightMode, typename JoinMode> struct Diamond
+{
+  using loop_type = ev_loop::SharedEventLoopPtr<Branch<0, LeftMode>, Branch<1, RightMode>, Join<JoinMode>>;
+  using sinks = ev_loop::type_list<Join<JoinMode>>;
+  static constexpr std::uint64_t completions = 1;
+
+  static Split root(std::uint64_t seq, std::uint64_t now) noexcept { return Split{ now, seq }; }
+};
+
+// =============================================================================
+// Fan-in: M external producers -> Collector
+// =============================================================================
+
+struct Item
+{
+  std::uint64_t sent;
+  std::size_t producer;
+};
+
+template<std::size_t I> struct Producer
+{
+  using emits = ev_loop::type_list<Item>;
+};
+
+template<typename Mode> struct Collector : Sink
+{
+  using receives = ev_loop::type_list<Item>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = Mode;
+
+  std::array<std::atomic<std::uint64_t>, kMaxProducers> per_producer{};
+
+  template<typename Dispatcher> void on_event(Item item, Dispatcher& /*dispatcher*/)
+  {
+    per_producer[item.producer].fetch_add(1, std::memory_order_release);
+    complete(item.sent);
+  }
+};
+
+template<std::size_t M, typename Mode> struct FanIn
+{
+  static_assert(M >= 1 && M <= kMaxProducers);
+
+  template<std::size_t... Is>
+  static auto make(std::index_sequence<Is...> /*unused*/)
+    -> ev_loop::SharedEventLoopPtr<Collector<Mode>, Producer<Is>...>;
+
+  using loop_type = decltype(make(std::make_index_sequence<M>{}));
+  using sinks = ev_loop::type_list<Collector<Mode>>;
+  static constexpr std::uint64_t completions = 1;
+  static constexpr std::size_t producers = M;
+};
+
+// =============================================================================
+// Drivers
+// =============================================================================
+
+namespace {
+
+template<typename Loop, typename... Sinks>
+std::uint64_t completed(Loop& loop, ev_loop::type_list<Sinks...> /*unused*/) noexcept
+{
+  return (loop.template get<Sinks>().completed.load(std::memory_order_acquire) + ...);
+}
+
+template<typename Loop, typename... Sinks>
+void merge_latency(Loop& loop, ev_loop::LatencyHistogram& into, ev_loop::type_list<Sinks...> /*unused*/) noexcept
+{
+  (into.merge(loop.template get<Sinks>().latency), ...);
+}
+
+// Root events from the loop thread, at most kWindow in flight
+template<typename Topology> void drive_from_loop(typename Topology::loop_type& loop)
+{
+  constexpr auto per_event = Topology::completions;
+  ev_loop::Spin spin{ *loop };
+  std::uint64_t sent = 0;
+  for (auto done = completed(loop, typename Topology::sinks{}); done < kEvents * per_event;
+    done = completed(loop, typename Topology::sinks{})) {
+    for (; sent < kEvents && (sent * per_event) - done < kWindow * per_event; ++sent) {
+      loop.emit(Topology::root(sent, TickClock::now()));
+    }
+    std::ignore = spin.poll();
+  }
+}
+
+// One thread per producer, each with its own share of the window
+template<typename Topology> void drive_producers(ev_bench::Harness& harness, typename Topology::loop_type& loop)
+{
+  constexpr std::size_t producers = Topology::producers;
+  constexpr std::uint64_t share = kEvents / producers;
+  constexpr std::uint64_t window = kWindow / producers;
+  auto& collector = loop.template get<ev_loop::detail::type_list_at_t<0, typename Topology::sinks>>();
+  {
+    std::vector<std::jthread> threads;
+    [&]<std::size_t... Is>(std::index_sequence<Is...> /*unused*/) {
+      (threads.emplace_back([&] {
+        ev_bench::pin_current_thread(harness.cpu(static_cast<int>(Is) + 1));
+        auto emitter = loop.template get_external_emitter<Producer<Is>>();
+        for (std::uint64_t sent = 0; sent < share; ++sent) {
+          while (sent - collector.per_producer[Is].load(std::memory_order_acquire) >= window) {
+            std::this_thread::yield();
+          }
+          emitter.emit(Item{ TickClock::now(), Is });
+        }
+      }),
+        ...);
+    }(std::make_index_sequence<producers>{});
+
+    ev_loop::Spin{ *loop }.run_while([&] {
+      return collector.completed.load(std::memory_order_acquire) < share * producers;
+    });
+  }
+}
+
+template<typename Topology> constexpr bool has_producers = requires { Topology::producers; };
+
+template<typename Topology> [[nodiscard]] constexpr std::uint64_t root_events() noexcept
+{
+  if constexpr (has_producers<Topology>) {
+    return (kEvents / Topology::producers) * Topology::producers;
+  } else {
+    return kEvents;
+  }
+}
+
+template<typename Topology> void run_topology(ev_bench::Harness& harness, std::string_view name)
+{
+  constexpr std::uint64_t roots = root_events<Topology>();
+  ev_loop::LatencyHistogram latency;
+  harness.run(name, roots, [&](ev_bench::Run& run) {
+    typename Topology::loop_type loop;
+    loop.start();
+    run.start();
+    if constexpr (has_producers<Topology>) {
+      drive_producers<Topology>(harness, loop);
+    } else {
+      drive_from_loop<Topology>(loop);
+    }
+    run.stop();
+    loop.stop();
+    if (!run.warmup()) { merge_latency(loop, latency, typename Topology::sinks{}); }
+  });
+  if (latency.count() == 0) { return; }
+  std::printf("    latency p50 %.2f us  p99 %.2f us  max %.2f us\n",
+    static_cast<double>(latency.percentile(0.5).count()) / 1e3, // NOLINT(readability-magic-numbers)
+    static_cast<double>(latency.percentile(0.99).count()) / 1e3, // NOLINT(readability-magic-numbers)
+    static_cast<double>(latency.max().count()) / 1e3); // NOLINT(readability-magic-numbers)
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(bugprone-exception-escape) - std::thread may throw but we accept that in benchmarks
+int main(int argc, char** argv)
+{
+  using S = SameThread;
+  using O = OwnThread;
+  ev_bench::Harness harness(argc, argv);
+
+  run_topology<Chain<S, S, S, S, S, S, S, S>>(harness, "chain 8 SameThread");
+  run_topology<Chain<O, O, O, O>>(harness, "chain 4 OwnThread");
+  run_topology<Chain<S, O, S, O, S, O, S, O>>(harness, "chain 8 alternating");
+  run_topology<Chain<O, S, S, S, O, S, S, S, O, S, S, S, O, S, S, S>>(harness, "chain 16 mostly SameThread");
+
+  run_topology<FanOut<S, S, S, S>>(harness, "fan-out 4 SameThread");
+  run_topology<FanOut<O, O, O, O>>(harness, "fan-out 4 OwnThread");
+  run_topology<FanOut<S, O, S, O, S, O, S, O>>(harness, "fan-out 8 mixed");
+
+  run_topology<FanIn<1, S>>(harness, "fan-in 1 producer SameThread");
+  run_topology<FanIn<2, S>>(harness, "fan-in 2 producers SameThread");
+  run_topology<FanIn<4, S>>(harness, "fan-in 4 producers SameThread");
+  run_topology<FanIn<1, O>>(harness, "fan-in 1 producer OwnThread (spsc)");
+  run_topology<FanIn<2, O>>(harness, "fan-in 2 producers OwnThread (mpsc)");
+  run_topology<FanIn<4, O>>(harness, "fan-in 4 producers OwnThread (mpsc)");
+
+  run_topology<Diamond<S, S, S>>(harness, "diamond SameThread");
+  run_topology<Diamond<O, O, S>>(harness, "diamond OwnThread branches");
+  run_topology<Diamond<O, S, O>>(harness, "diamond mixed, OwnThread join");
+  run_topology<Diamond<O, O, O>>(harness, "diamond OwnThread");
+
+  return harness.finish();
+}
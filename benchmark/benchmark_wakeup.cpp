@@ -0,0 +1,211 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ev_loop/ev.hpp>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Wakeup latency: the consumer sits idle for kIdle, long enough to park, then one event arrives. Each wakeup
+// records the time from emit to dispatch. A burst after a quiet period pays this cost, and steady-state
+// throughput benchmarks never see it.
+//
+// The loop-thread variants run a poll strategy on a consumer thread. Hybrid parks after spin_count empty polls:
+// 100 and 10'000 park well within kIdle, while 1'000'000 (several ms of polling) usually never parks, so it
+// behaves like Spin. The OwnThread variants park in spsc/mpsc pop_wait after its 1000-iteration spin; a second
+// emitter type makes the loop pick mpsc. Spin never parks and is the baseline.
+//
+// The harness's ns/item is the mean wakeup latency. Histograms are printed per variant, then compared with Spin.
+
+namespace {
+
+constexpr std::uint64_t kWakeups = 500;
+constexpr auto kIdle = std::chrono::milliseconds{ 2 };
+constexpr std::array<std::size_t, 3> kHybridSpinCounts{ 100, 10'000, 1'000'000 };
+constexpr std::size_t kBarWidth = 40;
+
+} // namespace
+
+// =============================================================================
+// Define event types
+// =============================================================================
+
+struct Wake
+{
+  std::uint64_t sent; // TickClock ticks
+};
+
+struct Waker
+{
+  using emits = ev_loop::type_list<Wake>;
+};
+
+// Never emits; declaring it gives the OwnThread inbox a second producer, so the loop uses mpsc::Queue
+struct SecondWaker
+{
+  using emits = ev_loop::type_list<Wake>;
+};
+
+template<typename Mode> struct Sleeper
+{
+  using receives = ev_loop::type_list<Wake>;
+  // cppcheck-suppress unusedStructMember
+  using thread_mode = Mode;
+
+  ev_loop::LatencyHistogram latency;
+  std::uint64_t total_ticks = 0;
+  std::atomic<std::uint64_t> received{ 0 };
+
+  template<typename Dispatcher> void on_event(Wake wake, Dispatcher& /*dispatcher*/)
+  {
+    const auto ticks = ev_loop::detail::TickClock::now() - wake.sent;
+    latency.record(ticks);
+    total_ticks += ticks;
+    received.fetch_add(1, std::memory_order_release);
+  }
+};
+
+// =============================================================================
+// Main
+// =============================================================================
+
+namespace {
+
+using LoopThreadSleeper = Sleeper<ev_loop::SameThread>;
+using OwnThreadSleeper = Sleeper<ev_loop::OwnThread>;
+using LoopThreadLoop = ev_loop::SharedEventLoopPtr<LoopThreadSleeper, Waker>;
+using SpscLoop = ev_loop::SharedEventLoopPtr<OwnThreadSleeper, Waker>;
+using MpscLoop = ev_loop::SharedEventLoopPtr<OwnThreadSleeper, Waker, SecondWaker>;
+
+static_assert(SpscLoop::loop_type::producer_count_for<OwnThreadSleeper> == 1, "spsc inbox expected");
+static_assert(MpscLoop::loop_type::producer_count_for<OwnThreadSleeper> == 2, "mpsc inbox expected");
+
+struct Variant
+{
+  std::string name;
+  ev_loop::LatencyHistogram latency;
+};
+
+[[nodiscard]] double micros(std::chrono::nanoseconds value) noexcept
+{
+  return static_cast<double>(value.count()) / 1e3; // NOLINT(readability-magic-numbers)
+}
+
+// One row per power-of-two range of nanoseconds that holds samples
+void print_histogram(const ev_loop::LatencyHistogram& histogram)
+{
+  constexpr std::size_t ranges = 64;
+  std::array<std::uint64_t, ranges> counts{};
+  const double ns_per_tick = ev_loop::detail::TickClock::ns_per_tick();
+  for (std::size_t bucket = 0; bucket < ev_loop::LatencyHistogram::bucket_count; ++bucket) {
+    const auto count = histogram.count_in_bucket(bucket);
+    if (count == 0) { continue; }
+    const auto ns =
+      static_cast<std::uint64_t>(static_cast<double>(ev_loop::LatencyHistogram::bucket_upper(bucket)) * ns_per_tick);
+    const auto width = static_cast<std::size_t>(std::numeric_limits<std::uint64_t>::digits - std::countl_zero(ns));
+    counts[std::min(width, ranges - 1)] += count;
+  }
+  const auto peak = std::ranges::max(counts);
+  std::printf("    %12s  %6s\n", "from", "count");
+  for (std::size_t range = 0; range < ranges; ++range) {
+    if (counts[range] == 0) { continue; }
+    const auto low = range == 0 ? 0 : std::uint64_t{ 1 } << (range - 1);
+    const auto bar = static_cast<int>(counts[range] * kBarWidth / peak);
+    std::printf("    %9.2f us  %6llu  %.*s\n",
+      static_cast<double>(low) / 1e3, // NOLINT(readability-magic-numbers)
+      static_cast<unsigned long long>(counts[range]), // NOLINT(google-runtime-int)
+      bar,
+      "########################################");
+  }
+}
+
+// Parks the consumer kWakeups times and wakes it with one event each. Drive runs the loop on the consumer
+// thread; for OwnThread receivers it is nullptr, since the loop starts their threads itself.
+template<typename Loop, typename Receiver, typename Drive>
+void measure(ev_bench::Harness& harness, std::string_view name, Drive drive, std::vector<Variant>& variants)
+{
+  Variant variant{ .name = std::string(name), .latency = {} };
+  harness.run(name, kWakeups, [&](ev_bench::Run& run) {
+    Loop loop;
+    auto& sleeper = loop.template get<Receiver>();
+    loop.start();
+    std::jthread consumer;
+    if constexpr (!std::is_null_pointer_v<Drive>) {
+      consumer = std::jthread([&] {
+        ev_bench::pin_current_thread(harness.cpu(1));
+        drive(*loop);
+      });
+    }
+
+    auto emitter = loop.template get_external_emitter<Waker>();
+    for (std::uint64_t idx = 0; idx < kWakeups; ++idx) {
+      std::this_thread::sleep_for(kIdle);
+      emitter.emit(Wake{ ev_loop::detail::TickClock::now() });
+      while (sleeper.received.load(std::memory_order_acquire) <= idx) { std::this_thread::yield(); }
+    }
+    loop.stop();
+
+    run.set_elapsed(std::chrono::duration<double, std::nano>{
+      static_cast<double>(sleeper.total_ticks) * ev_loop::detail::TickClock::ns_per_tick() });
+    if (!run.warmup()) { variant.latency.merge(sleeper.latency); }
+  });
+  if (variant.latency.count() == 0) { return; }
+  print_histogram(variant.latency);
+  variants.push_back(std::move(variant));
+}
+
+template<template<typename> typename Strategy, typename... Args> auto drive_with(Args... args)
+{
+  return [args...](LoopThreadLoop::loop_type& loop) { Strategy{ loop, args... }.run(); };
+}
+
+void compare_to_spin(const std::vector<Variant>& variants)
+{
+  const auto spin = std::ranges::find(variants, std::string_view{ "Spin" }, &Variant::name);
+  std::printf("\n%-28s %10s %10s %10s %10s %10s\n", "wakeup latency (us)", "p50", "p99", "p99.9", "max", "p50/Spin");
+  const auto baseline = spin != variants.end() ? spin->latency.percentile(0.5) : std::chrono::nanoseconds{ 0 };
+  for (const auto& each : variants) {
+    const auto p50 = each.latency.percentile(0.5); // NOLINT(readability-magic-numbers)
+    const double ratio =
+      baseline.count() > 0 ? static_cast<double>(p50.count()) / static_cast<double>(baseline.count()) : 0.0;
+    std::printf("%-28s %10.1f %10.1f %10.1f %10.1f %9.1fx\n",
+      each.name.c_str(),
+      micros(p50),
+      micros(each.latency.percentile(0.99)), // NOLINT(readability-magic-numbers)
+      micros(each.latency.percentile(0.999)), // NOLINT(readability-magic-numbers)
+      micros(each.latency.max()),
+      ratio);
+  }
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(bugprone-exception-escape) - std::thread may throw but we accept that in benchmarks
+int main(int argc, char** argv)
+{
+  ev_bench::Harness harness(argc, argv);
+  std::vector<Variant> variants;
+
+  measure<LoopThreadLoop, LoopThreadSleeper>(harness, "Spin", drive_with<ev_loop::Spin>(), variants);
+  for (const std::size_t spins : kHybridSpinCounts) {
+    measure<LoopThreadLoop, LoopThreadSleeper>(
+      harness, "Hybrid spins=" + std::to_string(spins), drive_with<ev_loop::Hybrid>(spins), variants);
+  }
+  measure<LoopThreadLoop, LoopThreadSleeper>(harness, "Wait", drive_with<ev_loop::Wait>(), variants);
+  measure<SpscLoop, OwnThreadSleeper>(harness, "OwnThread spsc pop_wait", nullptr, variants);
+  measure<MpscLoop, OwnThreadSleeper>(harness, "OwnThread mpsc pop_wait", nullptr, variants);
+
+  compare_to_spin(variants);
+  return harness.finish();
+}
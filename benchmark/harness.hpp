@@ -0,0 +1,464 @@
+#pragma once
+
+// Header-only benchmark harness: warmup and repetitions, median/MAD statistics, CPU pinning, JSON results
+// and a regression check against a stored baseline. No dependencies beyond the standard library.
+//
+//   int main(int argc, char** argv)
+//   {
+//     ev_bench::Harness harness(argc, argv);
+//     harness.run("spin", kEvents, [&](ev_bench::Run& run) {
+//       Loop loop;                   // setup is not timed once run.start() is called
+//       run.start();
+//       ...                          // kEvents events
+//       run.stop();
+//     });
+//     return harness.finish();
+//   }
+//
+// Command line:
+//   --repetitions N   measured runs per benchmark (default 5)
+//   --warmup N        unmeasured runs before them (default 1)
+//   --pin CPU         pin the main thread to CPU; Harness::cpu(k) hands CPU + k to helper threads
+//   --filter TEXT     only run benchmarks whose name contains TEXT
+//   --json PATH       write the results as JSON
+//   --baseline PATH   compare against a JSON file written by --json; finish() returns 1 on a regression
+//   --threshold PCT   slowdown that counts as a regression when it also exceeds the noise (default 5)
+//   --perf            after each benchmark, an untimed pass on an instrumented loop (benchmarks that offer one)
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ev_bench {
+
+// =============================================================================
+// CPU pinning and optimization barrier
+// =============================================================================
+
+// Pins the calling thread to one CPU. False when the CPU does not exist or pinning is not supported.
+inline bool pin_current_thread(std::optional<int> cpu) noexcept
+{
+#ifdef __linux__
+  if (!cpu || *cpu < 0 || *cpu >= CPU_SETSIZE) { return false; }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(static_cast<std::size_t>(*cpu), &set);
+  return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#else
+  static_cast<void>(cpu);
+  return false;
+#endif
+}
+
+// Keeps the compiler from discarding a result the benchmark never uses
+template<typename T> void do_not_optimize(const T& value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static const volatile void* escape = nullptr;
+  escape = &value;
+#endif
+}
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+struct Stats
+{
+  double median = 0.0;
+  double mad = 0.0; // median absolute deviation from the median
+  double min = 0.0;
+  double max = 0.0;
+};
+
+[[nodiscard]] inline double median_of(std::vector<double> values)
+{
+  if (values.empty()) { return 0.0; }
+  std::ranges::sort(values);
+  const std::size_t middle = values.size() / 2;
+  return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+[[nodiscard]] inline Stats stats_of(std::span<const double> samples)
+{
+  if (samples.empty()) { return {}; }
+  Stats stats;
+  stats.median = median_of({ samples.begin(), samples.end() });
+  std::vector<double> deviations;
+  deviations.reserve(samples.size());
+  for (const double sample : samples) { deviations.push_back(std::abs(sample - stats.median)); }
+  stats.mad = median_of(std::move(deviations));
+  const auto [lowest, highest] = std::ranges::minmax(samples);
+  stats.min = lowest;
+  stats.max = highest;
+  return stats;
+}
+
+// =============================================================================
+// Results
+// =============================================================================
+
+struct Result
+{
+  std::string name;
+  std::uint64_t items = 0; // per repetition
+  std::size_t repetitions = 0;
+  Stats ns_per_item;
+
+  [[nodiscard]] double items_per_second() const noexcept
+  {
+    return ns_per_item.median > 0.0 ? 1e9 / ns_per_item.median : 0.0; // NOLINT(readability-magic-numbers)
+  }
+};
+
+namespace detail {
+
+  inline std::string json_escape(std::string_view text)
+  {
+    std::string out;
+    out.reserve(text.size());
+    for (const char each : text) {
+      if (each == '"' || each == '\\') {
+        out += '\\';
+        out += each;
+      } else if (static_cast<unsigned char>(each) < 0x20) { // NOLINT(readability-magic-numbers)
+        out += ' ';
+      } else {
+        out += each;
+      }
+    }
+    return out;
+  }
+
+  // Value of "key": in one line of the JSON the harness writes
+  inline std::optional<std::string> json_string(std::string_view line, std::string_view key)
+  {
+    const std::string pattern = "\"" + std::string(key) + "\": \"";
+    const std::size_t start = line.find(pattern);
+    if (start == std::string_view::npos) { return std::nullopt; }
+    std::string value;
+    for (std::size_t idx = start + pattern.size(); idx < line.size(); ++idx) {
+      if (line[idx] == '\\' && idx + 1 < line.size()) {
+        value += line[++idx];
+      } else if (line[idx] == '"') {
+        return value;
+      } else {
+        value += line[idx];
+      }
+    }
+    return std::nullopt;
+  }
+
+  inline std::optional<double> json_number(std::string_view line, std::string_view key)
+  {
+    const std::string pattern = "\"" + std::string(key) + "\": ";
+    const std::size_t start = line.find(pattern);
+    if (start == std::string_view::npos) { return std::nullopt; }
+    const std::string rest(line.substr(start + pattern.size()));
+    char* end = nullptr;
+    const double value = std::strtod(rest.c_str(), &end);
+    if (end == rest.c_str()) { return std::nullopt; }
+    return value;
+  }
+
+  inline std::string format_rate(double per_second)
+  {
+    constexpr double mega = 1e6;
+    constexpr double kilo = 1e3;
+    std::array<char, 32> text{}; // NOLINT(readability-magic-numbers)
+    if (per_second >= mega) {
+      std::snprintf(text.data(), text.size(), "%.1f M/s", per_second / mega);
+    } else if (per_second >= kilo) {
+      std::snprintf(text.data(), text.size(), "%.1f k/s", per_second / kilo);
+    } else {
+      std::snprintf(text.data(), text.size(), "%.1f /s", per_second);
+    }
+    return text.data();
+  }
+
+} // namespace detail
+
+// Reads the results of an earlier --json run; empty when the file is missing or holds no benchmarks
+[[nodiscard]] inline std::vector<Result> read_json(const std::string& path)
+{
+  std::vector<Result> results;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    auto name = detail::json_string(line, "name");
+    const auto median = detail::json_number(line, "median_ns");
+    if (!name || !median) { continue; }
+    Result result;
+    result.name = std::move(*name);
+    result.ns_per_item.median = *median;
+    result.ns_per_item.mad = detail::json_number(line, "mad_ns").value_or(0.0);
+    result.ns_per_item.min = detail::json_number(line, "min_ns").value_or(*median);
+    result.ns_per_item.max = detail::json_number(line, "max_ns").value_or(*median);
+    result.items = static_cast<std::uint64_t>(detail::json_number(line, "items").value_or(0.0));
+    result.repetitions = static_cast<std::size_t>(detail::json_number(line, "repetitions").value_or(0.0));
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+// One benchmark per line, so read_json and line-based tools can pick them apart
+inline bool write_json(const std::string& path, std::span<const Result> results)
+{
+  std::ofstream file(path);
+  if (!file) { return false; }
+  file << "{\n  \"benchmarks\": [\n";
+  for (std::size_t idx = 0; idx < results.size(); ++idx) {
+    const Result& result = results[idx];
+    std::array<char, 256> numbers{}; // NOLINT(readability-magic-numbers)
+    std::snprintf(numbers.data(),
+      numbers.size(),
+      R"("median_ns": %.4f, "mad_ns": %.4f, "min_ns": %.4f, "max_ns": %.4f, "items_per_second": %.1f)",
+      result.ns_per_item.median,
+      result.ns_per_item.mad,
+      result.ns_per_item.min,
+      result.ns_per_item.max,
+      result.items_per_second());
+    file << R"(    {"name": ")" << detail::json_escape(result.name) << R"(", "items": )" << result.items
+         << R"(, "repetitions": )" << result.repetitions << ", " << numbers.data() << "}"
+         << (idx + 1 < results.size() ? ",\n" : "\n");
+  }
+  file << "  ]\n}\n";
+  return static_cast<bool>(file);
+}
+
+// =============================================================================
+// Baseline comparison
+// =============================================================================
+
+struct Comparison
+{
+  std::string name;
+  double baseline_ns = 0.0;
+  double current_ns = 0.0;
+  double change = 0.0; // (current - baseline) / baseline
+  bool regression = false;
+};
+
+// A benchmark regressed when its median is slower by more than threshold (a fraction) and the gap is wider
+// than the combined MAD of both runs, so noisy benchmarks need a clearer signal
+[[nodiscard]] inline std::vector<Comparison>
+  compare(std::span<const Result> baseline, std::span<const Result> current, double threshold)
+{
+  std::vector<Comparison> comparisons;
+  for (const Result& now : current) {
+    const auto before = std::ranges::find(baseline, now.name, &Result::name);
+    if (before == baseline.end() || before->ns_per_item.median <= 0.0) { continue; }
+    Comparison comparison{ .name = now.name,
+      .baseline_ns = before->ns_per_item.median,
+      .current_ns = now.ns_per_item.median,
+      .change = (now.ns_per_item.median - before->ns_per_item.median) / before->ns_per_item.median,
+      .regression = false };
+    const double gap = comparison.current_ns - comparison.baseline_ns;
+    comparison.regression = comparison.change > threshold && gap > now.ns_per_item.mad + before->ns_per_item.mad;
+    comparisons.push_back(std::move(comparison));
+  }
+  return comparisons;
+}
+
+// =============================================================================
+// Harness
+// =============================================================================
+
+// Handed to each repetition. Without start()/stop() the whole body is timed.
+class Run
+{
+public:
+  void start() noexcept { started_ = std::chrono::steady_clock::now(); }
+  void stop() noexcept { stopped_ = std::chrono::steady_clock::now(); }
+
+  // For runs that only know afterwards how much work they did
+  void set_items(std::uint64_t items) noexcept { items_ = items; }
+
+  // For runs whose cost is not their wall time, such as summed latencies; replaces start()/stop()
+  void set_elapsed(std::chrono::duration<double, std::nano> elapsed) noexcept { elapsed_ = elapsed; }
+
+  [[nodiscard]] bool warmup() const noexcept { return warmup_; }
+
+private:
+  friend class Harness;
+
+  std::chrono::steady_clock::time_point started_;
+  std::optional<std::chrono::steady_clock::time_point> stopped_;
+  std::optional<std::chrono::duration<double, std::nano>> elapsed_;
+  std::uint64_t items_ = 0;
+  bool warmup_ = false;
+};
+
+class Harness
+{
+public:
+  Harness(int argc, char** argv)
+  {
+    const std::span<char*> args(argv, static_cast<std::size_t>(argc));
+    for (std::size_t idx = 1; idx < args.size(); ++idx) {
+      const std::string_view flag = args[idx];
+      if (flag == "--perf") {
+        perf_ = true;
+        continue;
+      }
+      const char* value = idx + 1 < args.size() ? args[idx + 1] : nullptr;
+      if (value == nullptr || !parse(flag, value)) { usage(args[0]); }
+      ++idx;
+    }
+    if (pin_ && !pin_current_thread(pin_)) { std::fprintf(stderr, "warning: could not pin to CPU %d\n", *pin_); }
+  }
+
+  // Runs body warmup + repetitions times; each measured run contributes elapsed time / items
+  template<typename Body> void run(std::string_view name, std::uint64_t items, Body&& body)
+  {
+    if (!filter_.empty() && name.find(filter_) == std::string_view::npos) { return; }
+    std::vector<double> samples;
+    samples.reserve(repetitions_);
+    std::uint64_t last_items = items;
+    for (std::size_t idx = 0; idx < warmup_ + repetitions_; ++idx) {
+      Run run;
+      run.items_ = items;
+      run.warmup_ = idx < warmup_;
+      run.start();
+      body(run);
+      const auto stopped = run.stopped_.value_or(std::chrono::steady_clock::now());
+      if (run.warmup_ || run.items_ == 0) { continue; }
+      const std::chrono::duration<double, std::nano> elapsed = run.elapsed_.value_or(stopped - run.started_);
+      samples.push_back(elapsed.count() / static_cast<double>(run.items_));
+      last_items = run.items_;
+    }
+    Result result{
+      .name = std::string(name), .items = last_items, .repetitions = samples.size(), .ns_per_item = stats_of(samples)
+    };
+    std::printf("%-56s %10.2f ns/item  +-%-8.2f %12s  (%zu reps)\n",
+      result.name.c_str(),
+      result.ns_per_item.median,
+      result.ns_per_item.mad,
+      detail::format_rate(result.items_per_second()).c_str(),
+      result.repetitions);
+    std::fflush(stdout);
+    results_.push_back(std::move(result));
+  }
+
+  // CPU for the k-th helper thread when --pin is given, so benchmarks can pin their own threads
+  [[nodiscard]] std::optional<int> cpu(int offset) const noexcept
+  {
+    if (!pin_) { return std::nullopt; }
+    return *pin_ + offset;
+  }
+
+  [[nodiscard]] std::size_t repetitions() const noexcept { return repetitions_; }
+
+  // --perf was given and name passes --filter: the benchmark should follow up with its instrumented pass.
+  // Instrumentation stays out of run(), so the timed loops match earlier results.
+  [[nodiscard]] bool perf_pass(std::string_view name) const noexcept
+  {
+    return perf_ && (filter_.empty() || name.find(filter_) != std::string_view::npos);
+  }
+  [[nodiscard]] const std::vector<Result>& results() const noexcept { return results_; }
+
+  // Writes --json, compares against --baseline. Returns the process exit code: 1 on a regression.
+  [[nodiscard]] int finish()
+  {
+    if (!json_.empty() && !write_json(json_, results_)) {
+      std::fprintf(stderr, "error: could not write %s\n", json_.c_str());
+    }
+    if (baseline_.empty()) { return 0; }
+    const std::vector<Result> baseline = read_json(baseline_);
+    if (baseline.empty()) {
+      std::fprintf(stderr, "error: no benchmarks in baseline %s\n", baseline_.c_str());
+      return 1;
+    }
+    int regressions = 0;
+    std::printf("\n%-56s %12s %12s %9s\n", "vs baseline", "before ns", "now ns", "change");
+    for (const Comparison& each : compare(baseline, results_, threshold_)) {
+      std::printf("%-56s %12.2f %12.2f %+8.1f%%%s\n",
+        each.name.c_str(),
+        each.baseline_ns,
+        each.current_ns,
+        each.change * 100.0, // NOLINT(readability-magic-numbers)
+        each.regression ? "  REGRESSION" : "");
+      regressions += each.regression ? 1 : 0;
+    }
+    return regressions == 0 ? 0 : 1;
+  }
+
+private:
+  bool parse(std::string_view flag, const char* value)
+  {
+    if (flag == "--repetitions") { return parse_count(value, repetitions_) && repetitions_ > 0; }
+    if (flag == "--warmup") { return parse_count(value, warmup_); }
+    if (flag == "--pin") {
+      std::size_t cpu = 0;
+      if (!parse_count(value, cpu)) { return false; }
+      pin_ = static_cast<int>(cpu);
+      return true;
+    }
+    if (flag == "--threshold") {
+      char* end = nullptr;
+      threshold_ = std::strtod(value, &end) / 100.0; // NOLINT(readability-magic-numbers)
+      return end != value && threshold_ >= 0.0;
+    }
+    if (flag == "--filter") {
+      filter_ = value;
+      return true;
+    }
+    if (flag == "--json") {
+      json_ = value;
+      return true;
+    }
+    if (flag == "--baseline") {
+      baseline_ = value;
+      return true;
+    }
+    return false;
+  }
+
+  static bool parse_count(const char* value, std::size_t& out)
+  {
+    char* end = nullptr;
+    const unsigned long long parsed = std::strtoull(value, &end, 10); // NOLINT(google-runtime-int)
+    if (end == value || *end != '\0') { return false; }
+    out = static_cast<std::size_t>(parsed);
+    return true;
+  }
+
+  [[noreturn]] static void usage(const char* program)
+  {
+    std::fprintf(stderr,
+      "usage: %s [--repetitions N] [--warmup N] [--pin CPU] [--filter TEXT] [--json PATH] [--baseline PATH] "
+      "[--threshold PCT] [--perf]\n",
+      program);
+    std::exit(2); // NOLINT(concurrency-mt-unsafe)
+  }
+
+  std::size_t repetitions_ = 5;
+  std::size_t warmup_ = 1;
+  std::optional<int> pin_;
+  double threshold_ = 0.05; // NOLINT(readability-magic-numbers)
+  std::string filter_;
+  std::string json_;
+  std::string baseline_;
+  bool perf_ = false;
+  std::vector<Result> results_;
+};
+
+} // namespace ev_bench
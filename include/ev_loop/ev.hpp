@@ -1,20 +1,80 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
 #include <chrono>
+#include <cmath>
 #include <concepts>
 #include <condition_variable>
+#include <coroutine>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
 #include <queue>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#define EV_HAS_EVENTFD 1
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#define EV_HAS_IO_URING 1
+#else
+#define EV_HAS_IO_URING 0
+#endif
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#define EV_HAS_PERF_EVENTS 1
+#else
+#define EV_HAS_PERF_EVENTS 0
+#endif
+#else
+#define EV_HAS_EVENTFD 0
+#define EV_HAS_IO_URING 0
+#define EV_HAS_PERF_EVENTS 0
+#endif
+
+// Invariant TSC timestamps for DispatchLatency (x86-64 only)
+#if defined(__x86_64__) || defined(_M_X64)
+#define EV_HAS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define EV_HAS_TSC 0
+#endif
 
 // MSVC doesn't support [[assume]] yet, use __assume instead
 #ifdef _MSC_VER
@@ -23,6 +83,18 @@
 #define EV_ASSUME(expr) [[assume(expr)]]
 #endif
 
+// USDT probes (provider ev_loop) on the queue and dispatch paths, for bpftrace and perf. Built with
+// -DEV_USDT=1 and systemtap's <sys/sdt.h>; each probe is then a single nop until a tracer attaches.
+// Otherwise EV_PROBE expands to nothing and its arguments are never evaluated.
+#if defined(EV_USDT) && EV_USDT && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define EV_HAS_USDT 1
+#define EV_PROBE(name, ...) STAP_PROBEV(ev_loop, name, __VA_ARGS__)
+#else
+#define EV_HAS_USDT 0
+#define EV_PROBE(name, ...) static_cast<void>(0)
+#endif
+
 namespace ev_loop {
 
 // =============================================================================
@@ -44,6 +116,234 @@ struct OwnThread
 {
 };
 
+// Loop option tags - listed alongside receivers to configure the loop itself
+// Usage: ev_loop::EventLoop<Ping, Pong, ev_loop::EventFdWakeup>
+
+// Remote-queue wakeup through an eventfd instead of a condition variable (Linux only).
+// The fd is exposed via EventLoop::native_handle() so the loop can be driven from an
+// external epoll/poll reactor with EventLoop::poll_ready().
+struct EventFdWakeup
+{
+  using loop_option = EventFdWakeup;
+};
+
+// Loop-owned epoll set (Linux only, implies EventFdWakeup). Receivers register fds with
+// watch_fd<Event>() and readiness is delivered as Event{ fd, events } through the normal
+// dispatch path. Wait and Hybrid block in epoll_wait on both the fds and the remote queue.
+struct FdSources
+{
+  using loop_option = FdSources;
+};
+
+// Readiness event for fds registered with watch_fd - any aggregate { int fd; uint32 events; } works
+// Tag keeps sources apart: using SocketReadable = ev_loop::FdEvent<struct SocketTag>;
+template<typename Tag> struct FdEvent
+{
+  int fd;
+  std::uint32_t events;
+};
+
+// Backend selection for the IoUring option
+enum class IoBackend : std::uint8_t {
+  automatic, // io_uring when the kernel allows it, thread-pool emulation otherwise
+  io_uring, // io_uring or throw std::system_error from the loop constructor
+  thread_pool, // pread/pwrite on worker threads
+};
+
+// Asynchronous file I/O owned by the loop (Linux only, implies FdSources). SameThread handlers
+// submit reads and writes through their dispatcher and receive completions as typed events
+// (see IoCompletion). Submissions are batched and flushed with one syscall when the loop runs
+// out of queued events; buffers come from a fixed pool registered with the kernel.
+// Entries bounds the number of in-flight operations (power of 2).
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+template<std::size_t Entries = 128,
+  std::size_t BufferCount = 128,
+  std::size_t BufferSize = 4096,
+  IoBackend Backend = IoBackend::automatic>
+struct IoUring
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{
+  static_assert((Entries & (Entries - 1)) == 0, "Entries must be power of 2");
+  static_assert(BufferCount > 0 && BufferSize > 0, "IoUring needs a non-empty buffer pool");
+
+  using loop_option = IoUring;
+  // cppcheck-suppress unusedStructMember
+  static constexpr std::size_t entries = Entries;
+  // cppcheck-suppress unusedStructMember
+  static constexpr std::size_t buffer_count = BufferCount;
+  // cppcheck-suppress unusedStructMember
+  static constexpr std::size_t buffer_size = BufferSize;
+  // cppcheck-suppress unusedStructMember
+  static constexpr IoBackend backend = Backend;
+};
+
+// Correlation stamp carried by request and reply events; 0 means "not part of a request".
+// Request/reply events declare a `ev_loop::correlation_id correlation_id` member.
+using correlation_id = std::uint64_t;
+
+// Why a request's continuation ran without a reply. Continuations that accept it are called with it once
+// instead of with the reply; the others are dropped silently.
+enum class RequestStatus : std::uint8_t
+{
+  timed_out, // the deadline given to dispatcher.request passed first
+  cancelled, // dispatcher.cancel(id) or EventLoop::cancel(id)
+};
+
+// Pending-request table for dispatcher.request<Req, Reply>(). Slots bounds outstanding
+// requests; each continuation is stored inline in CallbackBytes (no heap allocation).
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+template<std::size_t Slots = 256, std::size_t CallbackBytes = 48> struct RequestReply
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{
+  static_assert(Slots > 0 && Slots <= std::numeric_limits<std::uint32_t>::max(), "RequestReply needs 1..2^32-1 slots");
+
+  using loop_option = RequestReply;
+  // cppcheck-suppress unusedStructMember
+  static constexpr std::size_t slots = Slots;
+  // cppcheck-suppress unusedStructMember
+  static constexpr std::size_t callback_bytes = CallbackBytes;
+};
+
+// Queue an observed event went through: the loop's local ring, its cross-thread queue, or an
+// OwnThread receiver's inbox
+enum class QueueKind : std::uint8_t {
+  local,
+  remote,
+  own_thread,
+};
+
+// Default observer policy - every hook is an empty inline function and the loop skips the
+// calls entirely, so an unobserved loop compiles to the same code as before.
+// Custom policies derive from NullObserver and hide the hooks they care about:
+//   struct Counting : ev_loop::NullObserver {
+//     template<typename Owner, typename Event> void on_enqueue(ev_loop::QueueKind kind, std::size_t depth) noexcept;
+//   };
+// Owner is the OwnThread receiver for QueueKind::own_thread and void for the loop's own queue.
+// Queue and dispatch hooks run on the thread doing the push/dispatch (OwnThread receivers and
+// external emitters included), so policies with state must be thread-safe.
+struct NullObserver
+{
+  // depth is the queue's size right after the push
+  template<typename Owner, typename Event> void on_enqueue(QueueKind /*kind*/, std::size_t /*depth*/) noexcept {}
+  template<typename Owner, typename Event> void on_dequeue(QueueKind /*kind*/) noexcept {}
+  // Event discarded because its queue was full
+  template<typename Owner, typename Event> void on_drop(QueueKind /*kind*/) noexcept {}
+  template<typename Receiver, typename Event> void on_dispatch_begin() noexcept {}
+  template<typename Receiver, typename Event> void on_dispatch_end() noexcept {}
+  // Loop thread about to block in a cv/eventfd/epoll wait, or an OwnThread receiver about to
+  // block in its inbox, and back from it
+  void on_park() noexcept {}
+  void on_unpark() noexcept {}
+};
+
+// Attach an observer policy: ev_loop::EventLoop<Ping, Pong, ev_loop::Observe<MyObserver>>
+// The loop owns one Policy instance, reachable through EventLoop::observer().
+template<typename Policy> struct Observe
+{
+  static_assert(std::is_base_of_v<NullObserver, Policy>, "Observer policies derive from ev_loop::NullObserver");
+
+  using loop_option = Observe;
+  using policy = Policy;
+};
+
+// Built-in counter registry: ev_loop::EventLoop<Ping, Pong, ev_loop::Metrics>
+// Counts dispatches per receiver and event type, queue traffic, depth high-water marks, drops and
+// wakeups. Every thread writes its own counter block, so the hot path adds no shared atomic
+// read-modify-writes. Read from any thread with EventLoop::metrics().snapshot(). Combines with Observe.
+struct Metrics
+{
+  using loop_option = Metrics;
+};
+
+// Queue-wait and handler-time histograms per receiver: ev_loop::EventLoop<Ping, Pong, ev_loop::DispatchLatency>
+// Every queue slot carries the time its event was enqueued (invariant TSC where available,
+// steady_clock otherwise); dispatch records now - stamp and the handler duration into log-linear
+// histograms read through EventLoop::latency().
+struct DispatchLatency
+{
+  using loop_option = DispatchLatency;
+};
+
+// While a TraceSession is active, every thread of the loop records enqueues, dispatches and parks
+// into its own trace ring; the session writes them out as a Chrome trace.
+struct Trace
+{
+  using loop_option = Trace;
+};
+
+// Every thread keeps its last 256 dispatches (receiver, event, TSC) in a per-thread ring. The rings are
+// written to stderr on SIGSEGV/SIGABRT, or to any fd through EventLoop::dump_flight_recorder(). Linux only.
+struct FlightRecorder
+{
+  using loop_option = FlightRecorder;
+};
+
+// Busy/idle split of every loop thread: ev_loop::EventLoop<Ping, Pong, ev_loop::Utilization>
+// Each thread accumulates its handler and parked time in its own slot; the remainder of its wall time
+// was spent polling or spinning. EventLoop::utilization().snapshot() adds per-thread CPU time (Linux).
+struct Utilization
+{
+  using loop_option = Utilization;
+};
+
+// Hardware counters of every loop thread: ev_loop::EventLoop<Ping, Pong, ev_loop::PerfCounters>
+// Each thread opens cycles, instructions, cache-miss and branch-miss counters with perf_event_open on its first
+// hook, counting its own user-space work only. Counters the kernel refuses (perf_event_paranoid, no PMU in a
+// VM, not Linux) read as empty in EventLoop::perf_counters().snapshot(); the loop itself is unaffected.
+struct PerfCounters
+{
+  using loop_option = PerfCounters;
+};
+
+// Publishes a "dispatch started at" stamp for the loop thread and each OwnThread receiver. A StallWatchdog
+// polls them to report handlers that run too long and queues that stop draining.
+struct Watchdog
+{
+  using loop_option = Watchdog;
+};
+
+// Sampled handler cost per receiver and event type: ev_loop::EventLoop<Ping, Pong, ev_loop::Profile<>>
+// About one dispatch in Period per receiver is timed with two TickClock reads; every other dispatch only
+// bumps a counter. With Jitter the gap to the next sample is drawn from 1 .. 2 * Period - 1, so periodic
+// traffic cannot line up with the sampler; without it exactly every Period-th dispatch is timed.
+// EventLoop::profile().snapshot() ranks the pairs by estimated total cost (sampled mean * dispatches).
+// With Counters, each sample also reads the dispatching thread's cycles and instructions (perf_event_open,
+// Linux), at the price of two read(2) calls per sample.
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+template<std::uint32_t Period = 64, bool Jitter = true, bool Counters = false> struct Profile
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+{
+  static_assert(Period > 0, "Profile needs a sampling period of at least 1");
+
+  using loop_option = Profile;
+  // cppcheck-suppress unusedStructMember
+  static constexpr std::uint32_t period = Period;
+  // cppcheck-suppress unusedStructMember
+  static constexpr bool jitter = Jitter;
+  // cppcheck-suppress unusedStructMember
+  static constexpr bool counters = Counters;
+};
+
+// Heap allocations per handler and per emit: ev_loop::EventLoop<Ping, Pong, ev_loop::AllocationTracking>
+// While a handler or an emit runs, its thread is tagged with the (receiver, event) or (emitter, event) pair.
+// The program's replacement operator new/delete report to ev_loop::note_allocation()/note_deallocation(),
+// which charge the tagged pair; EV_LOOP_TRACK_ALLOCATIONS() defines such replacements. A receiver declaring
+// `static constexpr bool no_alloc = true;` calls the no_alloc handler (print and abort by default) whenever its
+// handlers allocate, emits included. EventLoop::allocations().snapshot() reads the counts from any thread.
+struct AllocationTracking
+{
+  using loop_option = AllocationTracking;
+};
+
+// Lock contention on the queue mutexes: ev_loop::EventLoop<Ping, Pong, ev_loop::LockProfile>
+// The loop queue's remote side and every MPSC OwnThread inbox lock a mutex that records, per thread, how often
+// it was taken, how often it had to block, and the time spent waiting for it and holding it.
+// EventLoop::lock_snapshot() reads them per (queue, thread) from any thread.
+struct LockProfile
+{
+  using loop_option = LockProfile;
+};
+
 // =============================================================================
 // Forward declarations
 // =============================================================================
@@ -58,12 +358,141 @@ template<typename EmitterType, typename EventLoopType> class SameThreadTypedDisp
 
 template<typename EmitterType, typename EventLoopType> class OwnThreadTypedDispatcher;
 
+namespace detail {
+  template<typename Option> class AsyncIo;
+} // namespace detail
+
 // =============================================================================
 // Implementation details
 // =============================================================================
 
 namespace detail {
 
+  // Counters written by one thread only (the owning thread, or the holder of a lock): a plain load/store pair
+  // instead of a locked read-modify-write. Readers on other threads still see whole values.
+  inline void single_writer_add(std::atomic<std::uint64_t>& counter, std::uint64_t amount) noexcept
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+  // Latency timestamps: rdtsc when the CPU has an invariant TSC, steady_clock nanoseconds otherwise.
+  // Ticks are only converted to time on the reading side, through ns_per_tick().
+  class TickClock
+  {
+  public:
+    [[nodiscard]] static std::uint64_t now() noexcept
+    {
+#if EV_HAS_TSC
+      if (tsc()) [[likely]] {
+#ifdef _MSC_VER
+        return __rdtsc();
+#else
+        return __builtin_ia32_rdtsc();
+#endif
+      }
+#endif
+      return steady_ticks();
+    }
+
+    // Calibrated once per process against steady_clock; the first call takes calibration_window
+    [[nodiscard]] static double ns_per_tick() noexcept
+    {
+      if (!tsc()) { return 1.0; }
+      static const double ratio = [] {
+        const double calibrated = calibrate();
+        known_ratio().store(calibrated, std::memory_order_relaxed);
+        return calibrated;
+      }();
+      return ratio;
+    }
+
+    // ns_per_tick() if it is already known, 0 otherwise. Never blocks, so signal handlers may call it.
+    [[nodiscard]] static double known_ns_per_tick() noexcept
+    {
+      if (!tsc()) { return 1.0; }
+      return known_ratio().load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static bool tsc() noexcept
+    {
+      static const bool usable = has_invariant_tsc();
+      return usable;
+    }
+
+  private:
+    static constexpr auto calibration_window = std::chrono::milliseconds{ 10 };
+
+    [[nodiscard]] static std::atomic<double>& known_ratio() noexcept
+    {
+      static std::atomic<double> ratio{ 0.0 };
+      return ratio;
+    }
+
+    [[nodiscard]] static std::uint64_t steady_ticks() noexcept
+    {
+      return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+    }
+
+    [[nodiscard]] static bool has_invariant_tsc() noexcept
+    {
+      // CPUID leaf 0x80000007, EDX bit 8: TSC runs at a constant rate in every P/C-state
+      constexpr unsigned power_leaf = 0x80000007U;
+      constexpr unsigned invariant_bit = 1U << 8U;
+#if EV_HAS_TSC && defined(_MSC_VER)
+      std::array<int, 4> regs{};
+      __cpuid(regs.data(), static_cast<int>(power_leaf));
+      return (static_cast<unsigned>(regs[3]) & invariant_bit) != 0;
+#elif EV_HAS_TSC
+      unsigned eax = 0;
+      unsigned ebx = 0;
+      unsigned ecx = 0;
+      unsigned edx = 0;
+      if (__get_cpuid(power_leaf, &eax, &ebx, &ecx, &edx) == 0) { return false; }
+      return (edx & invariant_bit) != 0;
+#else
+      return false;
+#endif
+    }
+
+    [[nodiscard]] static double calibrate() noexcept
+    {
+      const std::uint64_t ticks_start = now();
+      const std::uint64_t ns_start = steady_ticks();
+      std::this_thread::sleep_for(calibration_window);
+      const std::uint64_t ticks = now() - ticks_start;
+      const std::uint64_t nanos = steady_ticks() - ns_start;
+      return ticks == 0 ? 1.0 : static_cast<double>(nanos) / static_cast<double>(ticks);
+    }
+  };
+
+  // Type name for metric and trace labels, cut out of the compiler's function signature
+  template<typename T> consteval std::string_view type_name() noexcept
+  {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::string_view name = __FUNCSIG__;
+    const std::size_t start = name.find("type_name<") + std::string_view("type_name<").size();
+    name = name.substr(start, name.rfind(">(") - start);
+    for (const std::string_view keyword : { "struct ", "class ", "enum ", "union " }) {
+      if (name.starts_with(keyword)) { name.remove_prefix(keyword.size()); }
+    }
+    return name;
+#else
+    const std::string_view signature = __PRETTY_FUNCTION__;
+    const std::size_t start = signature.find("T = ") + std::string_view("T = ").size();
+    return signature.substr(start, signature.find_first_of(";]", start) - start);
+#endif
+  }
+
+  // NUL-terminated copy of type_name<T>() for probe arguments, which tracers read as C strings
+  template<typename T> inline constexpr auto type_name_cstr = [] {
+    constexpr std::string_view name = type_name<T>();
+    std::array<char, name.size() + 1> out{};
+    std::ranges::copy(name, out.begin());
+    return out;
+  }();
+
   // Portable CPU pause hint for spin loops
   // LCOV_EXCL_START - inline assembly not trackable by coverage tools
   inline void cpu_pause() noexcept
@@ -402,6 +831,10 @@ namespace detail {
     [[nodiscard]] constexpr bool empty() const noexcept { return head_ == tail_; }
     [[nodiscard]] constexpr std::size_t size() const noexcept { return tail_ - head_; }
 
+    // Positions since construction: the next slot to pop and to push
+    [[nodiscard]] constexpr std::size_t head() const noexcept { return head_; }
+    [[nodiscard]] constexpr std::size_t tail() const noexcept { return tail_; }
+
   private:
     std::array<T, Capacity> buffer_{};
     std::size_t head_ = 0;
@@ -421,6 +854,13 @@ namespace detail {
   template<typename T>
   concept has_thread_mode = requires { typename T::thread_mode; };
 
+  template<typename T>
+  concept is_loop_option = requires { typename T::loop_option; };
+
+  // Event types the epoll set can construct from a readiness notification
+  template<typename T>
+  concept is_fd_event = requires(int fd, std::uint32_t events) { T{ fd, events }; };
+
   // Thread mode type traits - check if type uses SameThread or OwnThread
   // Use struct specialization to avoid accessing T::thread_mode when it doesn't exist
   template<typename T, bool HasMode = has_thread_mode<T>> struct is_same_thread : std::true_type
@@ -521,6 +961,17 @@ namespace detail {
 
   template<std::size_t I, typename List> using type_list_at_t = typename type_list_at<I, List>::type;
 
+  // Index of type T in type_list (size of the list if not found)
+  template<typename List, typename T> struct type_list_index_of;
+
+  template<typename... Ts, typename T>
+  struct type_list_index_of<type_list<Ts...>, T> : std::integral_constant<std::size_t, index_of_v<T, Ts...>>
+  {
+  };
+
+  template<typename List, typename T>
+  inline constexpr std::size_t type_list_index_of_v = type_list_index_of<List, T>::value;
+
   // =============================================================================
   // SPSC queue - lock-free for maximum throughput
   // =============================================================================
@@ -538,12 +989,24 @@ namespace detail {
 
     public:
       bool push(T event)
+      {
+        std::size_t depth = 0;
+        return push(std::move(event), depth);
+      }
+
+      // depth: events queued after this push, from the head the capacity check already loaded
+      bool push(T event, std::size_t& depth)
       {
         const std::size_t head = head_.load(std::memory_order_acquire);
         const std::size_t tail = tail_.load(std::memory_order_relaxed);
-        if (tail - head >= Capacity) [[unlikely]] { return false; }
+        if (tail - head >= Capacity) [[unlikely]] {
+          EV_PROBE(spsc_drop, this);
+          return false;
+        }
         buffer_[tail & mask_] = std::move(event);
         tail_.store(tail + 1, std::memory_order_release);
+        depth = tail + 1 - head;
+        EV_PROBE(spsc_enqueue, this, tail, depth);
         signal_.fetch_add(1, std::memory_order_release);
         signal_.notify_one();
         return true;
@@ -553,9 +1016,7 @@ namespace detail {
       {
         const std::size_t head = head_.load(std::memory_order_relaxed);
         if (head == tail_.load(std::memory_order_acquire)) { return nullptr; }
-        current_ = std::move(buffer_[head & mask_]);
-        head_.store(head + 1, std::memory_order_release);
-        return &current_;
+        return take(head);
       }
 
       [[nodiscard]] T* pop_spin()
@@ -569,12 +1030,13 @@ namespace detail {
           tail = tail_.load(std::memory_order_acquire);
         }
         // LCOV_EXCL_STOP
-        current_ = std::move(buffer_[head & mask_]);
-        head_.store(head + 1, std::memory_order_release);
-        return &current_;
+        return take(head);
       }
 
-      [[nodiscard]] T* pop_wait()
+      // Hooks gets on_park()/on_unpark() around the blocking wait (an observer policy)
+      template<typename Hooks = NullObserver>
+      // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
+      [[nodiscard]] T* pop_wait(Hooks&& hooks = Hooks{})
       {
         constexpr int spin_iterations = 1000;
         while (true) {
@@ -583,11 +1045,7 @@ namespace detail {
             if (stop_.load(std::memory_order_relaxed)) [[unlikely]] { return nullptr; }
             const std::size_t head = head_.load(std::memory_order_relaxed);
             const std::size_t tail = tail_.load(std::memory_order_acquire);
-            if (head != tail) {
-              current_ = std::move(buffer_[head & mask_]);
-              head_.store(head + 1, std::memory_order_release);
-              return &current_;
-            }
+            if (head != tail) { return take(head); }
             cpu_pause();
           }
           // Wait phase - save CPU when idle
@@ -596,10 +1054,21 @@ namespace detail {
           const std::size_t head = head_.load(std::memory_order_relaxed);
           const std::size_t tail = tail_.load(std::memory_order_acquire);
           if (head != tail) { continue; } // Data arrived during check
+          hooks.on_park();
+          EV_PROBE(spsc_park, this);
           signal_.wait(sig, std::memory_order_acquire);
+          EV_PROBE(spsc_unpark, this);
+          hooks.on_unpark();
         }
       }
 
+      // Approximate from any thread, exact from the producer right after a push
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+      }
+
       // cppcheck-suppress functionStatic ; interface consistency with mpsc::Queue
       void notify() { /* No-op for lock-free */ }
 
@@ -613,6 +1082,15 @@ namespace detail {
       [[nodiscard]] bool is_stopped() const noexcept { return stop_.load(std::memory_order_acquire); }
 
     private:
+      // Consumer only, with head != tail
+      [[nodiscard]] T* take(std::size_t head)
+      {
+        current_ = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        EV_PROBE(spsc_dequeue, this, head);
+        return &current_;
+      }
+
       // MSVC C4324: structure was padded due to alignment specifier (intentional for cache line separation)
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -631,6 +1109,265 @@ namespace detail {
 
   } // namespace spsc
 
+} // namespace detail
+
+// =============================================================================
+// Lock profile snapshot - contention on the queue mutexes (LockProfile option)
+// =============================================================================
+
+struct LockSnapshot
+{
+  struct Entry
+  {
+    std::string_view queue; // "loop" for the loop's queue, or the OwnThread receiver owning the inbox
+    std::string_view thread; // "loop", the OwnThread receiver's type, or the external emitter's type
+    std::uint32_t thread_id; // numbers threads in the order they first took a profiled lock; tells namesakes apart
+    std::uint64_t acquisitions;
+    std::uint64_t contended; // acquisitions that found the mutex held and had to block
+    std::chrono::nanoseconds wait; // blocked in contended acquisitions, in total
+    std::chrono::nanoseconds max_wait;
+    std::chrono::nanoseconds hold; // from acquisition to release, in total, condition variable waits excluded
+    std::chrono::nanoseconds max_hold;
+
+    [[nodiscard]] double contention() const noexcept
+    {
+      if (acquisitions == 0) { return 0.0; }
+      return static_cast<double>(contended) / static_cast<double>(acquisitions);
+    }
+  };
+
+  // One entry per (queue, thread), longest total wait first
+  std::vector<Entry> entries;
+
+  [[nodiscard]] const Entry* find(std::string_view queue, std::string_view thread) const noexcept
+  {
+    const auto found = std::ranges::find_if(
+      entries, [&](const Entry& entry) { return entry.queue == queue && entry.thread == thread; });
+    return found == entries.end() ? nullptr : &*found;
+  }
+
+  // Every thread of one queue summed up; the maxima are the largest of any thread
+  [[nodiscard]] Entry queue_total(std::string_view queue) const noexcept
+  {
+    Entry total{ .queue = queue,
+      .thread = {},
+      .thread_id = 0,
+      .acquisitions = 0,
+      .contended = 0,
+      .wait = {},
+      .max_wait = {},
+      .hold = {},
+      .max_hold = {} };
+    for (const Entry& entry : entries) {
+      if (entry.queue != queue) { continue; }
+      total.acquisitions += entry.acquisitions;
+      total.contended += entry.contended;
+      total.wait += entry.wait;
+      total.max_wait = std::max(total.max_wait, entry.max_wait);
+      total.hold += entry.hold;
+      total.max_hold = std::max(total.max_hold, entry.max_hold);
+    }
+    return total;
+  }
+
+  // Plain-text table, one (queue, thread) pair per line
+  [[nodiscard]] std::string table() const
+  {
+    std::string out = "  acquisitions  contended     wait ms  max wait us     hold ms  max hold us  queue <- thread\n";
+    std::array<char, 112> line{}; // NOLINT(readability-magic-numbers)
+    for (const Entry& entry : entries) {
+      // NOLINTBEGIN(google-runtime-int,readability-magic-numbers) - printf conversions, ns to ms/us
+      const int written = std::snprintf(line.data(),
+        line.size(),
+        "%14llu  %8.2f%%  %10.3f  %11.1f  %10.3f  %11.1f  ",
+        static_cast<unsigned long long>(entry.acquisitions),
+        entry.contention() * 100.0,
+        static_cast<double>(entry.wait.count()) / 1e6,
+        static_cast<double>(entry.max_wait.count()) / 1e3,
+        static_cast<double>(entry.hold.count()) / 1e6,
+        static_cast<double>(entry.max_hold.count()) / 1e3);
+      // NOLINTEND(google-runtime-int,readability-magic-numbers)
+      if (written > 0) { out.append(line.data(), std::min(static_cast<std::size_t>(written), line.size() - 1)); }
+      out += entry.queue;
+      out += " <- ";
+      out += entry.thread;
+      out += " #";
+      out += std::to_string(entry.thread_id);
+      out += '\n';
+    }
+    return out;
+  }
+};
+
+namespace detail {
+
+  // =============================================================================
+  // Profiled mutex - std::mutex recording wait, hold and contention per thread (LockProfile option)
+  // =============================================================================
+
+  // How the calling thread shows up in lock profiles: OwnThread receiver threads name themselves, external
+  // emitters name the thread for the length of each emit, every other thread is "loop"
+  inline thread_local std::string_view lock_thread_name{ "loop" };
+
+  inline std::atomic<std::uint32_t> lock_thread_ids{ 0 };
+
+  [[nodiscard]] inline std::uint32_t lock_thread_id() noexcept
+  {
+    thread_local const std::uint32_t id = lock_thread_ids.fetch_add(1, std::memory_order_relaxed) + 1;
+    return id;
+  }
+
+  // Names the calling thread in lock profiles until destroyed
+  class LockThreadScope
+  {
+  public:
+    explicit LockThreadScope(std::string_view name) noexcept : outer_(lock_thread_name) { lock_thread_name = name; }
+    ~LockThreadScope() { lock_thread_name = outer_; }
+
+    LockThreadScope(const LockThreadScope&) = delete;
+    LockThreadScope& operator=(const LockThreadScope&) = delete;
+    LockThreadScope(LockThreadScope&&) = delete;
+    LockThreadScope& operator=(LockThreadScope&&) = delete;
+
+  private:
+    std::string_view outer_;
+  };
+
+  struct NoLockThreadScope
+  {
+    explicit NoLockThreadScope(std::string_view /*name*/) noexcept {}
+  };
+
+  // Statistics are written while the mutex is held, so every counter has one writer at a time and needs no
+  // read-modify-write; snapshots read them from any thread. Threads past max_threads share one slot.
+  class ProfiledMutex
+  {
+    static constexpr std::size_t max_threads = 16;
+
+    struct Slot
+    {
+      // Written before slot_count_ publishes the slot
+      std::uint32_t thread = 0;
+      std::string_view name{ "other" };
+
+      std::atomic<std::uint64_t> acquisitions{ 0 };
+      std::atomic<std::uint64_t> contended{ 0 };
+      std::atomic<std::uint64_t> wait{ 0 };
+      std::atomic<std::uint64_t> max_wait{ 0 };
+      std::atomic<std::uint64_t> hold{ 0 };
+      std::atomic<std::uint64_t> max_hold{ 0 };
+    };
+
+  public:
+    void lock()
+    {
+      if (mutex_.try_lock()) [[likely]] {
+        acquired(TickClock::now(), 0);
+        return;
+      }
+      const std::uint64_t begin = TickClock::now();
+      mutex_.lock();
+      const std::uint64_t now = TickClock::now();
+      acquired(now, std::max<std::uint64_t>(now - begin, 1));
+    }
+
+    [[nodiscard]] bool try_lock()
+    {
+      if (!mutex_.try_lock()) { return false; }
+      acquired(TickClock::now(), 0);
+      return true;
+    }
+
+    void unlock()
+    {
+      const std::uint64_t held = TickClock::now() - acquired_at_;
+      single_writer_add(holder_->hold, held);
+      raise(holder_->max_hold, held);
+      mutex_.unlock();
+    }
+
+    // Appends one entry per thread that took the mutex
+    void collect(std::string_view queue, std::vector<LockSnapshot::Entry>& out) const
+    {
+      const double ns_per_tick = TickClock::ns_per_tick();
+      const auto to_ns = [ns_per_tick](const std::atomic<std::uint64_t>& ticks) {
+        return std::chrono::nanoseconds{ static_cast<std::int64_t>(
+          static_cast<double>(ticks.load(std::memory_order_relaxed)) * ns_per_tick) };
+      };
+      const auto add_slot = [&](const Slot& slot) {
+        const std::uint64_t acquisitions = slot.acquisitions.load(std::memory_order_relaxed);
+        if (acquisitions == 0) { return; }
+        out.push_back({ .queue = queue,
+          .thread = slot.name,
+          .thread_id = slot.thread,
+          .acquisitions = acquisitions,
+          .contended = slot.contended.load(std::memory_order_relaxed),
+          .wait = to_ns(slot.wait),
+          .max_wait = to_ns(slot.max_wait),
+          .hold = to_ns(slot.hold),
+          .max_hold = to_ns(slot.max_hold) });
+      };
+      const std::size_t count = slot_count_.load(std::memory_order_acquire);
+      for (std::size_t idx = 0; idx < count; ++idx) { add_slot(slots_[idx]); }
+      add_slot(overflow_);
+    }
+
+  private:
+    // Only the holder of mutex_ writes the slots, so maxima need no compare-exchange either
+    static void raise(std::atomic<std::uint64_t>& mark, std::uint64_t value) noexcept
+    {
+      if (value > mark.load(std::memory_order_relaxed)) { mark.store(value, std::memory_order_relaxed); }
+    }
+
+    // Caller holds mutex_; wait is 0 for an uncontended acquisition
+    void acquired(std::uint64_t now, std::uint64_t wait) noexcept
+    {
+      acquired_at_ = now;
+      holder_ = &slot_for(lock_thread_id(), lock_thread_name);
+      single_writer_add(holder_->acquisitions, 1);
+      if (wait != 0) {
+        single_writer_add(holder_->contended, 1);
+        single_writer_add(holder_->wait, wait);
+        raise(holder_->max_wait, wait);
+      }
+    }
+
+    // Caller holds mutex_. The last slot found is tried first, since a thread usually takes a lock repeatedly.
+    [[nodiscard]] Slot& slot_for(std::uint32_t thread, std::string_view name) noexcept
+    {
+      const std::size_t count = slot_count_.load(std::memory_order_relaxed);
+      const auto matches = [&](const Slot& slot) { return slot.thread == thread && slot.name == name; };
+      if (last_ < count && matches(slots_[last_])) [[likely]] { return slots_[last_]; }
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        if (matches(slots_[idx])) {
+          last_ = idx;
+          return slots_[idx];
+        }
+      }
+      if (count == max_threads) { return overflow_; }
+      slots_[count].thread = thread;
+      slots_[count].name = name;
+      slot_count_.store(count + 1, std::memory_order_release);
+      last_ = count;
+      return slots_[count];
+    }
+
+    std::mutex mutex_;
+    // Guarded by mutex_
+    std::uint64_t acquired_at_ = 0;
+    Slot* holder_ = nullptr;
+    std::size_t last_ = 0;
+    std::array<Slot, max_threads> slots_{};
+    Slot overflow_;
+    std::atomic<std::size_t> slot_count_{ 0 };
+  };
+
+  // The DualQueue and mpsc::Queue mutexes are std::mutex unless LockProfile swaps in a ProfiledMutex, which
+  // needs the general condition variable
+  template<typename Mutex>
+  using condition_variable_for =
+    std::conditional_t<std::is_same_v<Mutex, std::mutex>, std::condition_variable, std::condition_variable_any>;
+
   // =============================================================================
   // MPSC queue - mutex-based for multiple producers
   // =============================================================================
@@ -641,17 +1378,31 @@ namespace detail {
   namespace mpsc {
 
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-    template<typename T, std::size_t Capacity = 4096> class Queue
+    inline constexpr std::size_t default_capacity = 4096;
+
+    template<typename T, std::size_t Capacity = default_capacity, typename Mutex = std::mutex> class Queue
     {
       static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
       static constexpr std::size_t mask_ = Capacity - 1;
 
     public:
       bool push(T event)
+      {
+        std::size_t depth = 0;
+        return push(std::move(event), depth);
+      }
+
+      // depth: events queued after this push, read inside the same critical section
+      bool push(T event, std::size_t& depth)
       {
         {
           std::scoped_lock lock(mutex_);
-          if (tail_ - head_ >= Capacity) [[unlikely]] { return false; }
+          if (tail_ - head_ >= Capacity) [[unlikely]] {
+            EV_PROBE(mpsc_drop, this);
+            return false;
+          }
+          depth = tail_ + 1 - head_;
+          EV_PROBE(mpsc_enqueue, this, tail_, depth);
           buffer_[tail_++ & mask_] = std::move(event);
           has_data_.store(true, std::memory_order_release);
         }
@@ -669,27 +1420,19 @@ namespace detail {
           return nullptr;
         }
         // LCOV_EXCL_STOP
-        current_ = std::move(buffer_[head_++ & mask_]);
-        if (head_ == tail_) { has_data_.store(false, std::memory_order_release); }
-        return &current_;
+        return take_locked();
       }
 
       [[nodiscard]] T* pop_wait_for(std::chrono::milliseconds timeout)
       {
         if (has_data_.load(std::memory_order_acquire)) {
           std::scoped_lock lock(mutex_);
-          if (head_ != tail_) {
-            current_ = std::move(buffer_[head_++ & mask_]);
-            if (head_ == tail_) { has_data_.store(false, std::memory_order_release); }
-            return &current_;
-          }
+          if (head_ != tail_) { return take_locked(); }
         }
         std::unique_lock lock(mutex_);
         if (!cv_.wait_for(lock, timeout, [this] { return head_ != tail_ || stop_; })) { return nullptr; }
         if (stop_ && head_ == tail_) { return nullptr; }
-        current_ = std::move(buffer_[head_++ & mask_]);
-        if (head_ == tail_) { has_data_.store(false, std::memory_order_release); }
-        return &current_;
+        return take_locked();
       }
 
       [[nodiscard]] T* pop_spin()
@@ -702,12 +1445,13 @@ namespace detail {
         // LCOV_EXCL_STOP
         std::scoped_lock lock(mutex_);
         if (head_ == tail_) { return nullptr; }
-        current_ = std::move(buffer_[head_++ & mask_]);
-        if (head_ == tail_) { has_data_.store(false, std::memory_order_release); }
-        return &current_;
+        return take_locked();
       }
 
-      [[nodiscard]] T* pop_wait()
+      // Hooks gets on_park()/on_unpark() around the blocking wait (an observer policy)
+      template<typename Hooks = NullObserver>
+      // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
+      [[nodiscard]] T* pop_wait(Hooks&& hooks = Hooks{})
       {
         constexpr int spin_iterations = 1000;
         // Spin phase - fast path under load
@@ -715,25 +1459,29 @@ namespace detail {
           if (stop_.load(std::memory_order_acquire)) [[unlikely]] { return nullptr; }
           if (has_data_.load(std::memory_order_acquire)) {
             std::scoped_lock lock(mutex_);
-            if (head_ != tail_) {
-              current_ = std::move(buffer_[head_++ & mask_]);
-              if (head_ == tail_) { has_data_.store(false, std::memory_order_release); }
-              return &current_;
-            }
+            if (head_ != tail_) { return take_locked(); }
           }
           cpu_pause();
         }
         // Wait phase - save CPU when idle
         std::unique_lock lock(mutex_);
+        hooks.on_park();
+        EV_PROBE(mpsc_park, this);
         cv_.wait(lock, [this] { return head_ != tail_ || stop_; });
+        EV_PROBE(mpsc_unpark, this);
+        hooks.on_unpark();
         if (stop_ && head_ == tail_) { return nullptr; }
-        current_ = std::move(buffer_[head_++ & mask_]);
-        if (head_ == tail_) { has_data_.store(false, std::memory_order_release); }
-        return &current_;
+        return take_locked();
       }
 
       void notify() { cv_.notify_one(); }
 
+      [[nodiscard]] std::size_t size()
+      {
+        std::scoped_lock lock(mutex_);
+        return tail_ - head_;
+      }
+
       void stop()
       {
         stop_.store(true, std::memory_order_release);
@@ -742,13 +1490,29 @@ namespace detail {
 
       [[nodiscard]] bool is_stopped() const noexcept { return stop_.load(std::memory_order_acquire); }
 
+      // Lock statistics of the queue (ProfiledMutex only)
+      [[nodiscard]] const Mutex& mutex() const noexcept
+        requires(!std::is_same_v<Mutex, std::mutex>)
+      {
+        return mutex_;
+      }
+
     private:
+      // Caller holds mutex_, with head_ != tail_
+      [[nodiscard]] T* take_locked()
+      {
+        EV_PROBE(mpsc_dequeue, this, head_);
+        current_ = std::move(buffer_[head_++ & mask_]);
+        if (head_ == tail_) { has_data_.store(false, std::memory_order_release); }
+        return &current_;
+      }
+
       std::array<T, Capacity> buffer_{};
       T current_{};
       std::size_t head_ = 0;
       std::size_t tail_ = 0;
-      std::mutex mutex_;
-      std::condition_variable cv_;
+      Mutex mutex_;
+      condition_variable_for<Mutex> cv_;
       std::atomic<bool> has_data_{ false };
       std::atomic<bool> stop_{ false };
     };
@@ -756,387 +1520,5002 @@ namespace detail {
   } // namespace mpsc
 
   // =============================================================================
-  // Dual queue: unsynchronized for same-thread, synchronized for cross-thread
-  // Uses ring buffer for fast same-thread access
+  // Eventfd wakeup - pollable replacement for the DualQueue condition variable
   // =============================================================================
 
-  template<typename TaggedEventType> class DualQueue
+  // Placeholder member when the eventfd wakeup is not selected
+  struct NoEventFd
+  {
+  };
+
+  // Milliseconds until deadline for poll/epoll_wait, rounded up so a timed wait never returns early
+  [[nodiscard]] inline int poll_timeout_ms(std::chrono::steady_clock::time_point deadline) noexcept
+  {
+    const auto remaining =
+      std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    return static_cast<int>(std::clamp<decltype(remaining)>(remaining, 0, std::numeric_limits<int>::max()));
+  }
+
+#if EV_HAS_EVENTFD
+  // Owning eventfd handle, readable while a wakeup is pending
+  class EventFd
   {
   public:
-    // Called from same thread (no sync needed)
-    template<typename E> void push_local_event(E&& event)
+    EventFd() : fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
     {
-      auto* slot = local_queue_.alloc_slot();
-      if (slot) [[likely]] {
-        slot->store(std::forward<E>(event));
-        local_queue_.commit_push();
-      }
+      if (fd_ < 0) { throw std::system_error(errno, std::system_category(), "eventfd"); }
     }
 
-    // Called from other threads (synchronized) - wakes up waiting consumer
-    template<typename E> void push_remote_event(E&& event)
+    ~EventFd() { ::close(fd_); }
+
+    EventFd(const EventFd&) = delete;
+    EventFd& operator=(const EventFd&) = delete;
+    EventFd(EventFd&&) = delete;
+    EventFd& operator=(EventFd&&) = delete;
+
+    void notify() const noexcept
     {
-      TaggedEventType tagged(std::forward<E>(event));
-      {
-        std::scoped_lock lock(mutex_);
-        remote_queue_.push(std::move(tagged));
-      }
-      has_remote_.store(true, std::memory_order_release);
-      // Only notify if consumer is actually waiting (not spinning)
-      if (waiting_.load(std::memory_order_acquire)) { cv_.notify_one(); }
+      const std::uint64_t one = 1;
+      std::ignore = ::write(fd_, &one, sizeof(one));
     }
 
-    // Called from same thread only - checks local first, then drains remote
-    [[nodiscard]] TaggedEventType* try_pop()
+    // Reset the counter so the fd stops polling readable
+    void consume() const noexcept
     {
-      // Fast path: check local queue first (no atomic/lock)
-      if (auto* event = local_queue_.try_pop()) { return event; }
-      // Local empty - bulk drain remote queue
-      drain_remote();
-      return local_queue_.try_pop();
+      std::uint64_t value = 0;
+      std::ignore = ::read(fd_, &value, sizeof(value));
     }
 
-    // Pop from local queue only (no remote check) - for batch processing
-    [[nodiscard]] TaggedEventType* try_pop_local() noexcept { return local_queue_.try_pop(); }
-
-    // Block until an event is available (no busy-wait)
-    // 1. Check local queue (no sync)
-    // 2. If empty, drain remote (one lock)
-    // 3. If still empty, wait on CV
-    [[nodiscard]] TaggedEventType* wait_pop_any()
+    // Block until notified or timeout_ms elapses (does not consume)
+    void wait(int timeout_ms = -1) const noexcept
     {
-      // Fast path: check local queue first
-      if (auto* event = local_queue_.try_pop()) { return event; }
+      pollfd pfd{ .fd = fd_, .events = POLLIN, .revents = 0 };
+      while (::poll(&pfd, 1, timeout_ms) < 0 && errno == EINTR) {}
+    }
 
-      // Try draining remote without waiting
-      if (has_remote_.load(std::memory_order_acquire)) {
-        std::scoped_lock lock(mutex_);
-        while (!remote_queue_.empty()) {
-          local_queue_.push(std::move(remote_queue_.front()));
-          remote_queue_.pop();
-        }
-        has_remote_.store(false, std::memory_order_release);
-      }
+    [[nodiscard]] int native_handle() const noexcept { return fd_; }
 
-      // Check local again after drain
-      if (auto* event = local_queue_.try_pop()) { return event; }
+  private:
+    int fd_;
+  };
 
-      // Both empty - wait on CV for remote events
-      {
-        std::unique_lock lock(mutex_);
-        waiting_.store(true, std::memory_order_release);
-        cv_.wait(lock, [this] { return !remote_queue_.empty() || stop_; });
-        waiting_.store(false, std::memory_order_release);
+  // Owning epoll set used by FdSources loops
+  class Epoll
+  {
+  public:
+    // Number of readiness notifications harvested per epoll_wait call
+    static constexpr int max_events = 64;
 
-        if (stop_ && remote_queue_.empty()) { return nullptr; }
+    Epoll() : fd_(::epoll_create1(EPOLL_CLOEXEC))
+    {
+      if (fd_ < 0) { throw std::system_error(errno, std::system_category(), "epoll_create1"); }
+    }
 
-        // Drain while holding lock
-        while (!remote_queue_.empty()) {
-          local_queue_.push(std::move(remote_queue_.front()));
-          remote_queue_.pop();
-        }
-        has_remote_.store(false, std::memory_order_release);
-      }
+    ~Epoll() { ::close(fd_); }
 
-      return local_queue_.try_pop();
-    }
+    Epoll(const Epoll&) = delete;
+    Epoll& operator=(const Epoll&) = delete;
+    Epoll(Epoll&&) = delete;
+    Epoll& operator=(Epoll&&) = delete;
 
-    [[nodiscard]] bool empty()
+    // Add or update a watch; returns false and leaves errno set on failure
+    [[nodiscard]] bool watch(int fd, std::uint32_t events, std::uint64_t data) const noexcept
     {
-      drain_remote();
-      return local_queue_.empty();
+      epoll_event event{ .events = events, .data = { .u64 = data } };
+      if (::epoll_ctl(fd_, EPOLL_CTL_ADD, fd, &event) == 0) { return true; }
+      return errno == EEXIST && ::epoll_ctl(fd_, EPOLL_CTL_MOD, fd, &event) == 0;
     }
 
-    void stop()
+    [[nodiscard]] bool unwatch(int fd) const noexcept { return ::epoll_ctl(fd_, EPOLL_CTL_DEL, fd, nullptr) == 0; }
+
+    // Returns the number of entries written to events (0 on timeout); retries EINTR. Any other failure
+    // returns -1 with errno set - it will not go away on its own, so callers must not just wait again.
+    [[nodiscard]] int wait(std::array<epoll_event, max_events>& events, int timeout_ms) const noexcept
     {
-      {
-        std::scoped_lock lock(mutex_);
-        stop_ = true;
+      while (true) {
+        const int ready = ::epoll_wait(fd_, events.data(), max_events, timeout_ms);
+        if (ready >= 0 || errno != EINTR) { return ready; }
       }
-      cv_.notify_one();
     }
 
+    [[nodiscard]] int native_handle() const noexcept { return fd_; }
+
   private:
-    void drain_remote()
-    {
-      // Fast path: check atomic flag before taking lock
-      if (!has_remote_.load(std::memory_order_acquire)) { return; }
-      std::scoped_lock lock(mutex_);
-      while (!remote_queue_.empty()) {
-        local_queue_.push(std::move(remote_queue_.front()));
-        remote_queue_.pop();
-      }
-      has_remote_.store(false, std::memory_order_release);
-    }
+    int fd_;
+  };
+#endif
 
-    RingBuffer<TaggedEventType> local_queue_; // Same-thread access only
-    std::queue<TaggedEventType> remote_queue_; // Cross-thread, protected by mutex
-    std::mutex mutex_;
-    std::condition_variable cv_;
-    std::atomic<bool> has_remote_{ false };
-    std::atomic<bool> waiting_{ false }; // True when consumer is blocked on CV
-    bool stop_ = false;
+  // Placeholder member when FdSources is not selected
+  struct NoEpoll
+  {
   };
 
   // =============================================================================
-  // Same-thread receiver wrapper
+  // Async I/O building blocks (IoUring loop option)
   // =============================================================================
 
-  template<typename Receiver, typename EventLoopType> class SameThreadWrapper
+  inline constexpr std::size_t io_buffer_alignment = 4096;
+  // Worker threads used when io_uring is unavailable
+  inline constexpr std::size_t io_fallback_threads = 2;
+
+  // Fixed pool of I/O buffers carved from one aligned slab. Loop-thread only.
+  class IoBufferPool
   {
   public:
-    // Use typed dispatcher for per-emitter routing tables
-    using dispatcher_type = SameThreadTypedDispatcher<Receiver, EventLoopType>;
+    static constexpr std::uint32_t npos = ~std::uint32_t{ 0 };
 
-    template<typename... Args>
-    explicit SameThreadWrapper(EventLoopType* event_loop, Args&&... args)
-      : receiver_(std::forward<Args>(args)...), dispatcher_(event_loop)
-    {}
+    IoBufferPool(std::size_t count, std::size_t buffer_size)
+      : buffer_size_(buffer_size), slab_(allocate(count * buffer_size)), free_(count)
+    {
+      for (std::size_t idx = 0; idx < count; ++idx) { free_[idx] = static_cast<std::uint32_t>(count - 1 - idx); }
+      free_count_ = count;
+    }
 
-    ~SameThreadWrapper() = default;
+    [[nodiscard]] std::uint32_t acquire() noexcept
+    {
+      if (free_count_ == 0) [[unlikely]] { return npos; }
+      return free_[--free_count_];
+    }
 
-    SameThreadWrapper(const SameThreadWrapper&) = delete;
-    SameThreadWrapper& operator=(const SameThreadWrapper&) = delete;
-    SameThreadWrapper(SameThreadWrapper&&) noexcept = default;
-    SameThreadWrapper& operator=(SameThreadWrapper&&) noexcept = default;
+    void release(std::uint32_t index) noexcept { free_[free_count_++] = index; }
 
-    // Called by EventLoop to dispatch a queued event
-    template<typename Event>
-      requires can_receive<Receiver, std::decay_t<Event>>
-    void dispatch(Event&& event)
+    [[nodiscard]] std::byte* data(std::uint32_t index) const noexcept
     {
-      receiver_.on_event(std::forward<Event>(event), dispatcher_);
+      return slab_.get() + (static_cast<std::size_t>(index) * buffer_size_);
     }
 
-    // cppcheck-suppress functionStatic ; explicit object parameter functions cannot be static
-    template<typename Self> [[nodiscard]] auto& get(this Self& self) noexcept { return self.receiver_; }
+    [[nodiscard]] std::size_t buffer_size() const noexcept { return buffer_size_; }
+    [[nodiscard]] std::size_t count() const noexcept { return free_.size(); }
+    [[nodiscard]] std::size_t available() const noexcept { return free_count_; }
 
-    // cppcheck-suppress functionStatic ; interface consistency with OwnThreadWrapper
-    void start() noexcept {}
-    // cppcheck-suppress functionStatic ; interface consistency with OwnThreadWrapper
-    void stop() noexcept {}
+    // Never free the slab - for when the kernel may still write into it
+    void leak() noexcept { std::ignore = slab_.release(); }
 
   private:
-    Receiver receiver_;
-    dispatcher_type dispatcher_;
+    struct AlignedDelete
+    {
+      void operator()(std::byte* ptr) const noexcept
+      {
+        ::operator delete[](ptr, std::align_val_t{ io_buffer_alignment });
+      }
+    };
+
+    static std::unique_ptr<std::byte[], AlignedDelete> allocate(std::size_t bytes)
+    {
+      return std::unique_ptr<std::byte[], AlignedDelete>(
+        static_cast<std::byte*>(::operator new[](bytes, std::align_val_t{ io_buffer_alignment })));
+    }
+
+    std::size_t buffer_size_;
+    std::unique_ptr<std::byte[], AlignedDelete> slab_;
+    std::vector<std::uint32_t> free_;
+    std::size_t free_count_ = 0;
   };
 
-  // =============================================================================
-  // Own-thread receiver wrapper
-  // =============================================================================
+  // One queued read or write, as handed to a backend
+  struct IoRequest
+  {
+    std::uint32_t slot;
+    bool is_write;
+    int fd;
+    std::uint64_t offset;
+    std::byte* data;
+    std::uint32_t length;
+    std::uint32_t buffer;
+  };
 
-  template<typename Receiver, typename EventLoopType> class OwnThreadWrapper
+#if EV_HAS_IO_URING
+  // Minimal raw io_uring: one SQ/CQ pair driven with io_uring_enter, no SQPOLL
+  class IoUringRing
   {
   public:
-    using receives_list = get_receives_t<Receiver>;
-    using tagged_event = to_tagged_event_t<receives_list>;
+    // entries == 0 leaves the ring unset (valid() is false)
+    explicit IoUringRing(unsigned entries)
+    {
+      if (entries == 0) { return; }
+      io_uring_params params{};
+      fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+      if (fd_ < 0) { return; }
+      if (!map_rings(params)) {
+        unmap();
+        ::close(fd_);
+        fd_ = -1;
+      }
+    }
 
-    // Automatically select queue type based on producer count
-    // SPSC is safe when at most 1 producer thread, otherwise need MPSC
-    static constexpr std::size_t producer_count = EventLoopType::template producer_count_for<Receiver>;
-    using queue_type = std::conditional_t<(producer_count < 2), spsc::Queue<tagged_event>, mpsc::Queue<tagged_event>>;
+    ~IoUringRing()
+    {
+      if (fd_ < 0) { return; }
+      unmap();
+      ::close(fd_);
+    }
 
-    using dispatcher_type = OwnThreadTypedDispatcher<Receiver, EventLoopType>;
+    IoUringRing(const IoUringRing&) = delete;
+    IoUringRing& operator=(const IoUringRing&) = delete;
+    IoUringRing(IoUringRing&&) = delete;
+    IoUringRing& operator=(IoUringRing&&) = delete;
 
-    template<typename... Args>
-    explicit OwnThreadWrapper(EventLoopType* event_loop, Args&&... args)
-      : receiver_(std::forward<Args>(args)...), ev_(event_loop)
-    {}
+    [[nodiscard]] bool valid() const noexcept { return fd_ >= 0; }
+    [[nodiscard]] int native_handle() const noexcept { return fd_; }
 
-    ~OwnThreadWrapper() { stop(); }
+    // Pin the pool with IORING_REGISTER_BUFFERS so requests can use the *_FIXED opcodes
+    bool register_buffers(const IoBufferPool& pool) noexcept
+    {
+      // UIO_MAXIOV caps a single registration on older kernels
+      constexpr std::size_t max_registered = 1024;
+      if (pool.count() > max_registered) { return false; }
+      std::vector<iovec> iovecs(pool.count());
+      for (std::size_t idx = 0; idx < iovecs.size(); ++idx) {
+        iovecs[idx] = iovec{ .iov_base = pool.data(static_cast<std::uint32_t>(idx)), .iov_len = pool.buffer_size() };
+      }
+      fixed_buffers_ = ::syscall(__NR_io_uring_register,
+                         fd_,
+                         IORING_REGISTER_BUFFERS,
+                         iovecs.data(),
+                         static_cast<unsigned>(iovecs.size()))
+                       == 0;
+      return fixed_buffers_;
+    }
 
-    OwnThreadWrapper(const OwnThreadWrapper&) = delete;
-    OwnThreadWrapper& operator=(const OwnThreadWrapper&) = delete;
-    OwnThreadWrapper(OwnThreadWrapper&&) = delete;
-    OwnThreadWrapper& operator=(OwnThreadWrapper&&) = delete;
+    // Stage a request in the SQ; returns false when the ring is full
+    [[nodiscard]] bool push(const IoRequest& request) noexcept
+    {
+      io_uring_sqe* sqe = next_sqe();
+      if (sqe == nullptr) [[unlikely]] { return false; }
+      if (fixed_buffers_) {
+        sqe->opcode = request.is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe->buf_index = static_cast<std::uint16_t>(request.buffer);
+      } else {
+        sqe->opcode = request.is_write ? IORING_OP_WRITE : IORING_OP_READ;
+      }
+      sqe->fd = request.fd;
+      sqe->off = request.offset;
+      sqe->addr = reinterpret_cast<std::uintptr_t>(request.data); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+      sqe->len = request.length;
+      sqe->user_data = request.slot;
+      return true;
+    }
 
-    void start()
+    // Stage an IORING_OP_ASYNC_CANCEL for the request in slot; returns false when the ring is full.
+    // The cancel's own completion is consumed here and never reaches reap().
+    [[nodiscard]] bool cancel(std::uint32_t slot) noexcept
     {
-      if (running_.exchange(true)) { return; }
-      thread_ = std::thread([this] { run_loop(); });
+      io_uring_sqe* sqe = next_sqe();
+      if (sqe == nullptr) [[unlikely]] { return false; }
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->addr = slot;
+      sqe->user_data = cancel_tag;
+      return true;
     }
 
-    void stop()
+    // Block until at least one completion is available; false (errno set) if the kernel refuses
+    [[nodiscard]] bool wait() const noexcept
     {
-      if (!running_.exchange(false)) { return; }
-      queue_.stop();
-      if (thread_.joinable()) { thread_.join(); }
+      while (true) {
+        if (::syscall(__NR_io_uring_enter, fd_, 0U, 1U, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0) { return true; }
+        if (errno != EINTR) { return false; }
+      }
     }
 
-    // Push from any thread (synchronized)
-    template<typename Event>
-      requires can_receive<Receiver, Event>
-    void push(Event&& event)
+    // Give up on the ring without unmapping or closing it, so the kernel keeps it - and the requests
+    // still running on it - alive until the process exits
+    void leak() noexcept { fd_ = -1; }
+
+    // Publish staged SQEs and submit them, normally with a single io_uring_enter. The kernel may take only
+    // some of them: the rest are submitted again. While it is busy (EAGAIN, or EBUSY with the CQ backed up),
+    // completions are reaped into complete(slot, result) to make room. After a hard error, or if it stays
+    // busy, the SQEs it did not take are withdrawn and completed with -errno.
+    template<typename Complete> void submit(Complete&& complete)
     {
-      queue_.push(tagged_event(std::forward<Event>(event)));
-      queue_.notify(); // Wake up consumer
+      constexpr int max_busy_retries = 64;
+      std::atomic_ref(*sq_tail_ptr_).store(sq_tail_, std::memory_order_release);
+      int busy_retries = 0;
+      while (true) {
+        const unsigned pending = sq_tail_ - std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+        if (pending == 0) { return; }
+        const long submitted = ::syscall(__NR_io_uring_enter, fd_, pending, 0U, 0U, nullptr, 0);
+        if (submitted > 0) {
+          busy_retries = 0;
+          continue;
+        }
+        const int error = submitted < 0 ? errno : EAGAIN;
+        if (error == EINTR) { continue; }
+        if ((error == EAGAIN || error == EBUSY) && busy_retries++ < max_busy_retries) {
+          if (reap(complete) == 0) { std::this_thread::yield(); }
+          continue;
+        }
+        withdraw(error, complete);
+        return;
+      }
     }
 
-    // cppcheck-suppress functionStatic ; explicit object parameter functions cannot be static
-    template<typename Self> [[nodiscard]] auto& get(this Self& self) noexcept { return self.receiver_; }
+    // Invoke func(slot, result) for every available completion
+    template<typename Func> std::size_t reap(Func&& func)
+    {
+      unsigned head = *cq_head_;
+      const unsigned tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+      std::size_t reaped = 0;
+      for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        if (cqe.user_data == cancel_tag) { continue; }
+        func(static_cast<std::uint32_t>(cqe.user_data), cqe.res);
+        ++reaped;
+      }
+      std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+      return reaped;
+    }
 
   private:
-    void run_loop()
+    // user_data of cancel SQEs; request slots are 32-bit, so it never names one
+    static constexpr std::uint64_t cancel_tag = ~std::uint64_t{ 0 };
+
+    // The kernel only reads SQEs inside io_uring_enter, so the ones it has not taken can be handed back
+    template<typename Complete> void withdraw(int error, Complete& complete)
     {
-      dispatcher_type dispatcher(ev_);
-      while (running_.load(std::memory_order_relaxed)) {
-        auto* result = queue_.pop_wait();
-        if (result) {
-          fast_dispatch(
-            *result, [this, &dispatcher](auto& event) { receiver_.on_event(std::move(event), dispatcher); });
-        }
+      const unsigned head = std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+      const unsigned tail = std::exchange(sq_tail_, head);
+      std::atomic_ref(*sq_tail_ptr_).store(sq_tail_, std::memory_order_release);
+      for (unsigned idx = head; idx != tail; ++idx) {
+        const std::uint64_t user_data = sqes_[idx & sq_mask_].user_data;
+        if (user_data != cancel_tag) { complete(static_cast<std::uint32_t>(user_data), -error); }
       }
     }
 
-    Receiver receiver_;
-    EventLoopType* ev_;
-    std::thread thread_;
-    std::atomic<bool> running_{ false };
-    queue_type queue_;
-  };
+    // Zeroed SQE at the local tail, or nullptr when the SQ is full
+    [[nodiscard]] io_uring_sqe* next_sqe() noexcept
+    {
+      const unsigned head = std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+      if (sq_tail_ - head >= sq_entries_) [[unlikely]] { return nullptr; }
+      io_uring_sqe* sqe = &sqes_[sq_tail_++ & sq_mask_];
+      std::memset(sqe, 0, sizeof(*sqe));
+      return sqe;
+    }
 
-  // =============================================================================
-  // Empty wrapper for external emitters (no storage needed, just type marker)
-  // =============================================================================
+    template<typename T> static T* at(void* base, std::uint32_t offset) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return reinterpret_cast<T*>(static_cast<std::byte*>(base) + offset);
+    }
 
-  template<typename Emitter, typename EventLoopType> class ExternalEmitterWrapper
-  {
-  public:
-    explicit ExternalEmitterWrapper(EventLoopType* /*loop*/) noexcept {}
-  };
+    bool map_rings(const io_uring_params& params) noexcept
+    {
+      sq_ring_size_ = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+      cq_ring_size_ = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+      const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (single_mmap) { sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_); }
+
+      sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+      if (sq_ring_ == nullptr) { return false; }
+      cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+      if (cq_ring_ == nullptr) { return false; }
+      sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+      sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+      if (sqes_ == nullptr) { return false; }
+
+      sq_head_ = at<unsigned>(sq_ring_, params.sq_off.head);
+      sq_tail_ptr_ = at<unsigned>(sq_ring_, params.sq_off.tail);
+      sq_mask_ = *at<unsigned>(sq_ring_, params.sq_off.ring_mask);
+      sq_entries_ = *at<unsigned>(sq_ring_, params.sq_off.ring_entries);
+      auto* sq_array = at<unsigned>(sq_ring_, params.sq_off.array);
+      for (unsigned idx = 0; idx < sq_entries_; ++idx) { sq_array[idx] = idx; }
+      sq_tail_ = *sq_tail_ptr_;
+
+      cq_head_ = at<unsigned>(cq_ring_, params.cq_off.head);
+      cq_tail_ = at<unsigned>(cq_ring_, params.cq_off.tail);
+      cq_mask_ = *at<unsigned>(cq_ring_, params.cq_off.ring_mask);
+      cqes_ = at<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+      return true;
+    }
 
-  // =============================================================================
-  // Wrapper type selector (avoids instantiating wrong branch)
-  // =============================================================================
+    [[nodiscard]] void* map(std::size_t size, std::uint64_t offset) const noexcept
+    {
+      void* ptr = ::mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, static_cast<off_t>(offset));
+      return ptr == MAP_FAILED ? nullptr : ptr; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    }
 
-  template<typename T, typename EventLoopType, bool IsReceiver = is_receiver<T>> struct wrapper_selector;
+    void unmap() noexcept
+    {
+      if (sqes_ != nullptr) { ::munmap(sqes_, sqes_size_); }
+      if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) { ::munmap(cq_ring_, cq_ring_size_); }
+      if (sq_ring_ != nullptr) { ::munmap(sq_ring_, sq_ring_size_); }
+    }
 
-  // Receiver case: select based on thread mode
-  template<typename Receiver, typename EventLoopType> struct wrapper_selector<Receiver, EventLoopType, true>
-  {
-    using type = std::conditional_t<is_own_thread_v<Receiver>,
-      OwnThreadWrapper<Receiver, EventLoopType>,
-      SameThreadWrapper<Receiver, EventLoopType>>;
+    int fd_ = -1;
+    bool fixed_buffers_ = false;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sq_ring_size_ = 0;
+    std::size_t cq_ring_size_ = 0;
+    std::size_t sqes_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ptr_ = nullptr;
+    unsigned sq_tail_ = 0; // Local tail, published on submit()
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
   };
+#endif
 
-  // External emitter case: use empty wrapper
-  template<typename Emitter, typename EventLoopType> struct wrapper_selector<Emitter, EventLoopType, false>
+#if EV_HAS_EVENTFD
+  // Thread-pool emulation of the io_uring submit/complete protocol.
+  // Requests are staged on the loop thread and handed over in one batch per flush;
+  // workers run blocking pread/pwrite and signal completions through an eventfd.
+  template<std::size_t Capacity> class IoThreadPool
   {
-    using type = ExternalEmitterWrapper<Emitter, EventLoopType>;
-  };
+  public:
+    explicit IoThreadPool(std::size_t threads)
+    {
+      workers_.reserve(threads);
+      for (std::size_t idx = 0; idx < threads; ++idx) {
+        workers_.emplace_back([this] { run_worker(); });
+      }
+    }
 
-  template<typename T, typename EventLoopType> using wrapper_for = typename wrapper_selector<T, EventLoopType>::type;
+    ~IoThreadPool()
+    {
+      {
+        std::scoped_lock lock(mutex_);
+        stop_ = true;
+      }
+      cv_.notify_all();
+      for (auto& worker : workers_) { worker.join(); }
+    }
+
+    IoThreadPool(const IoThreadPool&) = delete;
+    IoThreadPool& operator=(const IoThreadPool&) = delete;
+    IoThreadPool(IoThreadPool&&) = delete;
+    IoThreadPool& operator=(IoThreadPool&&) = delete;
+
+    // Capacity matches the in-flight slot count, so staging cannot overflow
+    void push(const IoRequest& request) noexcept { std::ignore = staged_.push(IoRequest{ request }); }
+
+    void submit()
+    {
+      if (staged_.empty()) { return; }
+      {
+        std::scoped_lock lock(mutex_);
+        while (auto* request = staged_.try_pop()) { std::ignore = pending_.push(std::move(*request)); }
+      }
+      cv_.notify_all();
+    }
+
+    // Invoke func(slot, result) for every finished request
+    template<typename Func> std::size_t reap(Func&& func)
+    {
+      completed_.consume();
+      {
+        std::scoped_lock lock(mutex_);
+        reaped_count_ = done_count_;
+        std::copy_n(done_.begin(), done_count_, reaped_.begin());
+        done_count_ = 0;
+      }
+      for (std::size_t idx = 0; idx < reaped_count_; ++idx) { func(reaped_[idx].first, reaped_[idx].second); }
+      return reaped_count_;
+    }
+
+    [[nodiscard]] int native_handle() const noexcept { return completed_.native_handle(); }
+
+  private:
+    void run_worker()
+    {
+      while (true) {
+        IoRequest request{};
+        {
+          std::unique_lock lock(mutex_);
+          cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+          if (stop_) { return; }
+          const IoRequest* next = pending_.try_pop();
+          if (next == nullptr) { continue; }
+          request = *next;
+        }
+        const int result = execute(request);
+        {
+          std::scoped_lock lock(mutex_);
+          done_[done_count_++] = { request.slot, result };
+        }
+        completed_.notify();
+      }
+    }
+
+    static int execute(const IoRequest& request) noexcept
+    {
+      ssize_t result = 0;
+      do {
+        result = request.is_write
+                   ? ::pwrite(request.fd, request.data, request.length, static_cast<off_t>(request.offset))
+                   : ::pread(request.fd, request.data, request.length, static_cast<off_t>(request.offset));
+      } while (result < 0 && errno == EINTR);
+      return result < 0 ? -errno : static_cast<int>(result);
+    }
+
+    RingBuffer<IoRequest, Capacity> staged_; // Loop thread only
+    RingBuffer<IoRequest, Capacity> pending_; // Protected by mutex_
+    std::array<std::pair<std::uint32_t, int>, Capacity> done_{}; // Protected by mutex_
+    std::size_t done_count_ = 0;
+    std::array<std::pair<std::uint32_t, int>, Capacity> reaped_{}; // Loop thread only
+    std::size_t reaped_count_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    EventFd completed_;
+    std::vector<std::thread> workers_;
+  };
+#endif
 
   // =============================================================================
-  // Receiver storage - handles non-movable wrappers via unique_ptr
+  // Trace rings - per-thread SPSC record buffers, drained by the active TraceSession
   // =============================================================================
 
-  template<typename Receiver, typename EventLoopType> class ReceiverStorage
+  enum class TraceKind : std::uint8_t { enqueue, dispatch_begin, dispatch_end, park, unpark };
+
+  struct TraceLabel
+  {
+    std::string_view owner;
+    std::string_view event;
+  };
+
+  template<typename Owner, typename Event>
+  inline constexpr TraceLabel trace_label{ type_name<Owner>(), type_name<Event>() };
+
+  // 32 bytes: labels live in static storage, so records carry no strings
+  struct TraceRecord
+  {
+    std::uint64_t tick = 0;
+    std::uint64_t flow = 0; // links an enqueue to its dispatch; 0 = no flow
+    const TraceLabel* label = nullptr;
+    TraceKind kind = TraceKind::enqueue;
+    QueueKind queue = QueueKind::local;
+  };
+
+  // Written by one thread, read by the session writer. Fields below the ring are writer-only.
+  // MSVC C4324: structure was padded due to alignment specifier (intentional for cache line separation)
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324)
+#endif
+  class TraceRing
   {
   public:
-    using wrapper_type = wrapper_for<Receiver, EventLoopType>;
+    static constexpr std::size_t capacity = 16384;
+    static_assert((capacity & (capacity - 1)) == 0, "Capacity must be power of 2");
 
-    template<typename... Args>
-    explicit ReceiverStorage(EventLoopType* loop, Args&&... args)
-      : wrapper_(std::make_unique<wrapper_type>(loop, std::forward<Args>(args)...))
-    {}
+    explicit TraceRing(std::uint32_t index) noexcept : index_(index) {}
 
-    ~ReceiverStorage() = default;
+    [[nodiscard]] std::uint32_t index() const noexcept { return index_; }
 
-    ReceiverStorage(const ReceiverStorage&) = delete;
-    ReceiverStorage& operator=(const ReceiverStorage&) = delete;
-    ReceiverStorage(ReceiverStorage&&) noexcept = default;
-    ReceiverStorage& operator=(ReceiverStorage&&) noexcept = default;
+    // Producer side - full rings drop the record and count it
+    void push(const TraceRecord& record) noexcept
+    {
+      const std::size_t tail = tail_.load(std::memory_order_relaxed);
+      if (tail - head_.load(std::memory_order_acquire) >= capacity) [[unlikely]] {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+      }
+      records_[tail & mask_] = record;
+      tail_.store(tail + 1, std::memory_order_release);
+    }
 
-    template<typename Self> auto& operator*(this Self& self) noexcept { return *self.wrapper_; }
-    template<typename Self> auto* operator->(this Self& self) noexcept { return self.wrapper_.get(); }
+    // Unique across threads: ring index in the high bits. Stays below 2^53 so JSON readers keep it exact.
+    [[nodiscard]] std::uint64_t next_flow() noexcept
+    {
+      constexpr unsigned index_shift = 40;
+      return (std::uint64_t{ index_ } << index_shift) | ++flow_counter_;
+    }
+
+    // Consumer side
+    template<typename Func> void drain(Func&& func)
+    {
+      const std::size_t head = head_.load(std::memory_order_relaxed);
+      const std::size_t tail = tail_.load(std::memory_order_acquire);
+      for (std::size_t pos = head; pos != tail; ++pos) { func(records_[pos & mask_]); }
+      head_.store(tail, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+      return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    // Writer state of the current session: open dispatch slices, pending park, drops already reported
+    std::vector<TraceRecord> open;
+    std::optional<std::uint64_t> parked_at;
+    std::uint64_t dropped_seen = 0;
+    bool announced = false;
+    std::string name; // guarded by the registry mutex
 
   private:
-    std::unique_ptr<wrapper_type> wrapper_;
+    static constexpr std::size_t mask_ = capacity - 1;
+
+    std::uint32_t index_;
+    std::uint64_t flow_counter_ = 0;
+    alignas(cache_line_size) std::array<TraceRecord, capacity> records_{};
+    alignas(cache_line_size) std::atomic<std::size_t> head_{ 0 };
+    alignas(cache_line_size) std::atomic<std::size_t> tail_{ 0 };
+    std::atomic<std::uint64_t> dropped_{ 0 };
   };
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
 
-  // =============================================================================
-  // Collect all event types that same-thread receivers handle
-  // =============================================================================
+  // Process-wide: one session at a time collects the rings of every thread
+  struct TraceRegistry
+  {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    std::uint32_t next_index = 1;
+    bool session = false;
+    std::atomic<bool> active{ false };
+  };
 
-  // Helper to get events from a single same-thread receiver (or empty list)
-  template<typename R>
-  using same_thread_events_from =
-    std::conditional_t<is_receiver<R> && is_same_thread_v<R>, get_receives_t<R>, type_list<>>;
+  inline TraceRegistry trace_registry;
 
-  // Operator for fold-based concatenation
-  template<typename... Ls, typename... Rs>
-  consteval auto operator+(type_list<Ls...> /*unused*/, type_list<Rs...> /*unused*/) -> type_list<Ls..., Rs...>
+  // This thread's ring, created on first use; nullptr if it could not be allocated
+  [[nodiscard]] inline TraceRing* trace_ring() noexcept
   {
-    return {};
+    thread_local const std::shared_ptr<TraceRing> ring = []() noexcept -> std::shared_ptr<TraceRing> {
+      try {
+        const std::scoped_lock lock(trace_registry.mutex);
+        auto created = std::make_shared<TraceRing>(trace_registry.next_index++);
+        trace_registry.rings.push_back(created);
+        return created;
+      } catch (...) {
+        return nullptr;
+      }
+    }();
+    return ring.get();
   }
 
-  // Helper function for MSVC - fold in function body lets compiler deduce type
-  template<typename... Lists> consteval auto concat_type_lists_fn() { return (type_list<>{} + ... + Lists{}); }
+  [[nodiscard]] inline bool trace_active() noexcept { return trace_registry.active.load(std::memory_order_relaxed); }
 
-  // Concatenate multiple type_lists using fold expression (O(1) instantiation depth)
-  template<typename... Lists> struct concat_type_lists
+  // Names the calling thread's track in the trace
+  inline void trace_thread_name(std::string_view name)
   {
-    using type = decltype(concat_type_lists_fn<Lists...>());
+    auto* ring = trace_ring();
+    if (ring == nullptr) { return; }
+    const std::scoped_lock lock(trace_registry.mutex);
+    ring->name = name;
+  }
+
+  // Records an enqueue stamped at tick and returns the flow id its dispatch will reference
+  template<typename Owner, typename Event>
+  [[nodiscard]] std::uint64_t trace_enqueue(QueueKind queue, std::uint64_t tick) noexcept
+  {
+    if (!trace_active()) { return 0; }
+    auto* ring = trace_ring();
+    if (ring == nullptr) { return 0; }
+    const std::uint64_t flow = ring->next_flow();
+    ring->push(TraceRecord{ tick, flow, &trace_label<Owner, Event>, TraceKind::enqueue, queue });
+    return flow;
+  }
+
+  template<typename Receiver, typename Event> void trace_dispatch(TraceKind kind, std::uint64_t flow) noexcept
+  {
+    if (!trace_active()) { return; }
+    if (auto* ring = trace_ring()) {
+      ring->push(TraceRecord{ TickClock::now(), flow, &trace_label<Receiver, Event>, kind, QueueKind::local });
+    }
+  }
+
+  inline void trace_park(TraceKind kind) noexcept
+  {
+    if (!trace_active()) { return; }
+    if (auto* ring = trace_ring()) { ring->push(TraceRecord{ TickClock::now(), 0, nullptr, kind, QueueKind::local }); }
+  }
+
+  // =============================================================================
+  // Flight recorder - the last dispatches of every thread, dumped on crash or on demand
+  // =============================================================================
+
+#if EV_HAS_EVENTFD
+  // One per thread, claimed on the thread's first dispatch and handed to a later thread once it exits.
+  // Written with relaxed stores by its thread only; the dump reads whatever is there.
+  class alignas(cache_line_size) FlightBuffer
+  {
+  public:
+    static constexpr std::size_t depth = 256;
+    static_assert((depth & (depth - 1)) == 0, "Depth must be power of 2");
+    static constexpr std::size_t max_name = 47;
+
+    void begin(const TraceLabel* label, std::uint64_t tick) noexcept
+    {
+      const std::uint64_t seq = next_.load(std::memory_order_relaxed);
+      auto& entry = entries_[seq & mask_];
+      entry.tick.store(tick, std::memory_order_relaxed);
+      entry.label.store(label, std::memory_order_relaxed);
+      next_.store(seq + 1, std::memory_order_release);
+      running_.store(true, std::memory_order_relaxed);
+    }
+
+    void end() noexcept { running_.store(false, std::memory_order_relaxed); }
+
+    // Called by a thread that has no buffer yet
+    [[nodiscard]] bool try_claim() noexcept
+    {
+      bool expected = false;
+      if (!in_use_.compare_exchange_strong(expected, true, std::memory_order_acquire)) { return false; }
+      next_.store(0, std::memory_order_relaxed);
+      running_.store(false, std::memory_order_relaxed);
+      name_size_.store(0, std::memory_order_relaxed);
+      tid_.store(static_cast<int>(::syscall(SYS_gettid)), std::memory_order_relaxed);
+      return true;
+    }
+
+    void release() noexcept
+    {
+      running_.store(false, std::memory_order_relaxed);
+      in_use_.store(false, std::memory_order_release);
+    }
+
+    void set_name(std::string_view name) noexcept
+    {
+      const std::size_t size = std::min(name.size(), max_name);
+      for (std::size_t idx = 0; idx < size; ++idx) { name_[idx].store(name[idx], std::memory_order_relaxed); }
+      name_size_.store(size, std::memory_order_release);
+    }
+
+    // Async-signal-safe: plain loads and write(2) into a stack buffer
+    template<typename Writer> void dump(Writer& out, std::uint64_t now, double ns_per_tick) const noexcept
+    {
+      const std::uint64_t next = next_.load(std::memory_order_acquire);
+      const std::uint64_t first = next > depth ? next - depth : 0;
+      out.append("thread ");
+      out.append_number(static_cast<std::uint64_t>(tid_.load(std::memory_order_relaxed)));
+      const std::size_t name_size = name_size_.load(std::memory_order_acquire);
+      if (name_size > 0) {
+        out.append(" ");
+        for (std::size_t idx = 0; idx < name_size; ++idx) {
+          out.append_char(name_[idx].load(std::memory_order_relaxed));
+        }
+      }
+      if (!in_use_.load(std::memory_order_relaxed)) { out.append(" (exited)"); }
+      out.append(": ");
+      out.append_number(next);
+      out.append(" dispatches\n");
+      const bool running = running_.load(std::memory_order_relaxed);
+      for (std::uint64_t seq = first; seq < next; ++seq) {
+        const auto& entry = entries_[seq & mask_];
+        const TraceLabel* label = entry.label.load(std::memory_order_relaxed);
+        if (label == nullptr) { continue; }
+        const std::uint64_t tick = entry.tick.load(std::memory_order_relaxed);
+        out.append("  ");
+        out.append_age(now > tick ? now - tick : 0, ns_per_tick);
+        out.append(" ago  ");
+        out.append(label->owner);
+        out.append(" <- ");
+        out.append(label->event);
+        if (running && seq + 1 == next) { out.append("  [running]"); }
+        out.append("\n");
+      }
+    }
+
+    std::atomic<FlightBuffer*> next_buffer{ nullptr }; // registry list link, set once
+
+  private:
+    static constexpr std::size_t mask_ = depth - 1;
+
+    struct Entry
+    {
+      std::atomic<std::uint64_t> tick{ 0 };
+      std::atomic<const TraceLabel*> label{ nullptr };
+    };
+
+    std::array<Entry, depth> entries_{};
+    std::atomic<std::uint64_t> next_{ 0 };
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> in_use_{ false };
+    std::atomic<int> tid_{ 0 };
+    std::atomic<std::size_t> name_size_{ 0 };
+    std::array<std::atomic<char>, max_name> name_{};
   };
 
-  template<> struct concat_type_lists<>
+  // Fixed-size stack buffer flushed with write(2) - usable inside a signal handler
+  class FlightWriter
   {
-    using type = type_list<>;
+  public:
+    explicit FlightWriter(int fd) noexcept : fd_(fd) {}
+
+    FlightWriter(const FlightWriter&) = delete;
+    FlightWriter& operator=(const FlightWriter&) = delete;
+    FlightWriter(FlightWriter&&) = delete;
+    FlightWriter& operator=(FlightWriter&&) = delete;
+    ~FlightWriter() = default;
+
+    void append(std::string_view text) noexcept
+    {
+      for (const char chr : text) { append_char(chr); }
+    }
+
+    void append_char(char chr) noexcept
+    {
+      if (used_ == buffer_.size()) { std::ignore = flush(); }
+      buffer_[used_++] = chr;
+    }
+
+    void append_number(std::uint64_t value) noexcept
+    {
+      constexpr std::uint64_t base = 10;
+      std::array<char, 20> digits{}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+      std::size_t count = 0;
+      do {
+        digits[count++] = static_cast<char>('0' + (value % base));
+        value /= base;
+      } while (value != 0);
+      while (count > 0) { append_char(digits[--count]); }
+    }
+
+    // Nanoseconds when the tick rate is known, raw ticks before calibration
+    void append_age(std::uint64_t ticks, double ns_per_tick) noexcept
+    {
+      if (ns_per_tick <= 0.0) {
+        append_number(ticks);
+        append(" ticks");
+        return;
+      }
+      append_number(static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick));
+      append(" ns");
+    }
+
+    [[nodiscard]] bool flush() noexcept
+    {
+      std::size_t written = 0;
+      while (written < used_) {
+        const ::ssize_t result = ::write(fd_, buffer_.data() + written, used_ - written);
+        if (result < 0 && errno == EINTR) { continue; }
+        if (result <= 0) {
+          failed_ = true;
+          break;
+        }
+        written += static_cast<std::size_t>(result);
+      }
+      used_ = 0;
+      return !failed_;
+    }
+
+  private:
+    int fd_;
+    std::size_t used_ = 0;
+    bool failed_ = false;
+    std::array<char, 512> buffer_{}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
   };
 
+  // Append-only list of every buffer ever allocated; the signal handler walks it without locks
+  inline std::atomic<FlightBuffer*> flight_buffers{ nullptr };
 
-  // Collect all same-thread events - just concatenate without deduplication
-  // Assumes event types are unique across receivers (common case)
-  // For cases with duplicates, TaggedEvent handles it correctly (same type appears multiple times)
-  template<typename... Receivers>
-  using collect_same_thread_events_t = typename concat_type_lists<same_thread_events_from<Receivers>...>::type;
+  [[nodiscard]] inline FlightBuffer* claim_flight_buffer() noexcept
+  {
+    // Hands the buffer back when the thread exits
+    struct Lease
+    {
+      FlightBuffer* buffer = nullptr;
+      Lease() = default;
+      Lease(const Lease&) = delete;
+      Lease& operator=(const Lease&) = delete;
+      Lease(Lease&&) = delete;
+      Lease& operator=(Lease&&) = delete;
+      ~Lease()
+      {
+        if (buffer != nullptr) { buffer->release(); }
+      }
+    };
+    thread_local Lease lease;
 
-  // Helper to get events received by a single OwnThread receiver (or empty list)
-  template<typename R>
-  using own_thread_events_from =
-    std::conditional_t<is_receiver<R> && is_own_thread_v<R>, get_receives_t<R>, type_list<>>;
+    for (auto* buffer = flight_buffers.load(std::memory_order_acquire); buffer != nullptr;
+      buffer = buffer->next_buffer.load(std::memory_order_acquire)) {
+      if (buffer->try_claim()) {
+        lease.buffer = buffer;
+        return buffer;
+      }
+    }
+    auto* created = new (std::nothrow) FlightBuffer(); // NOLINT(cppcoreguidelines-owning-memory) - never freed
+    if (created == nullptr) { return nullptr; }
+    std::ignore = created->try_claim();
+    auto* head = flight_buffers.load(std::memory_order_relaxed);
+    do { created->next_buffer.store(head, std::memory_order_relaxed); } while (
+      !flight_buffers.compare_exchange_weak(head, created, std::memory_order_release, std::memory_order_relaxed));
+    lease.buffer = created;
+    return created;
+  }
 
-  // Collect all events received by OwnThread receivers
-  template<typename... Receivers>
-  using collect_own_thread_events_t = typename concat_type_lists<own_thread_events_from<Receivers>...>::type;
+  [[nodiscard]] inline FlightBuffer* flight_buffer() noexcept
+  {
+    thread_local FlightBuffer* buffer = nullptr;
+    if (buffer == nullptr) [[unlikely]] { buffer = claim_flight_buffer(); }
+    return buffer;
+  }
 
-  // Helper to get events emitted by a single OwnThread receiver (or empty list)
-  template<typename R>
-  using ot_emitted_events_from = std::conditional_t<is_own_thread_v<R>, get_emits_t<R>, type_list<>>;
+  template<typename Receiver, typename Event> void flight_begin() noexcept
+  {
+    if (auto* buffer = flight_buffer()) [[likely]] { buffer->begin(&trace_label<Receiver, Event>, TickClock::now()); }
+  }
 
-  // Collect all events emitted by OwnThread receivers (ECS-style precomputation)
-  template<typename... Receivers>
-  using collect_ot_emitted_events_t = typename concat_type_lists<ot_emitted_events_from<Receivers>...>::type;
+  inline void flight_end() noexcept
+  {
+    if (auto* buffer = flight_buffer()) [[likely]] { buffer->end(); }
+  }
 
-  // Helper to get events emitted by external emitters (or empty list)
-  template<typename R>
-  using ext_emitted_events_from = std::conditional_t<is_external_emitter<R>, get_emits_t<R>, type_list<>>;
+  inline void flight_thread_name(std::string_view name) noexcept
+  {
+    if (auto* buffer = flight_buffer()) { buffer->set_name(name); }
+  }
 
-  // Collect all events emitted by external emitters
-  template<typename... Receivers>
-  using collect_ext_emitted_events_t = typename concat_type_lists<ext_emitted_events_from<Receivers>...>::type;
+  // Async-signal-safe
+  inline bool dump_flight_buffers(int fd) noexcept
+  {
+    FlightWriter out(fd);
+    const std::uint64_t now = TickClock::now();
+    const double ns_per_tick = TickClock::known_ns_per_tick();
+    out.append("=== ev_loop flight recorder ===\n");
+    for (const auto* buffer = flight_buffers.load(std::memory_order_acquire); buffer != nullptr;
+      buffer = buffer->next_buffer.load(std::memory_order_acquire)) {
+      buffer->dump(out, now, ns_per_tick);
+    }
+    return out.flush();
+  }
+
+  inline constexpr std::array<int, 2> flight_signals{ SIGSEGV, SIGABRT };
+  // Dispositions replaced by the flight recorder, restored before the signal is re-raised
+  inline std::array<struct sigaction, flight_signals.size()> flight_previous{};
+
+  // Runs on whatever thread crashed, so errno is saved for the interrupted code. An SA_SIGINFO handler we
+  // replaced is called directly with the original siginfo and context (a fault address survives); a plain one
+  // gets the signal re-raised once we return.
+  inline void flight_signal_handler(int signo, siginfo_t* info, void* context) noexcept
+  {
+    const int saved_errno = errno;
+    std::ignore = dump_flight_buffers(STDERR_FILENO);
+    for (std::size_t idx = 0; idx < flight_signals.size(); ++idx) {
+      if (flight_signals[idx] != signo) { continue; }
+      const struct sigaction& previous = flight_previous[idx];
+      ::sigaction(signo, &previous, nullptr);
+      if ((previous.sa_flags & SA_SIGINFO) != 0 && previous.sa_sigaction != nullptr) {
+        errno = saved_errno;
+        previous.sa_sigaction(signo, info, context);
+        errno = saved_errno;
+        return;
+      }
+    }
+    std::ignore = ::raise(signo);
+    errno = saved_errno;
+  }
+
+  // Idempotent: only replaces handlers that are not already the flight recorder's
+  inline void install_flight_recorder() noexcept
+  {
+    static std::mutex mutex;
+    const std::scoped_lock lock(mutex);
+    // Known before any crash, so dumps can show nanoseconds
+    std::ignore = TickClock::ns_per_tick();
+    for (std::size_t idx = 0; idx < flight_signals.size(); ++idx) {
+      struct sigaction current{};
+      if (::sigaction(flight_signals[idx], nullptr, &current) != 0) { continue; }
+      if ((current.sa_flags & SA_SIGINFO) != 0 && current.sa_sigaction == &flight_signal_handler) { continue; }
+      struct sigaction action{};
+      action.sa_sigaction = &flight_signal_handler;
+      sigemptyset(&action.sa_mask);
+      action.sa_flags = SA_ONSTACK | SA_SIGINFO;
+      std::ignore = ::sigaction(flight_signals[idx], &action, &flight_previous[idx]);
+    }
+  }
+#else
+  // EventLoop rejects FlightRecorder on other platforms; these keep its dispatch path free of #if
+  template<typename Receiver, typename Event> void flight_begin() noexcept {}
+  inline void flight_end() noexcept {}
+  inline void flight_thread_name(std::string_view /*name*/) noexcept {}
+  inline void install_flight_recorder() noexcept {}
+  inline bool dump_flight_buffers(int /*fd*/) noexcept { return false; }
+#endif
 
   // =============================================================================
-  // Filter implementation using concat (O(log N) depth instead of O(N) recursion)
+  // Watchdog stamps - what each dispatching thread is running (Watchdog option)
   // =============================================================================
 
-  template<template<typename> class Pred, typename... Ts> struct filter_fold
+  // Written only by its dispatching thread: six stores per dispatch, no read-modify-write. begin() publishes
+  // started and label as one seqlock-protected pair, so the watchdog never pairs a start tick with the label of
+  // the next dispatch.
+  // MSVC C4324: structure was padded due to alignment specifier (intentional for cache line separation)
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324)
+#endif
+  struct alignas(cache_line_size) DispatchStamp
   {
-    using type = typename concat_type_lists<std::conditional_t<Pred<Ts>::value, type_list<Ts>, type_list<>>...>::type;
-  };
+    struct Running
+    {
+      std::uint64_t started; // tick the running dispatch began, 0 between dispatches
+      const TraceLabel* label; // the running dispatch, or the last one
+    };
 
-  template<template<typename> class Pred, typename... Ts> using filter_t = typename filter_fold<Pred, Ts...>::type;
+    std::atomic<std::uint64_t> sequence{ 0 }; // odd while begin() is writing
+    std::atomic<std::uint64_t> started{ 0 };
+    std::atomic<const TraceLabel*> label{ nullptr };
+    std::atomic<std::uint64_t> completed{ 0 };
 
-  // Filter a type_list by predicate (expands type_list into filter_t)
-  template<template<typename> class Pred, typename... Ts> struct filter_list<Pred, type_list<Ts...>>
-  {
-    using type = filter_t<Pred, Ts...>;
-  };
+    template<typename Receiver, typename Event> void begin() noexcept
+    {
+      const std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+      sequence.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      label.store(&trace_label<Receiver, Event>, std::memory_order_relaxed);
+      started.store(TickClock::now(), std::memory_order_relaxed);
+      sequence.store(seq + 2, std::memory_order_release);
+    }
 
-  template<template<typename> class Pred, typename List> using filter_list_t = typename filter_list<Pred, List>::type;
+    // Only clears started, which leaves the label consistent with it
+    void end() noexcept
+    {
+      started.store(0, std::memory_order_relaxed);
+      completed.store(completed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consistent started/label pair; any thread
+    [[nodiscard]] Running running() const noexcept
+    {
+      while (true) {
+        const std::uint64_t before = sequence.load(std::memory_order_acquire);
+        if ((before & 1U) == 0) {
+          const Running snapshot{ .started = started.load(std::memory_order_relaxed),
+            .label = label.load(std::memory_order_relaxed) };
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (sequence.load(std::memory_order_relaxed) == before) { return snapshot; }
+        }
+        // begin() is between its first and last store
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  // Inbox depth for the watchdog without taking the inbox lock: producers count pushes, the receiver thread
+  // counts pops. Relaxed, since only a backlog that persists across checks matters.
+  struct InboxBacklog
+  {
+    alignas(cache_line_size) std::atomic<std::uint64_t> pushed{ 0 };
+    alignas(cache_line_size) std::atomic<std::uint64_t> popped{ 0 };
+
+    [[nodiscard]] bool pending() const noexcept
+    {
+      return pushed.load(std::memory_order_relaxed) > popped.load(std::memory_order_relaxed);
+    }
+  };
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+  struct NoDispatchStamp
+  {
+  };
+
+  struct NoInboxBacklog
+  {
+  };
+
+  // =============================================================================
+  // Dual queue: unsynchronized for same-thread, synchronized for cross-thread
+  // Uses ring buffer for fast same-thread access
+  // UseEventFd swaps the condition variable wakeup for a pollable eventfd
+  // Observer receives enqueue/drop/park hooks; the NullObserver default stores nothing
+  // =============================================================================
+
+  struct NoObserverRef
+  {
+  };
+
+  // Queue slot with its enqueue timestamp (DispatchLatency). Queues and dispatch keep the slot type, so the
+  // stamp is read from the object that was actually stored.
+  template<typename Tagged> struct Stamped : Tagged
+  {
+    using Tagged::Tagged;
+
+    std::uint64_t enqueued_at = 0;
+
+    template<typename Owner, typename Event> void stamp(QueueKind /*queue*/) noexcept
+    {
+      enqueued_at = TickClock::now();
+    }
+  };
+
+  // Stamped slot that also carries the trace flow id of its enqueue record (Trace)
+  template<typename Tagged> struct Traced : Stamped<Tagged>
+  {
+    using Stamped<Tagged>::Stamped;
+
+    std::uint64_t flow = 0;
+
+    template<typename Owner, typename Event> void stamp(QueueKind queue) noexcept
+    {
+      Stamped<Tagged>::template stamp<Owner, Event>(queue);
+      flow = trace_enqueue<Owner, Event>(queue, this->enqueued_at);
+    }
+  };
+
+  template<typename T> inline constexpr bool is_stamped = requires(T& slot) { slot.enqueued_at; };
+  template<typename T> inline constexpr bool is_traced = requires(T& slot) { slot.flow; };
+
+  template<typename TaggedEventType,
+    bool UseEventFd = false,
+    typename Observer = NullObserver,
+    typename Mutex = std::mutex>
+  class DualQueue
+  {
+    static_assert(!UseEventFd || EV_HAS_EVENTFD, "EventFdWakeup requires Linux eventfd support");
+
+#if EV_HAS_EVENTFD
+    using eventfd_type = std::conditional_t<UseEventFd, EventFd, NoEventFd>;
+#else
+    using eventfd_type = NoEventFd;
+#endif
+
+    static constexpr bool observed = !std::is_same_v<Observer, NullObserver>;
+
+  public:
+    // The owning loop hands in its observer before any event is pushed
+    void attach_observer(Observer* observer) noexcept
+      requires observed
+    {
+      observer_ = observer;
+    }
+
+    // Called from same thread (no sync needed)
+    template<typename E> void push_local_event(E&& event)
+    {
+      auto* slot = local_queue_.alloc_slot();
+      if (slot) [[likely]] {
+        slot->store(std::forward<E>(event));
+        if constexpr (is_stamped<TaggedEventType>) { slot->template stamp<void, std::decay_t<E>>(QueueKind::local); }
+        local_queue_.commit_push();
+        EV_PROBE(local_enqueue, this, local_queue_.tail() - 1, local_queue_.size());
+        if constexpr (observed) {
+          observer_->template on_enqueue<void, std::decay_t<E>>(QueueKind::local, local_queue_.size());
+        }
+      } else {
+        EV_PROBE(local_drop, this);
+        if constexpr (observed) { observer_->template on_drop<void, std::decay_t<E>>(QueueKind::local); }
+      }
+    }
+
+    // Called from other threads (synchronized) - wakes up waiting consumer
+    template<typename E> void push_remote_event(E&& event)
+    {
+      TaggedEventType tagged(std::forward<E>(event));
+      if constexpr (is_stamped<TaggedEventType>) { tagged.template stamp<void, std::decay_t<E>>(QueueKind::remote); }
+      [[maybe_unused]] std::size_t depth = 0;
+      {
+        std::scoped_lock lock(mutex_);
+        remote_queue_.push(std::move(tagged));
+        depth = remote_queue_.size();
+        EV_PROBE(remote_enqueue, this, remote_popped_ + depth - 1, depth);
+      }
+      if constexpr (observed) { observer_->template on_enqueue<void, std::decay_t<E>>(QueueKind::remote, depth); }
+      if constexpr (UseEventFd) {
+        // Only the push that raises the flag signals; the consumer clears it when draining.
+        // The fd must be signalled unconditionally since an external reactor may be polling it.
+        if (!has_remote_.exchange(true, std::memory_order_acq_rel)) { eventfd_.notify(); }
+      } else {
+        has_remote_.store(true, std::memory_order_release);
+        // Only notify if consumer is actually waiting (not spinning)
+        if (waiting_.load(std::memory_order_acquire)) { cv_.notify_one(); }
+      }
+    }
+
+    // Called from same thread only - checks local first, then drains remote
+    [[nodiscard]] TaggedEventType* try_pop()
+    {
+      // Fast path: check local queue first (no atomic/lock)
+      if (auto* event = pop_local()) { return event; }
+      // Local empty - bulk drain remote queue
+      drain_remote();
+      return pop_local();
+    }
+
+    // Pop from local queue only (no remote check) - for batch processing
+    [[nodiscard]] TaggedEventType* try_pop_local() noexcept { return pop_local(); }
+
+    // Block until an event is available (no busy-wait)
+    // 1. Check local queue (no sync)
+    // 2. If empty, drain remote (one lock)
+    // 3. If still empty, wait on CV
+    [[nodiscard]] TaggedEventType* wait_pop_any()
+    {
+      if constexpr (UseEventFd) {
+        return wait_pop_any_eventfd();
+      } else {
+        return wait_pop_any_cv();
+      }
+    }
+
+    // As wait_pop_any, but gives up at deadline (returns nullptr)
+    [[nodiscard]] TaggedEventType* wait_pop_any_until(std::chrono::steady_clock::time_point deadline)
+    {
+      if (auto* event = pop_local()) { return event; }
+      if constexpr (UseEventFd) {
+        eventfd_.consume();
+        drain_remote();
+        if (auto* event = pop_local()) { return event; }
+        if (stopped()) { return nullptr; }
+        park();
+        eventfd_.wait(poll_timeout_ms(deadline));
+        unpark();
+        drain_remote();
+      } else {
+        std::unique_lock lock(mutex_);
+        waiting_.store(true, std::memory_order_release);
+        park();
+        cv_.wait_until(lock, deadline, [this] { return !remote_queue_.empty() || stop_; });
+        unpark();
+        waiting_.store(false, std::memory_order_release);
+        move_remote_to_local();
+        has_remote_.store(false, std::memory_order_release);
+      }
+      return pop_local();
+    }
+
+    [[nodiscard]] bool empty()
+    {
+      drain_remote();
+      return local_queue_.empty();
+    }
+
+    void stop()
+    {
+      {
+        std::scoped_lock lock(mutex_);
+        stop_ = true;
+      }
+      if constexpr (UseEventFd) {
+        eventfd_.notify();
+      } else {
+        cv_.notify_one();
+      }
+    }
+
+    // Eventfd accessors - the fd polls readable while remote events are pending
+    [[nodiscard]] int native_handle() const noexcept
+      requires UseEventFd
+    {
+      return eventfd_.native_handle();
+    }
+
+    // Reset the eventfd before draining so pushes racing with the drain re-signal it
+    void clear_wakeup() const noexcept
+    {
+      if constexpr (UseEventFd) { eventfd_.consume(); }
+    }
+
+    // Keep the eventfd readable when the consumer stops with events still queued
+    void rearm_wakeup() const noexcept
+    {
+      if constexpr (UseEventFd) { eventfd_.notify(); }
+    }
+
+    // Remote events pushed but not yet drained into the local ring; safe from any thread
+    [[nodiscard]] bool has_remote() const noexcept { return has_remote_.load(std::memory_order_acquire); }
+
+    // Lock statistics of the remote side (ProfiledMutex only)
+    [[nodiscard]] const Mutex& mutex() const noexcept
+      requires(!std::is_same_v<Mutex, std::mutex>)
+    {
+      return mutex_;
+    }
+
+    // True once stop() was called and no remote events remain
+    [[nodiscard]] bool stopped()
+    {
+      std::scoped_lock lock(mutex_);
+      return stop_ && remote_queue_.empty();
+    }
+
+    // Park/unpark hooks for blocking waits outside the queue (the loop's epoll wait)
+    void park() const noexcept
+    {
+      EV_PROBE(park, this);
+      if constexpr (observed) { observer_->on_park(); }
+      if constexpr (is_traced<TaggedEventType>) { trace_park(TraceKind::park); }
+    }
+
+    void unpark() const noexcept
+    {
+      EV_PROBE(unpark, this);
+      if constexpr (observed) { observer_->on_unpark(); }
+      if constexpr (is_traced<TaggedEventType>) { trace_park(TraceKind::unpark); }
+    }
+
+  private:
+    // Every pop of the local ring goes through here, so each event fires one local_dequeue probe
+    [[nodiscard]] TaggedEventType* pop_local() noexcept
+    {
+      TaggedEventType* event = local_queue_.try_pop();
+      if (event != nullptr) { EV_PROBE(local_dequeue, this, local_queue_.head() - 1); }
+      return event;
+    }
+
+    [[nodiscard]] TaggedEventType* wait_pop_any_eventfd()
+    {
+      while (true) {
+        if (auto* event = pop_local()) { return event; }
+        // Consume the signal first: a push after this point signals again
+        eventfd_.consume();
+        drain_remote();
+        if (auto* event = pop_local()) { return event; }
+        if (stopped()) { return nullptr; }
+        park();
+        eventfd_.wait();
+        unpark();
+      }
+    }
+
+    [[nodiscard]] TaggedEventType* wait_pop_any_cv()
+    {
+      // Fast path: check local queue first
+      if (auto* event = pop_local()) { return event; }
+
+      // Try draining remote without waiting
+      if (has_remote_.load(std::memory_order_acquire)) {
+        std::scoped_lock lock(mutex_);
+        move_remote_to_local();
+        has_remote_.store(false, std::memory_order_release);
+      }
+
+      // Check local again after drain
+      if (auto* event = pop_local()) { return event; }
+
+      // Both empty - wait on CV for remote events
+      {
+        std::unique_lock lock(mutex_);
+        waiting_.store(true, std::memory_order_release);
+        park();
+        cv_.wait(lock, [this] { return !remote_queue_.empty() || stop_; });
+        unpark();
+        waiting_.store(false, std::memory_order_release);
+
+        if (stop_ && remote_queue_.empty()) { return nullptr; }
+
+        // Drain while holding lock
+        move_remote_to_local();
+        has_remote_.store(false, std::memory_order_release);
+      }
+
+      return pop_local();
+    }
+
+    void drain_remote()
+    {
+      // Fast path: check atomic flag before taking lock
+      if (!has_remote_.load(std::memory_order_acquire)) { return; }
+      std::scoped_lock lock(mutex_);
+      move_remote_to_local();
+      has_remote_.store(false, std::memory_order_release);
+    }
+
+    // Caller holds mutex_; events that no longer fit the local ring are dropped.
+    // Observers see each transfer as a remote dequeue followed by a local enqueue.
+    void move_remote_to_local()
+    {
+      while (!remote_queue_.empty()) {
+        EV_PROBE(remote_dequeue, this, remote_popped_);
+        ++remote_popped_;
+        bool moved = false;
+        if constexpr (observed) {
+          // The slot moves as a whole so its enqueue stamp survives the transfer
+          auto& front = remote_queue_.front();
+          fast_dispatch(front, [this, &front, &moved]<typename E>(E& /*event*/) {
+            moved = local_queue_.push(std::move(front));
+            if (moved) {
+              observer_->template on_dequeue<void, E>(QueueKind::remote);
+              observer_->template on_enqueue<void, E>(QueueKind::local, local_queue_.size());
+            } else {
+              observer_->template on_drop<void, E>(QueueKind::remote);
+            }
+          });
+        } else {
+          moved = local_queue_.push(std::move(remote_queue_.front()));
+        }
+        remote_queue_.pop();
+        if (!moved) {
+          EV_PROBE(local_drop, this);
+          continue;
+        }
+        EV_PROBE(local_enqueue, this, local_queue_.tail() - 1, local_queue_.size());
+      }
+    }
+
+    RingBuffer<TaggedEventType> local_queue_; // Same-thread access only
+    std::queue<TaggedEventType> remote_queue_; // Cross-thread, protected by mutex
+    std::size_t remote_popped_ = 0; // Remote events drained so far, protected by mutex; numbers them for the probes
+    Mutex mutex_;
+    condition_variable_for<Mutex> cv_;
+    std::atomic<bool> has_remote_{ false };
+    std::atomic<bool> waiting_{ false }; // True when consumer is blocked on CV
+    bool stop_ = false;
+    [[no_unique_address]] eventfd_type eventfd_;
+    [[no_unique_address]] std::conditional_t<observed, Observer*, NoObserverRef> observer_{};
+  };
+
+  // =============================================================================
+  // Coroutine support - frame pool, event and timer awaiters
+  // =============================================================================
+
+  // Per-loop coroutine frame allocator: size-classed free lists that are filled on first use
+  // and recycled afterwards, so steady-state handler coroutines never touch the global heap.
+  // Loop-thread only. Frames larger than the biggest class fall back to operator new.
+  class FramePool
+  {
+  public:
+    static constexpr std::size_t granularity = 64;
+    static constexpr std::size_t class_count = 32;
+
+    FramePool() = default;
+
+    ~FramePool()
+    {
+      for (FreeBlock* head : free_) {
+        while (head != nullptr) { ::operator delete(std::exchange(head, head->next)); }
+      }
+    }
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+    FramePool(FramePool&&) = delete;
+    FramePool& operator=(FramePool&&) = delete;
+
+    // pool may be nullptr (coroutine not started by a loop dispatcher)
+    [[nodiscard]] static void* allocate(FramePool* pool, std::size_t size)
+    {
+      const std::size_t total = size + sizeof(Header);
+      const std::size_t size_class = (total + granularity - 1) / granularity - 1;
+      void* block = nullptr;
+      if (pool != nullptr && size_class < class_count) {
+        if (FreeBlock* head = pool->free_[size_class]) {
+          pool->free_[size_class] = head->next;
+          block = head;
+        } else {
+          block = ::operator new((size_class + 1) * granularity);
+          ++pool->blocks_;
+        }
+      } else {
+        pool = nullptr;
+        block = ::operator new(total);
+      }
+      auto* header = ::new (block) Header{ .pool = pool, .size_class = size_class };
+      return header + 1;
+    }
+
+    static void deallocate(void* frame) noexcept
+    {
+      auto* header = static_cast<Header*>(frame) - 1;
+      FramePool* pool = header->pool;
+      if (pool == nullptr) {
+        ::operator delete(header);
+        return;
+      }
+      const std::size_t size_class = header->size_class;
+      pool->free_[size_class] = ::new (static_cast<void*>(header)) FreeBlock{ pool->free_[size_class] };
+    }
+
+    // Blocks obtained from operator new so far - stays flat once the pool is warm
+    [[nodiscard]] std::size_t blocks() const noexcept { return blocks_; }
+
+  private:
+    // Keeps the frame at the default new alignment
+    struct alignas(std::max_align_t) Header
+    {
+      FramePool* pool;
+      std::size_t size_class;
+    };
+
+    struct FreeBlock
+    {
+      FreeBlock* next;
+    };
+
+    std::array<FreeBlock*, class_count> free_{};
+    std::size_t blocks_ = 0;
+  };
+
+  struct NoFramePool
+  {
+  };
+
+  template<typename Event> class AwaitList;
+
+  // co_await dispatcher.next<Event>() - suspends until the receiver's next Event
+  template<typename Event> class NextAwaiter
+  {
+  public:
+    explicit NextAwaiter(AwaitList<Event>& list) noexcept : list_(&list) {}
+
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+      handle_ = handle;
+      list_->push(this);
+    }
+
+    [[nodiscard]] Event await_resume() { return std::move(*value_); }
+
+  private:
+    friend class AwaitList<Event>;
+
+    AwaitList<Event>* list_;
+    std::coroutine_handle<> handle_;
+    std::optional<Event> value_;
+    NextAwaiter* next_ = nullptr;
+  };
+
+  // FIFO of coroutines waiting for one event type; the awaiters live in the suspended frames
+  template<typename Event> class AwaitList
+  {
+  public:
+    [[nodiscard]] bool empty() const noexcept { return head_ == nullptr; }
+
+    void push(NextAwaiter<Event>* awaiter) noexcept
+    {
+      awaiter->next_ = nullptr;
+      if (tail_ != nullptr) {
+        tail_->next_ = awaiter;
+      } else {
+        head_ = awaiter;
+      }
+      tail_ = awaiter;
+    }
+
+    // Hand the event to the oldest waiter and resume it; false if nobody is waiting
+    template<typename E> bool resume_one(E&& event)
+    {
+      NextAwaiter<Event>* awaiter = pop();
+      if (awaiter == nullptr) { return false; }
+      awaiter->value_.emplace(std::forward<E>(event));
+      awaiter->handle_.resume();
+      return true;
+    }
+
+    void destroy_all() noexcept
+    {
+      while (NextAwaiter<Event>* awaiter = pop()) { awaiter->handle_.destroy(); }
+    }
+
+  private:
+    NextAwaiter<Event>* pop() noexcept
+    {
+      NextAwaiter<Event>* awaiter = head_;
+      if (awaiter != nullptr) {
+        head_ = awaiter->next_;
+        if (head_ == nullptr) { tail_ = nullptr; }
+      }
+      return awaiter;
+    }
+
+    NextAwaiter<Event>* head_ = nullptr;
+    NextAwaiter<Event>* tail_ = nullptr;
+  };
+
+  // One AwaitList per event a coroutine receiver accepts
+  template<typename List> class AwaitLists;
+
+  template<typename... Events> class AwaitLists<type_list<Events...>>
+  {
+  public:
+    template<typename Event> [[nodiscard]] AwaitList<Event>& get() noexcept
+    {
+      return std::get<AwaitList<Event>>(lists_);
+    }
+
+    void destroy_all() noexcept { (std::get<AwaitList<Events>>(lists_).destroy_all(), ...); }
+
+  private:
+    std::tuple<AwaitList<Events>...> lists_;
+  };
+
+  struct NoAwaitLists
+  {
+  };
+
+  // Intrusive deadline-ordered list of sleeping coroutines
+  class TimerList
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    struct Node
+    {
+      clock::time_point deadline;
+      std::coroutine_handle<> handle;
+      Node* next = nullptr;
+    };
+
+    [[nodiscard]] bool pending() const noexcept { return head_ != nullptr; }
+    [[nodiscard]] clock::time_point next_deadline() const noexcept
+    {
+      return head_ != nullptr ? head_->deadline : clock::time_point::max();
+    }
+
+    // Equal deadlines resume in insertion order
+    void insert(Node* node) noexcept
+    {
+      Node** link = &head_;
+      while (*link != nullptr && (*link)->deadline <= node->deadline) { link = &(*link)->next; }
+      node->next = *link;
+      *link = node;
+    }
+
+    // Resume every sleeper whose deadline has passed
+    std::size_t fire(clock::time_point now)
+    {
+      std::size_t fired = 0;
+      while (head_ != nullptr && head_->deadline <= now) {
+        Node* node = std::exchange(head_, head_->next);
+        node->handle.resume();
+        ++fired;
+      }
+      return fired;
+    }
+
+    void destroy_all() noexcept
+    {
+      while (head_ != nullptr) { std::exchange(head_, head_->next)->handle.destroy(); }
+    }
+
+  private:
+    Node* head_ = nullptr;
+  };
+
+  struct NoTimerList
+  {
+  };
+
+  // co_await dispatcher.sleep(duration)
+  class SleepAwaiter
+  {
+  public:
+    SleepAwaiter(TimerList& timers, TimerList::clock::time_point deadline) noexcept
+      : timers_(&timers), node_{ .deadline = deadline, .handle = {}, .next = nullptr }
+    {}
+
+    [[nodiscard]] bool await_ready() const noexcept { return node_.deadline <= TimerList::clock::now(); }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+      node_.handle = handle;
+      timers_->insert(&node_);
+    }
+
+    void await_resume() const noexcept {}
+
+  private:
+    TimerList* timers_;
+    TimerList::Node node_;
+  };
+
+} // namespace detail
+
+// Return type for coroutine handlers: `ev_loop::task on_event(Event e, D& dispatcher)`.
+// The coroutine starts eagerly inside dispatch and is owned by the loop while suspended;
+// SameThread handlers can co_await dispatcher.next<Event>() and dispatcher.sleep(duration).
+// Frames come from the loop's frame pool. An exception escaping the coroutine terminates.
+class task
+{
+public:
+  struct promise_type
+  {
+    task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    // Coroutine parameters are forwarded here; the dispatcher argument supplies the pool
+    template<typename... Args> static void* operator new(std::size_t size, Args&... args)
+    {
+      detail::FramePool* pool = nullptr;
+      ((pool = pool != nullptr ? pool : frame_pool_of(args)), ...);
+      return detail::FramePool::allocate(pool, size);
+    }
+
+    static void operator delete(void* frame) noexcept { detail::FramePool::deallocate(frame); }
+
+  private:
+    template<typename Arg> static detail::FramePool* frame_pool_of(Arg& arg) noexcept
+    {
+      if constexpr (requires { { arg.frame_pool() } -> std::same_as<detail::FramePool*>; }) {
+        return arg.frame_pool();
+      } else {
+        return nullptr;
+      }
+    }
+  };
+};
+
+namespace detail {
+
+  // SameThread receivers whose handlers return ev_loop::task (the return type must be spelled out)
+  template<typename Receiver, typename Dispatcher, typename... Events>
+  consteval bool returns_task(type_list<Events...> /*unused*/)
+  {
+    return (
+      std::is_same_v<decltype(std::declval<Receiver&>().on_event(std::declval<Events>(), std::declval<Dispatcher&>())),
+        task>
+      || ...);
+  }
+
+  template<typename Receiver, typename EventLoopType>
+  inline constexpr bool is_coroutine_receiver = [] {
+    if constexpr (is_receiver<Receiver> && is_same_thread_v<Receiver>) {
+      return returns_task<Receiver, SameThreadTypedDispatcher<Receiver, EventLoopType>>(get_receives_t<Receiver>{});
+    } else {
+      return false;
+    }
+  }();
+
+  // =============================================================================
+  // Same-thread receiver wrapper
+  // =============================================================================
+
+  template<typename Receiver, typename EventLoopType> class SameThreadWrapper
+  {
+  public:
+    // Use typed dispatcher for per-emitter routing tables
+    using dispatcher_type = SameThreadTypedDispatcher<Receiver, EventLoopType>;
+
+    static constexpr bool is_coroutine = is_coroutine_receiver<Receiver, EventLoopType>;
+
+    template<typename... Args>
+    explicit SameThreadWrapper(EventLoopType* event_loop, Args&&... args)
+      : receiver_(std::forward<Args>(args)...), dispatcher_(event_loop)
+    {}
+
+    // Suspended handler coroutines die with their receiver
+    ~SameThreadWrapper()
+    {
+      if constexpr (is_coroutine) { awaiting_.destroy_all(); }
+    }
+
+    SameThreadWrapper(const SameThreadWrapper&) = delete;
+    SameThreadWrapper& operator=(const SameThreadWrapper&) = delete;
+    SameThreadWrapper(SameThreadWrapper&&) noexcept = default;
+    SameThreadWrapper& operator=(SameThreadWrapper&&) noexcept = default;
+
+    // Called by EventLoop to dispatch a queued event - a coroutine waiting in
+    // next<Event>() takes it instead of on_event
+    template<typename Event>
+      requires can_receive<Receiver, std::decay_t<Event>>
+    void dispatch(Event&& event)
+    {
+      if constexpr (is_coroutine) {
+        if (awaiting_.template get<std::decay_t<Event>>().resume_one(std::forward<Event>(event))) { return; }
+      }
+      receiver_.on_event(std::forward<Event>(event), dispatcher_);
+    }
+
+    template<typename Event> [[nodiscard]] AwaitList<Event>& await_list() noexcept
+      requires is_coroutine
+    {
+      return awaiting_.template get<Event>();
+    }
+
+    // cppcheck-suppress functionStatic ; explicit object parameter functions cannot be static
+    template<typename Self> [[nodiscard]] auto& get(this Self& self) noexcept { return self.receiver_; }
+
+    // cppcheck-suppress functionStatic ; interface consistency with OwnThreadWrapper
+    void start() noexcept {}
+    // cppcheck-suppress functionStatic ; interface consistency with OwnThreadWrapper
+    void stop() noexcept {}
+
+  private:
+    Receiver receiver_;
+    dispatcher_type dispatcher_;
+    [[no_unique_address]] std::conditional_t<is_coroutine, AwaitLists<get_receives_t<Receiver>>, NoAwaitLists>
+      awaiting_;
+  };
+
+  // =============================================================================
+  // Own-thread receiver wrapper
+  // =============================================================================
+
+  template<typename Receiver, typename EventLoopType> class OwnThreadWrapper
+  {
+  public:
+    using receives_list = get_receives_t<Receiver>;
+    using tagged_event = to_tagged_event_t<receives_list>;
+    using slot_event = std::conditional_t<EventLoopType::uses_trace,
+      Traced<tagged_event>,
+      std::conditional_t<EventLoopType::uses_latency, Stamped<tagged_event>, tagged_event>>;
+
+    // Automatically select queue type based on producer count
+    // SPSC is safe when at most 1 producer thread, otherwise need MPSC
+    static constexpr std::size_t producer_count = EventLoopType::template producer_count_for<Receiver>;
+    using queue_type = std::conditional_t<(producer_count < 2),
+      spsc::Queue<slot_event>,
+      mpsc::Queue<slot_event, mpsc::default_capacity, typename EventLoopType::lock_mutex>>;
+
+    using dispatcher_type = OwnThreadTypedDispatcher<Receiver, EventLoopType>;
+
+    template<typename... Args>
+    explicit OwnThreadWrapper(EventLoopType* event_loop, Args&&... args)
+      : receiver_(std::forward<Args>(args)...), ev_(event_loop)
+    {}
+
+    ~OwnThreadWrapper() { stop(); }
+
+    OwnThreadWrapper(const OwnThreadWrapper&) = delete;
+    OwnThreadWrapper& operator=(const OwnThreadWrapper&) = delete;
+    OwnThreadWrapper(OwnThreadWrapper&&) = delete;
+    OwnThreadWrapper& operator=(OwnThreadWrapper&&) = delete;
+
+    void start()
+    {
+      if (running_.exchange(true)) { return; }
+      thread_ = std::thread([this] { run_loop(); });
+    }
+
+    void stop()
+    {
+      if (!running_.exchange(false)) { return; }
+      queue_.stop();
+      if (thread_.joinable()) { thread_.join(); }
+    }
+
+    // Push from any thread (synchronized)
+    template<typename Event>
+      requires can_receive<Receiver, Event>
+    void push(Event&& event)
+    {
+      slot_event slot(std::forward<Event>(event));
+      if constexpr (is_stamped<slot_event>) {
+        slot.template stamp<Receiver, std::decay_t<Event>>(QueueKind::own_thread);
+      }
+      // The depth comes out of the push itself: asking the queue again would retake the mpsc lock, or load the
+      // consumer's head a second time on spsc
+      [[maybe_unused]] std::size_t depth = 0;
+      [[maybe_unused]] const bool pushed = queue_.push(std::move(slot), depth);
+      if constexpr (EventLoopType::uses_watchdog) {
+        if (pushed) {
+          if constexpr (producer_count < 2) {
+            single_writer_add(backlog_.pushed, 1);
+          } else {
+            backlog_.pushed.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      }
+      if constexpr (EventLoopType::observed) {
+        if (pushed) {
+          ev_->hooks().template on_enqueue<Receiver, std::decay_t<Event>>(QueueKind::own_thread, depth);
+        } else {
+          ev_->hooks().template on_drop<Receiver, std::decay_t<Event>>(QueueKind::own_thread);
+        }
+      }
+      queue_.notify(); // Wake up consumer
+    }
+
+    // cppcheck-suppress functionStatic ; explicit object parameter functions cannot be static
+    template<typename Self> [[nodiscard]] auto& get(this Self& self) noexcept { return self.receiver_; }
+
+    // What this thread is running, and whether its inbox holds events (Watchdog option, any thread)
+    [[nodiscard]] const DispatchStamp& watchdog_stamp() const noexcept
+      requires EventLoopType::uses_watchdog
+    {
+      return watchdog_stamp_;
+    }
+
+    [[nodiscard]] bool backlogged() const noexcept
+      requires EventLoopType::uses_watchdog
+    {
+      return backlog_.pending();
+    }
+
+    // Appends the inbox's lock statistics (LockProfile option; an SPSC inbox has no lock)
+    void collect_lock_profile(std::vector<LockSnapshot::Entry>& out) const
+      requires EventLoopType::uses_lock_profile
+    {
+      if constexpr (producer_count >= 2) { queue_.mutex().collect(type_name<Receiver>(), out); }
+    }
+
+  private:
+    // Inbox park/unpark go to the loop's hooks and, with Trace, into this thread's trace ring
+    class InboxHooks : public NullObserver
+    {
+    public:
+      explicit InboxHooks(EventLoopType* event_loop) noexcept : ev_(event_loop) {}
+
+      void on_park() noexcept
+      {
+        if constexpr (EventLoopType::observed) { ev_->hooks().on_park(); }
+        if constexpr (EventLoopType::uses_trace) { trace_park(TraceKind::park); }
+      }
+
+      void on_unpark() noexcept
+      {
+        if constexpr (EventLoopType::observed) { ev_->hooks().on_unpark(); }
+        if constexpr (EventLoopType::uses_trace) { trace_park(TraceKind::unpark); }
+      }
+
+    private:
+      EventLoopType* ev_;
+    };
+
+    void run_loop()
+    {
+      if constexpr (EventLoopType::uses_trace) { trace_thread_name(type_name<Receiver>()); }
+      if constexpr (EventLoopType::uses_flight_recorder) { flight_thread_name(type_name<Receiver>()); }
+      if constexpr (EventLoopType::uses_utilization) { ev_->utilization().enter_thread(type_name<Receiver>()); }
+      if constexpr (EventLoopType::uses_perf_counters) { ev_->perf_counters().enter_thread(type_name<Receiver>()); }
+      if constexpr (EventLoopType::uses_lock_profile) { lock_thread_name = type_name<Receiver>(); }
+      dispatcher_type dispatcher(ev_);
+      while (running_.load(std::memory_order_relaxed)) {
+        slot_event* result = nullptr;
+        if constexpr (EventLoopType::observed || EventLoopType::uses_trace) {
+          result = queue_.pop_wait(InboxHooks{ ev_ });
+        } else {
+          result = queue_.pop_wait();
+        }
+        if (result) {
+          if constexpr (EventLoopType::uses_watchdog) { single_writer_add(backlog_.popped, 1); }
+          if constexpr (EventLoopType::uses_latency) { dispatch_stamp_ = result->enqueued_at; }
+          if constexpr (EventLoopType::uses_trace) { dispatch_flow_ = result->flow; }
+          fast_dispatch(*result, [this, &dispatcher]<typename E>(E& event) {
+            if constexpr (EventLoopType::observed) {
+              auto& observer = ev_->hooks();
+              observer.template on_dequeue<Receiver, E>(QueueKind::own_thread);
+              observer.template on_dispatch_begin<Receiver, E>();
+              timed_on_event(std::move(event), dispatcher);
+              observer.template on_dispatch_end<Receiver, E>();
+            } else {
+              timed_on_event(std::move(event), dispatcher);
+            }
+          });
+        }
+      }
+      if constexpr (EventLoopType::uses_utilization) { ev_->utilization().leave_thread(); }
+      if constexpr (EventLoopType::uses_perf_counters) { ev_->perf_counters().leave_thread(); }
+    }
+
+    template<typename Event> void timed_on_event(Event&& event, dispatcher_type& dispatcher)
+    {
+      using event_type = std::decay_t<Event>;
+      EV_PROBE(dispatch_begin, ev_, type_name_cstr<Receiver>.data(), type_name_cstr<event_type>.data());
+      if constexpr (EventLoopType::uses_trace) {
+        trace_dispatch<Receiver, event_type>(TraceKind::dispatch_begin, dispatch_flow_);
+      }
+      if constexpr (EventLoopType::uses_flight_recorder) { flight_begin<Receiver, event_type>(); }
+      if constexpr (EventLoopType::uses_watchdog) { watchdog_stamp_.template begin<Receiver, event_type>(); }
+      if constexpr (EventLoopType::uses_latency) {
+        const std::uint64_t begin = TickClock::now();
+        run_handler(std::forward<Event>(event), dispatcher);
+        ev_->latency().template record<Receiver>(dispatch_stamp_, begin, TickClock::now());
+      } else {
+        run_handler(std::forward<Event>(event), dispatcher);
+      }
+      if constexpr (EventLoopType::uses_watchdog) { watchdog_stamp_.end(); }
+      if constexpr (EventLoopType::uses_flight_recorder) { flight_end(); }
+      if constexpr (EventLoopType::uses_trace) { trace_dispatch<Receiver, event_type>(TraceKind::dispatch_end, 0); }
+      EV_PROBE(dispatch_end, ev_, type_name_cstr<Receiver>.data());
+    }
+
+    template<typename Event> void run_handler(Event&& event, dispatcher_type& dispatcher)
+    {
+      [[maybe_unused]] const auto allocation_guard =
+        ev_->allocations_.template dispatch_guard<Receiver, std::decay_t<Event>>();
+      if constexpr (EventLoopType::uses_profile) {
+        ev_->profile().template run<Receiver, std::decay_t<Event>>(
+          [&] { receiver_.on_event(std::forward<Event>(event), dispatcher); });
+      } else {
+        receiver_.on_event(std::forward<Event>(event), dispatcher);
+      }
+    }
+
+    Receiver receiver_;
+    EventLoopType* ev_;
+    std::thread thread_;
+    std::atomic<bool> running_{ false };
+    queue_type queue_;
+    // Written and read by the receiver thread only
+    std::uint64_t dispatch_stamp_ = 0;
+    std::uint64_t dispatch_flow_ = 0;
+    [[no_unique_address]] std::conditional_t<EventLoopType::uses_watchdog, DispatchStamp, NoDispatchStamp>
+      watchdog_stamp_;
+    [[no_unique_address]] std::conditional_t<EventLoopType::uses_watchdog, InboxBacklog, NoInboxBacklog> backlog_;
+  };
+
+  // =============================================================================
+  // Empty wrapper for external emitters (no storage needed, just type marker)
+  // =============================================================================
+
+  template<typename Emitter, typename EventLoopType> class ExternalEmitterWrapper
+  {
+  public:
+    explicit ExternalEmitterWrapper(EventLoopType* /*loop*/) noexcept {}
+  };
+
+  // =============================================================================
+  // Wrapper type selector (avoids instantiating wrong branch)
+  // =============================================================================
+
+  template<typename T, typename EventLoopType, bool IsReceiver = is_receiver<T>> struct wrapper_selector;
+
+  // Receiver case: select based on thread mode
+  template<typename Receiver, typename EventLoopType> struct wrapper_selector<Receiver, EventLoopType, true>
+  {
+    using type = std::conditional_t<is_own_thread_v<Receiver>,
+      OwnThreadWrapper<Receiver, EventLoopType>,
+      SameThreadWrapper<Receiver, EventLoopType>>;
+  };
+
+  // External emitter case: use empty wrapper
+  template<typename Emitter, typename EventLoopType> struct wrapper_selector<Emitter, EventLoopType, false>
+  {
+    using type = ExternalEmitterWrapper<Emitter, EventLoopType>;
+  };
+
+  template<typename T, typename EventLoopType> using wrapper_for = typename wrapper_selector<T, EventLoopType>::type;
+
+  // =============================================================================
+  // Receiver storage - handles non-movable wrappers via unique_ptr
+  // =============================================================================
+
+  template<typename Receiver, typename EventLoopType> class ReceiverStorage
+  {
+  public:
+    using wrapper_type = wrapper_for<Receiver, EventLoopType>;
+
+    template<typename... Args>
+    explicit ReceiverStorage(EventLoopType* loop, Args&&... args)
+      : wrapper_(std::make_unique<wrapper_type>(loop, std::forward<Args>(args)...))
+    {}
+
+    ~ReceiverStorage() = default;
+
+    ReceiverStorage(const ReceiverStorage&) = delete;
+    ReceiverStorage& operator=(const ReceiverStorage&) = delete;
+    ReceiverStorage(ReceiverStorage&&) noexcept = default;
+    ReceiverStorage& operator=(ReceiverStorage&&) noexcept = default;
+
+    template<typename Self> auto& operator*(this Self& self) noexcept { return *self.wrapper_; }
+    template<typename Self> auto* operator->(this Self& self) noexcept { return self.wrapper_.get(); }
+
+  private:
+    std::unique_ptr<wrapper_type> wrapper_;
+  };
+
+  // Loop options are compile-time tags: they keep their tuple slot, so indices still follow the Receivers
+  // pack, but own no wrapper and allocate nothing
+  template<typename Option, typename EventLoopType>
+    requires is_loop_option<Option>
+  class ReceiverStorage<Option, EventLoopType>
+  {
+  public:
+    explicit ReceiverStorage(EventLoopType* /*loop*/) noexcept {}
+  };
+
+  // =============================================================================
+  // Collect all event types that same-thread receivers handle
+  // =============================================================================
+
+  // Helper to get events from a single same-thread receiver (or empty list)
+  template<typename R>
+  using same_thread_events_from =
+    std::conditional_t<is_receiver<R> && is_same_thread_v<R>, get_receives_t<R>, type_list<>>;
+
+  // Operator for fold-based concatenation
+  template<typename... Ls, typename... Rs>
+  consteval auto operator+(type_list<Ls...> /*unused*/, type_list<Rs...> /*unused*/) -> type_list<Ls..., Rs...>
+  {
+    return {};
+  }
+
+  // Helper function for MSVC - fold in function body lets compiler deduce type
+  template<typename... Lists> consteval auto concat_type_lists_fn() { return (type_list<>{} + ... + Lists{}); }
+
+  // Concatenate multiple type_lists using fold expression (O(1) instantiation depth)
+  template<typename... Lists> struct concat_type_lists
+  {
+    using type = decltype(concat_type_lists_fn<Lists...>());
+  };
+
+  template<> struct concat_type_lists<>
+  {
+    using type = type_list<>;
+  };
+
+
+  // Collect all same-thread events - just concatenate without deduplication
+  // Assumes event types are unique across receivers (common case)
+  // For cases with duplicates, TaggedEvent handles it correctly (same type appears multiple times)
+  template<typename... Receivers>
+  using collect_same_thread_events_t = typename concat_type_lists<same_thread_events_from<Receivers>...>::type;
+
+  // Helper to get events received by a single OwnThread receiver (or empty list)
+  template<typename R>
+  using own_thread_events_from =
+    std::conditional_t<is_receiver<R> && is_own_thread_v<R>, get_receives_t<R>, type_list<>>;
+
+  // Collect all events received by OwnThread receivers
+  template<typename... Receivers>
+  using collect_own_thread_events_t = typename concat_type_lists<own_thread_events_from<Receivers>...>::type;
+
+  // Helper to get events emitted by a single OwnThread receiver (or empty list)
+  template<typename R>
+  using ot_emitted_events_from = std::conditional_t<is_own_thread_v<R>, get_emits_t<R>, type_list<>>;
+
+  // Collect all events emitted by OwnThread receivers (ECS-style precomputation)
+  template<typename... Receivers>
+  using collect_ot_emitted_events_t = typename concat_type_lists<ot_emitted_events_from<Receivers>...>::type;
+
+  // Helper to get events emitted by external emitters (or empty list)
+  template<typename R>
+  using ext_emitted_events_from = std::conditional_t<is_external_emitter<R>, get_emits_t<R>, type_list<>>;
+
+  // Collect all events emitted by external emitters
+  template<typename... Receivers>
+  using collect_ext_emitted_events_t = typename concat_type_lists<ext_emitted_events_from<Receivers>...>::type;
+
+  // =============================================================================
+  // Filter implementation using concat (O(log N) depth instead of O(N) recursion)
+  // =============================================================================
+
+  template<template<typename> class Pred, typename... Ts> struct filter_fold
+  {
+    using type = typename concat_type_lists<std::conditional_t<Pred<Ts>::value, type_list<Ts>, type_list<>>...>::type;
+  };
+
+  template<template<typename> class Pred, typename... Ts> using filter_t = typename filter_fold<Pred, Ts...>::type;
+
+  // Filter a type_list by predicate (expands type_list into filter_t)
+  template<template<typename> class Pred, typename... Ts> struct filter_list<Pred, type_list<Ts...>>
+  {
+    using type = filter_t<Pred, Ts...>;
+  };
+
+  template<template<typename> class Pred, typename List> using filter_list_t = typename filter_list<Pred, List>::type;
+
+} // namespace detail
+
+// =============================================================================
+// Async I/O buffers and completion events (IoUring loop option)
+// =============================================================================
+
+// Move-only handle to one buffer of the loop's I/O pool; returns it to the pool when destroyed.
+// Obtained from acquire_io_buffer() or carried by an IoCompletion. Must be released on the loop thread.
+class IoBuffer
+{
+public:
+  IoBuffer() noexcept = default;
+
+  ~IoBuffer() { reset(); }
+
+  IoBuffer(const IoBuffer&) = delete;
+  IoBuffer& operator=(const IoBuffer&) = delete;
+
+  IoBuffer(IoBuffer&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)), index_(other.index_), size_(std::exchange(other.size_, 0))
+  {}
+
+  IoBuffer& operator=(IoBuffer&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      pool_ = std::exchange(other.pool_, nullptr);
+      index_ = other.index_;
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  [[nodiscard]] explicit operator bool() const noexcept { return pool_ != nullptr; }
+
+  [[nodiscard]] std::byte* data() const noexcept { return pool_ != nullptr ? pool_->data(index_) : nullptr; }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] std::size_t capacity() const noexcept { return pool_ != nullptr ? pool_->buffer_size() : 0; }
+
+  // Valid bytes: the payload of a read completion, or what a write will send
+  [[nodiscard]] std::span<std::byte> bytes() const noexcept { return { data(), size_ }; }
+
+  void resize(std::size_t size) noexcept { size_ = std::min(size, capacity()); }
+
+  void reset() noexcept
+  {
+    if (pool_ != nullptr) { pool_->release(index_); }
+    pool_ = nullptr;
+    size_ = 0;
+  }
+
+private:
+  template<typename> friend class detail::AsyncIo;
+
+  IoBuffer(detail::IoBufferPool* pool, std::uint32_t index, std::size_t size) noexcept
+    : pool_(pool), index_(index), size_(size)
+  {}
+
+  // Hand ownership to an in-flight request without returning the buffer to the pool
+  [[nodiscard]] std::uint32_t release_to_request() noexcept
+  {
+    pool_ = nullptr;
+    size_ = 0;
+    return index_;
+  }
+
+  detail::IoBufferPool* pool_ = nullptr;
+  std::uint32_t index_ = 0;
+  std::size_t size_ = 0;
+};
+
+// Completion of a submit_read/submit_write - result is bytes transferred or -errno.
+// For reads, buffer holds the data; for writes it is the submitted buffer, ready for reuse.
+// Tag keeps operations apart: using LogWritten = ev_loop::IoCompletion<struct LogTag>;
+// Completions are move-only, so each completion type must have exactly one SameThread receiver.
+template<typename Tag> struct IoCompletion
+{
+  int fd;
+  int result;
+  IoBuffer buffer;
+};
+
+namespace detail {
+
+  // Event types the loop can construct from an I/O completion
+  template<typename T>
+  concept is_io_completion = requires(int fd, int result, IoBuffer buffer) { T{ fd, result, std::move(buffer) }; };
+
+  template<typename T> struct is_io_uring_option : std::false_type
+  {
+  };
+
+  template<std::size_t Entries, std::size_t Count, std::size_t Size, IoBackend Backend>
+  struct is_io_uring_option<IoUring<Entries, Count, Size, Backend>> : std::true_type
+  {
+  };
+
+  // Placeholder member when IoUring is not selected
+  struct NoAsyncIo
+  {
+  };
+
+#if EV_HAS_EVENTFD
+  // Loop-owned async I/O: in-flight slot table, buffer pool and backend (io_uring or thread pool)
+  template<typename Option> class AsyncIo
+  {
+    static constexpr std::size_t entries = Option::entries;
+
+  public:
+    AsyncIo() : pool_(Option::buffer_count, Option::buffer_size)
+    {
+      for (std::size_t idx = 0; idx < entries; ++idx) { free_slots_[idx] = static_cast<std::uint32_t>(idx); }
+#if EV_HAS_IO_URING
+      if (ring_.valid()) {
+        std::ignore = ring_.register_buffers(pool_);
+        return;
+      }
+#endif
+      if constexpr (Option::backend == IoBackend::io_uring) {
+        throw std::system_error(ENOSYS, std::system_category(), "io_uring_setup");
+      }
+      threads_ = std::make_unique<IoThreadPool<entries>>(io_fallback_threads);
+    }
+
+    // Neither the kernel nor a worker may write into the pool after it is freed. threads_ is destroyed
+    // first: workers finish the request they are running and drop the rest. io_uring requests are
+    // cancelled and then waited for with no time limit.
+    ~AsyncIo()
+    {
+#if EV_HAS_IO_URING
+      if (ring_.valid()) { cancel_in_flight(); }
+#endif
+    }
+
+    AsyncIo(const AsyncIo&) = delete;
+    AsyncIo& operator=(const AsyncIo&) = delete;
+    AsyncIo(AsyncIo&&) = delete;
+    AsyncIo& operator=(AsyncIo&&) = delete;
+
+    [[nodiscard]] IoBackend backend() const noexcept { return threads_ ? IoBackend::thread_pool : IoBackend::io_uring; }
+
+    [[nodiscard]] int native_handle() const noexcept
+    {
+#if EV_HAS_IO_URING
+      if (ring_.valid()) { return ring_.native_handle(); }
+#endif
+      return threads_->native_handle();
+    }
+
+    [[nodiscard]] IoBuffer acquire_buffer() noexcept
+    {
+      const std::uint32_t index = pool_.acquire();
+      if (index == IoBufferPool::npos) { return {}; }
+      return IoBuffer(&pool_, index, 0);
+    }
+
+    // Queue a read into a pooled buffer; false if no slot or buffer is free
+    [[nodiscard]] bool submit_read(std::uint32_t tag, int fd, std::size_t length, std::uint64_t offset)
+    {
+      IoBuffer buffer = acquire_buffer();
+      if (!buffer) { return false; }
+      buffer.resize(length);
+      return submit(tag, fd, std::move(buffer), offset, false);
+    }
+
+    // Queue a write of buffer.bytes(); false if no slot is free (the buffer is then released)
+    [[nodiscard]] bool submit_write(std::uint32_t tag, int fd, IoBuffer buffer, std::uint64_t offset)
+    {
+      if (!buffer) { return false; }
+      return submit(tag, fd, std::move(buffer), offset, true);
+    }
+
+    // Hand all staged requests to the backend - one syscall / lock round per call
+    void flush()
+    {
+      if (staged_ == 0) { return; }
+      staged_ = 0;
+#if EV_HAS_IO_URING
+      if (ring_.valid()) {
+        ring_.submit(set_aside());
+        return;
+      }
+#endif
+      threads_->submit();
+    }
+
+    // Invoke deliver(tag, fd, result, IoBuffer) for each finished request
+    template<typename Deliver> std::size_t reap(Deliver&& deliver)
+    {
+      auto complete = [this, &deliver](std::uint32_t slot, int result) {
+        const Slot& entry = slots_[slot];
+        const std::size_t size = result > 0 ? static_cast<std::size_t>(result) : 0;
+        IoBuffer buffer(&pool_, entry.buffer, entry.is_write ? entry.length : size);
+        free_slots_[free_count_++] = slot;
+        deliver(entry.tag, entry.fd, result, std::move(buffer));
+      };
+#if EV_HAS_IO_URING
+      if (ring_.valid()) {
+        const std::size_t count = std::exchange(aside_count_, 0);
+        for (std::size_t idx = 0; idx < count; ++idx) { complete(aside_[idx].slot, aside_[idx].result); }
+        return count + ring_.reap(complete);
+      }
+#endif
+      return threads_->reap(complete);
+    }
+
+    [[nodiscard]] std::size_t in_flight() const noexcept { return entries - free_count_; }
+
+    // Completions taken while submitting, which the ring fd no longer signals: reap() right away
+    [[nodiscard]] bool has_set_aside() const noexcept
+    {
+#if EV_HAS_IO_URING
+      return aside_count_ != 0;
+#else
+      return false;
+#endif
+    }
+
+  private:
+    struct Slot
+    {
+      std::uint32_t tag = 0;
+      int fd = -1;
+      std::uint32_t buffer = 0;
+      std::uint32_t length = 0;
+      bool is_write = false;
+    };
+
+    bool submit(std::uint32_t tag, int fd, IoBuffer buffer, std::uint64_t offset, bool is_write)
+    {
+      if (free_count_ == 0) [[unlikely]] { return false; }
+      const std::uint32_t slot = free_slots_[free_count_ - 1];
+      const IoRequest request{ .slot = slot,
+        .is_write = is_write,
+        .fd = fd,
+        .offset = offset,
+        .data = buffer.data(),
+        .length = static_cast<std::uint32_t>(buffer.size()),
+        .buffer = buffer.index_ };
+      if (!push(request)) { return false; }
+      --free_count_;
+      slots_[slot] =
+        Slot{ .tag = tag,
+          .fd = fd,
+          .buffer = buffer.release_to_request(),
+          .length = request.length,
+          .is_write = is_write };
+      ++staged_;
+      return true;
+    }
+
+    bool push(const IoRequest& request)
+    {
+#if EV_HAS_IO_URING
+      if (ring_.valid()) {
+        if (ring_.push(request)) { return true; }
+        // SQ full - submit what is staged and retry once
+        ring_.submit(set_aside());
+        staged_ = 0;
+        return ring_.push(request);
+      }
+#endif
+      threads_->push(request);
+      return true;
+    }
+
+#if EV_HAS_IO_URING
+    // A cancel cannot stop a read or write the kernel has already started, so wait for every slot to
+    // complete. Should the ring fail meanwhile, the slab and ring are leaked rather than freed under it.
+    void cancel_in_flight()
+    {
+      const auto drop = [](std::uint32_t /*tag*/, int /*fd*/, int /*result*/, IoBuffer /*buffer*/) {};
+      flush();
+      std::ignore = reap(drop);
+      std::array<bool, entries> idle{};
+      for (std::size_t idx = 0; idx < free_count_; ++idx) { idle[free_slots_[idx]] = true; }
+      for (std::uint32_t slot = 0; slot < entries; ++slot) {
+        if (idle[slot]) { continue; }
+        while (!ring_.cancel(slot)) { ring_.submit(set_aside()); }
+      }
+      ring_.submit(set_aside());
+      while (in_flight() > 0) {
+        if (!has_set_aside() && !ring_.wait()) {
+          pool_.leak();
+          ring_.leak();
+          return;
+        }
+        std::ignore = reap(drop);
+      }
+    }
+
+    // Every slot completes once, so entries bounds what can be set aside
+    [[nodiscard]] auto set_aside() noexcept
+    {
+      return [this](std::uint32_t slot, int result) noexcept {
+        aside_[aside_count_++] = { .slot = slot, .result = result };
+      };
+    }
+#endif
+
+    IoBufferPool pool_;
+    std::array<Slot, entries> slots_{};
+    std::array<std::uint32_t, entries> free_slots_{};
+    std::size_t free_count_ = entries;
+    std::size_t staged_ = 0;
+#if EV_HAS_IO_URING
+    struct Finished
+    {
+      std::uint32_t slot;
+      int result;
+    };
+    std::array<Finished, entries> aside_{};
+    std::size_t aside_count_ = 0;
+    IoUringRing ring_{ Option::backend == IoBackend::thread_pool ? 0U : static_cast<unsigned>(entries) };
+#endif
+    std::unique_ptr<IoThreadPool<entries>> threads_;
+  };
+#endif
+
+  // =============================================================================
+  // Request/reply - correlation-stamped events with pooled continuations
+  // =============================================================================
+
+  // Events carrying a correlation_id member the loop can stamp and route by
+  template<typename T>
+  concept is_correlated = requires(T& event) { requires std::same_as<decltype(event.correlation_id), correlation_id>; };
+
+  template<typename T> struct is_request_reply_option : std::false_type
+  {
+  };
+
+  template<std::size_t Slots, std::size_t Bytes>
+  struct is_request_reply_option<RequestReply<Slots, Bytes>> : std::true_type
+  {
+  };
+
+  struct NoRequestTable
+  {
+  };
+
+  // Fixed slot table of pending requests. A correlation id is (generation << 32) | slot, so a
+  // late reply to a recycled slot is rejected. Loop-thread only.
+  template<typename Option> class RequestTable
+  {
+    static constexpr std::size_t slot_count = Option::slots;
+    static constexpr unsigned generation_shift = 32;
+
+  public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::uint32_t no_requester = ~std::uint32_t{ 0 };
+
+    RequestTable()
+    {
+      for (std::size_t idx = 0; idx < slot_count; ++idx) {
+        free_[idx] = static_cast<std::uint32_t>(slot_count - 1 - idx);
+      }
+    }
+
+    ~RequestTable()
+    {
+      for (Slot& slot : slots_) {
+        if (slot.destroy != nullptr) { slot.destroy(slot); }
+      }
+    }
+
+    RequestTable(const RequestTable&) = delete;
+    RequestTable& operator=(const RequestTable&) = delete;
+    RequestTable(RequestTable&&) = delete;
+    RequestTable& operator=(RequestTable&&) = delete;
+
+    // Store requester's continuation for a Reply; returns its correlation id, or 0 when every slot is taken.
+    // A request with a deadline is failed with RequestStatus::timed_out by the first expire() after it.
+    template<typename Reply, typename Callback>
+    [[nodiscard]] correlation_id add(std::uint32_t reply_tag, std::uint32_t requester, Callback&& callback,
+      clock::time_point deadline = clock::time_point::max())
+    {
+      using Fn = std::decay_t<Callback>;
+      static_assert(sizeof(Fn) <= Option::callback_bytes, "Request callback exceeds RequestReply CallbackBytes");
+      static_assert(alignof(Fn) <= alignof(std::max_align_t), "Request callback is over-aligned");
+      static_assert(std::is_invocable_v<Fn&, Reply&&>, "Request callback must be callable with the Reply");
+
+      if (free_count_ == 0) [[unlikely]] { return 0; }
+      const std::uint32_t index = free_[--free_count_];
+      Slot& slot = slots_[index];
+      ::new (static_cast<void*>(slot.storage.data())) Fn(std::forward<Callback>(callback));
+      slot.invoke = [](Slot& target, void* reply) {
+        (*target.template callable<Fn>())(std::move(*static_cast<Reply*>(reply)));
+      };
+      if constexpr (std::is_invocable_v<Fn&, RequestStatus>) {
+        slot.fail = [](Slot& target, RequestStatus status) { (*target.template callable<Fn>())(status); };
+      }
+      slot.destroy = [](Slot& target) { std::destroy_at(target.template callable<Fn>()); };
+      slot.reply_tag = reply_tag;
+      slot.requester = requester;
+      slot.deadline = deadline;
+      if (deadline != clock::time_point::max()) {
+        ++timed_;
+        next_deadline_ = std::min(next_deadline_, deadline);
+      }
+      return id_of(index);
+    }
+
+    // Run and release the continuation waiting for this reply; false if none matches
+    template<typename Reply> bool complete(std::uint32_t reply_tag, Reply& reply)
+    {
+      const correlation_id id = reply.correlation_id;
+      const auto index = static_cast<std::uint32_t>(id);
+      if (index >= slot_count) { return false; }
+      Slot& slot = slots_[index];
+      if (slot.invoke == nullptr || slot.generation != (id >> generation_shift) || slot.reply_tag != reply_tag) {
+        return false;
+      }
+      // Released after the call (even if it throws) so the continuation may issue new requests
+      struct Release
+      {
+        RequestTable* table;
+        std::uint32_t index;
+        ~Release() { table->release(index); }
+      } const release{ this, index };
+      std::exchange(slot.invoke, nullptr)(slot, &reply);
+      return true;
+    }
+
+    // Requester of a request that was already answered, timed out or cancelled, as long as its slot has
+    // not been reused since; no_requester otherwise
+    [[nodiscard]] std::uint32_t requester_of(std::uint32_t reply_tag, correlation_id id) const noexcept
+    {
+      const auto index = static_cast<std::uint32_t>(id);
+      if (index >= slot_count) { return no_requester; }
+      const Slot& slot = slots_[index];
+      // Generation 0 is skipped, so the one before 1 is the largest
+      const std::uint32_t released = slot.generation == 1 ? ~std::uint32_t{ 0 } : slot.generation - 1;
+      if (slot.destroy != nullptr || released != (id >> generation_shift) || slot.reply_tag != reply_tag) {
+        return no_requester;
+      }
+      return slot.requester;
+    }
+
+    // Release a pending request without its reply, telling the continuation; false if id is not pending
+    bool cancel(correlation_id id)
+    {
+      const auto index = static_cast<std::uint32_t>(id);
+      if (index >= slot_count || slots_[index].invoke == nullptr || id_of(index) != id) { return false; }
+      fail(index, RequestStatus::cancelled);
+      return true;
+    }
+
+    // True while any pending request has a deadline; the loop then calls expire() on every poll
+    [[nodiscard]] bool timed() const noexcept { return timed_ != 0; }
+
+    // Earliest deadline among pending requests; time_point::max() when none has one
+    [[nodiscard]] clock::time_point next_deadline() const noexcept { return next_deadline_; }
+
+    // Fail every request whose deadline has passed; returns how many
+    std::size_t expire(clock::time_point now)
+    {
+      if (now < next_deadline_) { return 0; }
+      // Continuations may issue new requests, which lower next_deadline_ again through add()
+      next_deadline_ = clock::time_point::max();
+      std::size_t expired = 0;
+      for (std::uint32_t index = 0; index < slot_count; ++index) {
+        const Slot& slot = slots_[index];
+        if (slot.invoke == nullptr || slot.deadline == clock::time_point::max()) { continue; }
+        if (slot.deadline <= now) {
+          fail(index, RequestStatus::timed_out);
+          ++expired;
+        } else {
+          next_deadline_ = std::min(next_deadline_, slot.deadline);
+        }
+      }
+      return expired;
+    }
+
+    [[nodiscard]] std::size_t pending() const noexcept { return slot_count - free_count_; }
+
+  private:
+    struct Slot
+    {
+      alignas(std::max_align_t) std::array<std::byte, Option::callback_bytes> storage;
+      void (*invoke)(Slot&, void*) = nullptr;
+      void (*fail)(Slot&, RequestStatus) = nullptr; // nullptr when the continuation only takes the reply
+      void (*destroy)(Slot&) = nullptr;
+      clock::time_point deadline = clock::time_point::max();
+      std::uint32_t generation = 1;
+      std::uint32_t reply_tag = 0;
+      std::uint32_t requester = no_requester; // Receiver index; kept after release for late replies
+
+      template<typename Fn> Fn* callable() noexcept
+      {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return std::launder(reinterpret_cast<Fn*>(storage.data()));
+      }
+    };
+
+    [[nodiscard]] correlation_id id_of(std::uint32_t index) const noexcept
+    {
+      return (correlation_id{ slots_[index].generation } << generation_shift) | index;
+    }
+
+    // Released after the call (even if it throws), like complete()
+    void fail(std::uint32_t index, RequestStatus status)
+    {
+      struct Release
+      {
+        RequestTable* table;
+        std::uint32_t index;
+        ~Release() { table->release(index); }
+      } const release{ this, index };
+      Slot& slot = slots_[index];
+      slot.invoke = nullptr;
+      if (slot.fail != nullptr) { slot.fail(slot, status); }
+    }
+
+    void release(std::uint32_t index) noexcept
+    {
+      Slot& slot = slots_[index];
+      std::exchange(slot.destroy, nullptr)(slot);
+      slot.invoke = nullptr;
+      slot.fail = nullptr;
+      if (std::exchange(slot.deadline, clock::time_point::max()) != clock::time_point::max()) { --timed_; }
+      // Generation 0 is skipped so a stamped id is never 0
+      if (++slot.generation == 0) { slot.generation = 1; }
+      free_[free_count_++] = index;
+    }
+
+    std::array<Slot, slot_count> slots_{};
+    std::array<std::uint32_t, slot_count> free_{};
+    std::size_t free_count_ = slot_count;
+    std::size_t timed_ = 0;
+    clock::time_point next_deadline_ = clock::time_point::max();
+  };
+
+  // =============================================================================
+  // Observer policy selection
+  // =============================================================================
+
+  template<typename T> struct is_observe_option : std::false_type
+  {
+  };
+
+  template<typename Policy> struct is_observe_option<Observe<Policy>> : std::true_type
+  {
+  };
+
+  template<typename List> struct observer_policy
+  {
+    using type = NullObserver;
+  };
+
+  template<typename Option> struct observer_policy<type_list<Option>>
+  {
+    using type = typename Option::policy;
+  };
+
+} // namespace detail
+
+// =============================================================================
+// Metrics snapshot - plain copy of the registry counters plus OpenMetrics rendering
+// =============================================================================
+
+struct MetricsSnapshot
+{
+  struct Dispatch
+  {
+    std::string_view receiver;
+    std::string_view event;
+    std::uint64_t count;
+  };
+
+  struct Queue
+  {
+    std::string_view name; // "local", "remote" or the OwnThread receiver's type
+    std::uint64_t enqueued;
+    std::uint64_t dequeued;
+    std::uint64_t dropped;
+    std::uint64_t depth; // enqueued minus dequeued; counters are read one at a time, so it can lag
+    std::uint64_t high_water;
+    std::uint64_t wakeups; // dequeues right after the consumer blocked
+    std::uint64_t spins; // dequeues that found the event without blocking
+  };
+
+  std::vector<Dispatch> dispatched;
+  std::vector<Queue> queues;
+
+  [[nodiscard]] const Queue* queue(std::string_view name) const noexcept
+  {
+    const auto found = std::ranges::find(queues, name, &Queue::name);
+    return found == queues.end() ? nullptr : &*found;
+  }
+
+  // OpenMetrics text exposition, terminated by "# EOF"
+  [[nodiscard]] std::string openmetrics() const
+  {
+    std::string out;
+    out += "# TYPE ev_loop_dispatched counter\n";
+    out += "# HELP ev_loop_dispatched Events handled, by receiver and event type.\n";
+    for (const auto& entry : dispatched) {
+      out += "ev_loop_dispatched_total{receiver=\"";
+      append_label_value(out, entry.receiver);
+      out += "\",event=\"";
+      append_label_value(out, entry.event);
+      out += "\"} ";
+      out += std::to_string(entry.count);
+      out += '\n';
+    }
+    append_queue_family(out, "enqueued", "counter", "Events pushed.", &Queue::enqueued);
+    append_queue_family(out, "dequeued", "counter", "Events popped for dispatch.", &Queue::dequeued);
+    append_queue_family(out, "dropped", "counter", "Events discarded by a full queue.", &Queue::dropped);
+    append_queue_family(out, "wakeups", "counter", "Dequeues right after the consumer blocked.", &Queue::wakeups);
+    append_queue_family(out, "spins", "counter", "Dequeues without blocking.", &Queue::spins);
+    append_queue_family(out, "queue_depth", "gauge", "Events currently queued.", &Queue::depth);
+    append_queue_family(out, "queue_high_water", "gauge", "Largest queue depth seen.", &Queue::high_water);
+    out += "# EOF\n";
+    return out;
+  }
+
+  // Write openmetrics() to path through a temporary file and rename, so a scraper never reads a
+  // partial dump. Returns false (errno set) on failure.
+  [[nodiscard]] bool write_openmetrics(const char* path) const
+  {
+    const std::string text = openmetrics();
+    const std::string temporary = std::string(path) + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "w");
+    if (file == nullptr) { return false; }
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (std::fclose(file) != 0 || !written) {
+      std::ignore = std::remove(temporary.c_str());
+      return false;
+    }
+    return std::rename(temporary.c_str(), path) == 0;
+  }
+
+private:
+  static void append_label_value(std::string& out, std::string_view value)
+  {
+    for (const char character : value) {
+      if (character == '\\' || character == '"') {
+        out += '\\';
+        out += character;
+      } else if (character == '\n') {
+        out += "\\n";
+      } else {
+        out += character;
+      }
+    }
+  }
+
+  void append_queue_family(std::string& out,
+    std::string_view name,
+    std::string_view type,
+    std::string_view help,
+    std::uint64_t Queue::* field) const
+  {
+    const bool counter = type == "counter";
+    out += "# TYPE ev_loop_";
+    out += name;
+    out += ' ';
+    out += type;
+    out += "\n# HELP ev_loop_";
+    out += name;
+    out += ' ';
+    out += help;
+    out += '\n';
+    for (const auto& entry : queues) {
+      out += "ev_loop_";
+      out += name;
+      if (counter) { out += "_total"; }
+      out += "{queue=\"";
+      append_label_value(out, entry.name);
+      out += "\"} ";
+      out += std::to_string(entry.*field);
+      out += '\n';
+    }
+  }
+};
+
+namespace detail {
+
+  // =============================================================================
+  // Metrics registry - per-thread counter lanes, summed on snapshot
+  // =============================================================================
+
+  // Distinguishes registries in the per-thread lane and slot caches (addresses can be reused)
+  inline std::atomic<std::uint64_t> metrics_registry_ids{ 0 };
+
+  // A thread's records in the registries it has hooked into, keyed by registry id. A thread can serve several
+  // loops, so a few entries are kept and the oldest is replaced. A record stays valid while its registry's
+  // epoch is unchanged.
+  template<typename Record> class RegistryCache
+  {
+    static constexpr std::size_t ways = 4;
+
+  public:
+    struct Entry
+    {
+      std::uint64_t registry = 0;
+      std::uint64_t epoch = 0;
+      Record* record = nullptr;
+    };
+
+    [[nodiscard]] static const Entry* find(std::uint64_t registry, std::uint64_t epoch) noexcept
+    {
+      for (const Entry& entry : local().entries) {
+        if (entry.registry == registry && entry.epoch == epoch) { return &entry; }
+      }
+      return nullptr;
+    }
+
+    static void store(std::uint64_t registry, std::uint64_t epoch, Record* record) noexcept
+    {
+      Entries& cache = local();
+      for (Entry& entry : cache.entries) {
+        if (entry.registry == registry) {
+          entry = { .registry = registry, .epoch = epoch, .record = record };
+          return;
+        }
+      }
+      cache.entries[cache.next] = { .registry = registry, .epoch = epoch, .record = record };
+      cache.next = (cache.next + 1) % ways;
+    }
+
+  private:
+    struct Entries
+    {
+      std::array<Entry, ways> entries{};
+      std::size_t next = 0;
+    };
+
+    [[nodiscard]] static Entries& local() noexcept
+    {
+      thread_local Entries cache;
+      return cache;
+    }
+  };
+
+  // Flat index over every (type, event type) pair of a loop, where the events of a type are ListOf<type>,
+  // labelled with the type names
+  template<template<typename> typename ListOf, typename... Receivers> struct TypeSlots
+  {
+    static constexpr std::size_t count = (type_list_size_v<ListOf<Receivers>> + ... + 0);
+
+    template<typename Receiver, typename Event> static consteval std::size_t index()
+    {
+      constexpr std::array<std::size_t, sizeof...(Receivers)> sizes{ type_list_size_v<ListOf<Receivers>>... };
+      std::size_t offset = 0;
+      for (std::size_t idx = 0; idx < index_of_v<Receiver, Receivers...>; ++idx) { offset += sizes[idx]; }
+      return offset + type_list_index_of_v<ListOf<Receiver>, Event>;
+    }
+
+    using label = std::pair<std::string_view, std::string_view>;
+
+    template<typename Receiver, typename... Events>
+    static consteval void append_labels(std::array<label, count>& labels,
+      std::size_t& next,
+      type_list<Events...> /*unused*/)
+    {
+      ((labels[next++] = { type_name<Receiver>(), type_name<Events>() }), ...);
+    }
+
+    static consteval auto make_labels()
+    {
+      std::array<label, count> labels{};
+      std::size_t next = 0;
+      (append_labels<Receivers>(labels, next, ListOf<Receivers>{}), ...);
+      return labels;
+    }
+
+    static constexpr auto labels = make_labels();
+  };
+
+  // Every (receiver, received event) pair
+  template<typename... Receivers> using DispatchSlots = TypeSlots<get_receives_t, Receivers...>;
+
+  // Every (receiver or external emitter, emitted event) pair
+  template<typename... Receivers> using EmitSlots = TypeSlots<get_emits_t, Receivers...>;
+
+  template<typename... Receivers> class MetricsRegistry : public NullObserver
+  {
+    static constexpr std::size_t receiver_count = sizeof...(Receivers);
+    static constexpr std::size_t dispatch_slots = DispatchSlots<Receivers...>::count;
+    // local, remote, then one inbox per receiver (only OwnThread ones are used)
+    static constexpr std::size_t queue_slots = 2 + receiver_count;
+    static constexpr std::size_t max_lanes = 64;
+
+    struct QueueCounters
+    {
+      std::atomic<std::uint64_t> enqueued{ 0 };
+      std::atomic<std::uint64_t> dequeued{ 0 };
+      std::atomic<std::uint64_t> dropped{ 0 };
+      std::atomic<std::uint64_t> high_water{ 0 };
+      std::atomic<std::uint64_t> wakeups{ 0 };
+      std::atomic<std::uint64_t> spins{ 0 };
+    };
+
+    // Counters of one thread - written only by that thread, except the shared overflow lane
+    // used once max_lanes threads have claimed one (that lane pays for fetch_add)
+    // MSVC C4324: structure was padded due to alignment specifier (intentional for cache line separation)
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324)
+#endif
+    struct alignas(cache_line_size) Lane
+    {
+      std::thread::id owner;
+      bool shared = false;
+      std::atomic<bool> woke{ false }; // owner blocked since its last dequeue
+      std::array<std::atomic<std::uint64_t>, dispatch_slots> dispatched{};
+      std::array<QueueCounters, queue_slots> queues{};
+    };
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+  public:
+    MetricsRegistry() { shared_lane_.shared = true; }
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+    MetricsRegistry(MetricsRegistry&&) = delete;
+    MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+    ~MetricsRegistry() = default;
+
+    template<typename Owner, typename Event> void on_enqueue(QueueKind kind, std::size_t depth) noexcept
+    {
+      Lane& current = lane();
+      auto& counters = current.queues[queue_slot<Owner>(kind)];
+      bump(current, counters.enqueued);
+      raise(current, counters.high_water, depth);
+    }
+
+    template<typename Owner, typename Event> void on_dequeue(QueueKind kind) noexcept
+    {
+      Lane& current = lane();
+      auto& counters = current.queues[queue_slot<Owner>(kind)];
+      bump(current, counters.dequeued);
+      // Remote dequeues are transfers into the local ring, not consumer wakeups
+      if (kind == QueueKind::remote) { return; }
+      if (current.woke.load(std::memory_order_relaxed)) {
+        current.woke.store(false, std::memory_order_relaxed);
+        bump(current, counters.wakeups);
+      } else {
+        bump(current, counters.spins);
+      }
+    }
+
+    template<typename Owner, typename Event> void on_drop(QueueKind kind) noexcept
+    {
+      Lane& current = lane();
+      bump(current, current.queues[queue_slot<Owner>(kind)].dropped);
+    }
+
+    template<typename Receiver, typename Event> void on_dispatch_end() noexcept
+    {
+      Lane& current = lane();
+      bump(current, current.dispatched[dispatch_slot<Receiver, Event>()]);
+    }
+
+    void on_unpark() noexcept { lane().woke.store(true, std::memory_order_relaxed); }
+
+    // Sum every lane; safe from any thread while the loop runs
+    [[nodiscard]] MetricsSnapshot snapshot() const
+    {
+      const std::size_t lane_count = lane_count_.load(std::memory_order_acquire);
+      const auto sum = [&](auto&& field) {
+        std::uint64_t total = field(shared_lane_).load(std::memory_order_relaxed);
+        for (std::size_t idx = 0; idx < lane_count; ++idx) {
+          total += field(*lanes_[idx]).load(std::memory_order_relaxed);
+        }
+        return total;
+      };
+      const auto peak = [&](auto&& field) {
+        std::uint64_t highest = field(shared_lane_).load(std::memory_order_relaxed);
+        for (std::size_t idx = 0; idx < lane_count; ++idx) {
+          highest = std::max(highest, field(*lanes_[idx]).load(std::memory_order_relaxed));
+        }
+        return highest;
+      };
+
+      MetricsSnapshot snapshot;
+      snapshot.dispatched.reserve(dispatch_slots);
+      for (std::size_t slot = 0; slot < dispatch_slots; ++slot) {
+        snapshot.dispatched.push_back({ .receiver = dispatch_labels[slot].first,
+          .event = dispatch_labels[slot].second,
+          .count = sum([slot](const Lane& each) -> auto& { return each.dispatched[slot]; }) });
+      }
+      for (std::size_t slot = 0; slot < queue_slots; ++slot) {
+        if (!queue_used[slot]) { continue; }
+        const auto counter = [slot](auto member) {
+          return [slot, member](const Lane& each) -> auto& { return each.queues[slot].*member; };
+        };
+        MetricsSnapshot::Queue entry{ .name = queue_labels[slot],
+          .enqueued = sum(counter(&QueueCounters::enqueued)),
+          .dequeued = sum(counter(&QueueCounters::dequeued)),
+          .dropped = sum(counter(&QueueCounters::dropped)),
+          .depth = 0,
+          .high_water = peak(counter(&QueueCounters::high_water)),
+          .wakeups = sum(counter(&QueueCounters::wakeups)),
+          .spins = sum(counter(&QueueCounters::spins)) };
+        // Only the remote side drops events it already counted as enqueued (on drain overflow)
+        const std::uint64_t gone = entry.dequeued + (slot == remote_slot ? entry.dropped : 0);
+        entry.depth = entry.enqueued > gone ? entry.enqueued - gone : 0;
+        snapshot.queues.push_back(entry);
+      }
+      return snapshot;
+    }
+
+    [[nodiscard]] bool write_openmetrics(const char* path) const { return snapshot().write_openmetrics(path); }
+
+  private:
+    static constexpr std::size_t remote_slot = 1;
+
+    template<typename Owner> static constexpr std::size_t queue_slot(QueueKind kind) noexcept
+    {
+      if constexpr (std::is_void_v<Owner>) {
+        return kind == QueueKind::local ? 0 : remote_slot;
+      } else {
+        return 2 + index_of_v<Owner, Receivers...>;
+      }
+    }
+
+    template<typename Receiver, typename Event> static consteval std::size_t dispatch_slot()
+    {
+      return DispatchSlots<Receivers...>::template index<Receiver, Event>();
+    }
+
+    static constexpr auto& dispatch_labels = DispatchSlots<Receivers...>::labels;
+    static constexpr std::array<std::string_view, queue_slots> queue_labels{ "local",
+      "remote",
+      type_name<Receivers>()... };
+    static constexpr std::array<bool, queue_slots> queue_used{ true,
+      true,
+      (is_receiver<Receivers> && is_own_thread_v<Receivers>)... };
+
+    static void bump(const Lane& owner, std::atomic<std::uint64_t>& counter) noexcept
+    {
+      if (owner.shared) [[unlikely]] {
+        counter.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        single_writer_add(counter, 1);
+      }
+    }
+
+    static void raise(const Lane& owner, std::atomic<std::uint64_t>& mark, std::uint64_t value) noexcept
+    {
+      std::uint64_t current = mark.load(std::memory_order_relaxed);
+      if (owner.shared) [[unlikely]] {
+        while (value > current && !mark.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+      } else if (value > current) {
+        mark.store(value, std::memory_order_relaxed);
+      }
+    }
+
+    [[nodiscard]] Lane& lane() noexcept
+    {
+      if (const auto* cached = RegistryCache<Lane>::find(id_, 0)) [[likely]] { return *cached->record; }
+      Lane& claimed = claim_lane();
+      RegistryCache<Lane>::store(id_, 0, &claimed);
+      return claimed;
+    }
+
+    // First hook on a thread: find its lane (threads can come back after using another loop) or add one
+    [[nodiscard]] Lane& claim_lane() noexcept
+    {
+      const auto self = std::this_thread::get_id();
+      std::scoped_lock lock(claim_mutex_);
+      const std::size_t count = lane_count_.load(std::memory_order_relaxed);
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        if (lanes_[idx]->owner == self) { return *lanes_[idx]; }
+      }
+      if (count == max_lanes) { return shared_lane_; }
+      lanes_[count].reset(new (std::nothrow) Lane{});
+      if (!lanes_[count]) { return shared_lane_; }
+      lanes_[count]->owner = self;
+      lane_count_.store(count + 1, std::memory_order_release);
+      return *lanes_[count];
+    }
+
+    std::uint64_t id_ = metrics_registry_ids.fetch_add(1, std::memory_order_relaxed) + 1;
+    Lane shared_lane_;
+    std::array<std::unique_ptr<Lane>, max_lanes> lanes_{};
+    std::atomic<std::size_t> lane_count_{ 0 };
+    std::mutex claim_mutex_;
+  };
+
+  // =============================================================================
+  // Thread slots - one record per loop thread, found through a thread_local cache
+  // =============================================================================
+
+  // Slot provides owner and name (guarded by the table's mutex), a released flag, and start()/finish().
+  // start() runs on the owning thread under the mutex when it claims the slot; finish() runs under the mutex
+  // when its receiver stops, or for "loop" slots when the loop stops.
+  template<typename Slot> class ThreadSlots
+  {
+    static constexpr std::size_t max_slots = 64;
+
+  public:
+    // The calling thread's slot, claimed as "loop" on its first hook; nullptr beyond max_slots threads
+    [[nodiscard]] Slot* current() noexcept
+    {
+      const std::uint64_t epoch = epoch_.load(std::memory_order_acquire);
+      if (const auto* cached = RegistryCache<Slot>::find(id_, epoch)) [[likely]] { return cached->record; }
+      std::scoped_lock lock(mutex_);
+      Slot* claimed = claim_locked("loop");
+      cache_slot(claimed);
+      return claimed;
+    }
+
+    // Called by an OwnThread receiver's thread before its first hook: names its slot, starting afresh if an
+    // earlier run of the same receiver left one behind
+    void enter(std::string_view name) noexcept
+    {
+      std::scoped_lock lock(mutex_);
+      cache_slot(claim_locked(name));
+    }
+
+    // Called by an OwnThread receiver's thread on its way out: finishes the slot and frees it from its
+    // thread id, which the system may hand to a new thread
+    void leave() noexcept
+    {
+      Slot* claimed = current();
+      if (claimed == nullptr) { return; }
+      std::scoped_lock lock(mutex_);
+      claimed->finish();
+      claimed->released = true;
+      claimed->owner = std::thread::id{};
+      cache_slot(nullptr);
+    }
+
+    // Called when the loop stops: finishes the slots named name, which belong to threads that polled the loop
+    // and have no run loop of their own to leave(). Their next hook, if the loop runs again, starts afresh.
+    void close(std::string_view name) noexcept
+    {
+      std::scoped_lock lock(mutex_);
+      const std::size_t count = slot_count_.load(std::memory_order_relaxed);
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        Slot& each = *slots_[idx];
+        if (each.name == name && !each.released) {
+          each.finish();
+          each.released = true;
+        }
+      }
+      epoch_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Visits every slot under the mutex, so no slot is claimed or finished meanwhile
+    template<typename Visit> void for_each(Visit&& visit) const
+    {
+      std::scoped_lock lock(mutex_);
+      const std::size_t count = slot_count_.load(std::memory_order_relaxed);
+      for (std::size_t idx = 0; idx < count; ++idx) { visit(std::as_const(*slots_[idx])); }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return slot_count_.load(std::memory_order_acquire); }
+
+  private:
+    void cache_slot(Slot* claimed) noexcept
+    {
+      RegistryCache<Slot>::store(id_, epoch_.load(std::memory_order_relaxed), claimed);
+    }
+
+    // First hook on a thread: find its slot (threads can come back after using another loop), take over a
+    // released slot of the same name, or add one. Released slots start afresh. Threads beyond max_slots go
+    // unaccounted.
+    [[nodiscard]] Slot* claim_locked(std::string_view name) noexcept
+    {
+      const auto self = std::this_thread::get_id();
+      const std::size_t count = slot_count_.load(std::memory_order_relaxed);
+      Slot* reusable = nullptr;
+      for (std::size_t idx = 0; idx < count; ++idx) {
+        Slot& each = *slots_[idx];
+        if (each.owner == self) {
+          each.name = name;
+          if (each.released) { each.start(); }
+          return &each;
+        }
+        if (reusable == nullptr && each.name == name && each.released) { reusable = &each; }
+      }
+      if (reusable != nullptr) {
+        reusable->owner = self;
+        reusable->start();
+        return reusable;
+      }
+      if (count == max_slots) { return nullptr; }
+      slots_[count].reset(new (std::nothrow) Slot{});
+      if (!slots_[count]) { return nullptr; }
+      slots_[count]->owner = self;
+      slots_[count]->name = name;
+      slots_[count]->start();
+      slot_count_.store(count + 1, std::memory_order_release);
+      return slots_[count].get();
+    }
+
+    std::uint64_t id_ = metrics_registry_ids.fetch_add(1, std::memory_order_relaxed) + 1;
+    std::array<std::unique_ptr<Slot>, max_slots> slots_{};
+    std::atomic<std::size_t> slot_count_{ 0 };
+    std::atomic<std::uint64_t> epoch_{ 0 }; // bumped by close(), so polling threads claim their slot again
+    mutable std::mutex mutex_;
+  };
+
+} // namespace detail
+
+// =============================================================================
+// Utilization snapshot - where the wall time of each loop thread went
+// =============================================================================
+
+struct UtilizationSnapshot
+{
+  struct Thread
+  {
+    std::string_view name; // the OwnThread receiver's type, or "loop" for threads dispatching SameThread receivers
+    std::chrono::nanoseconds wall; // since the thread's first hook, up to now or its exit
+    std::chrono::nanoseconds handler; // inside on_event
+    std::chrono::nanoseconds parked; // blocked in a cv/eventfd/epoll wait or an inbox
+    std::chrono::nanoseconds spinning; // the rest: polling, spinning and yielding in strategies and pop_wait
+    std::chrono::nanoseconds cpu; // CLOCK_THREAD_CPUTIME_ID (Linux; zero elsewhere)
+    std::uint64_t dispatches;
+
+    // Share of wall time spent in handlers; close to 1 means the stage is saturated
+    [[nodiscard]] double busy() const noexcept { return share(handler); }
+
+    // Share of wall time spent awake without an event to handle
+    [[nodiscard]] double idle_spin() const noexcept { return share(spinning); }
+
+  private:
+    [[nodiscard]] double share(std::chrono::nanoseconds part) const noexcept
+    {
+      if (wall.count() <= 0) { return 0.0; }
+      return static_cast<double>(part.count()) / static_cast<double>(wall.count());
+    }
+  };
+
+  std::vector<Thread> threads;
+
+  [[nodiscard]] const Thread* thread(std::string_view name) const noexcept
+  {
+    const auto found = std::ranges::find(threads, name, &Thread::name);
+    return found == threads.end() ? nullptr : &*found;
+  }
+};
+
+namespace detail {
+
+  // =============================================================================
+  // Utilization registry - per-thread handler/parked time, from the observer hooks
+  // =============================================================================
+
+  class UtilizationRegistry : public NullObserver
+  {
+    // Time accounts of one thread, written only by that thread. Intervals still open carry their start
+    // tick (0 when closed) so a snapshot can include them.
+    // MSVC C4324: structure was padded due to alignment specifier (intentional for cache line separation)
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324)
+#endif
+    struct alignas(cache_line_size) Slot
+    {
+      // Guarded by the ThreadSlots mutex
+      std::thread::id owner;
+      std::string_view name{ "loop" };
+      bool released = false;
+#if EV_HAS_EVENTFD
+      clockid_t cpu_clock{};
+#endif
+
+      std::atomic<std::uint64_t> started{ 0 };
+      std::atomic<std::uint64_t> stopped{ 0 };
+      std::atomic<std::uint64_t> handler{ 0 };
+      std::atomic<std::uint64_t> parked{ 0 };
+      std::atomic<std::uint64_t> dispatch_since{ 0 };
+      std::atomic<std::uint64_t> park_since{ 0 };
+      std::atomic<std::uint64_t> dispatches{ 0 };
+      std::atomic<std::int64_t> cpu_at_exit{ 0 };
+
+      void start() noexcept
+      {
+        released = false;
+        started.store(TickClock::now(), std::memory_order_relaxed);
+        stopped.store(0, std::memory_order_relaxed);
+        handler.store(0, std::memory_order_relaxed);
+        parked.store(0, std::memory_order_relaxed);
+        dispatch_since.store(0, std::memory_order_relaxed);
+        park_since.store(0, std::memory_order_relaxed);
+        dispatches.store(0, std::memory_order_relaxed);
+        cpu_at_exit.store(0, std::memory_order_relaxed);
+#if EV_HAS_EVENTFD
+        if (::pthread_getcpuclockid(::pthread_self(), &cpu_clock) != 0) { cpu_clock = CLOCK_THREAD_CPUTIME_ID; }
+#endif
+      }
+
+      // Freezes wall and CPU time; the thread may be another one than the slot's when the loop stops
+      void finish() noexcept
+      {
+        cpu_at_exit.store(cpu_time(*this).count(), std::memory_order_relaxed);
+        stopped.store(TickClock::now(), std::memory_order_relaxed);
+      }
+    };
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+  public:
+    UtilizationRegistry() = default;
+
+    UtilizationRegistry(const UtilizationRegistry&) = delete;
+    UtilizationRegistry& operator=(const UtilizationRegistry&) = delete;
+    UtilizationRegistry(UtilizationRegistry&&) = delete;
+    UtilizationRegistry& operator=(UtilizationRegistry&&) = delete;
+    ~UtilizationRegistry() = default;
+
+    template<typename Receiver, typename Event> void on_dispatch_begin() noexcept
+    {
+      if (Slot* current = slots_.current()) [[likely]] {
+        current->dispatch_since.store(TickClock::now(), std::memory_order_relaxed);
+      }
+    }
+
+    template<typename Receiver, typename Event> void on_dispatch_end() noexcept
+    {
+      if (Slot* current = slots_.current()) [[likely]] {
+        close(current->dispatch_since, current->handler);
+        single_writer_add(current->dispatches, 1);
+      }
+    }
+
+    void on_park() noexcept
+    {
+      if (Slot* current = slots_.current()) [[likely]] {
+        current->park_since.store(TickClock::now(), std::memory_order_relaxed);
+      }
+    }
+
+    void on_unpark() noexcept
+    {
+      if (Slot* current = slots_.current()) [[likely]] { close(current->park_since, current->parked); }
+    }
+
+    // Called by an OwnThread receiver's thread before its first hook and on its way out
+    void enter_thread(std::string_view name) noexcept { slots_.enter(name); }
+    void leave_thread() noexcept { slots_.leave(); }
+
+    // Called by EventLoop::stop(): threads that polled the loop stop accruing wall time here
+    void close_loop_threads() noexcept { slots_.close("loop"); }
+
+    // Safe from any thread while the loop runs. Fields are read one at a time, so an interval that
+    // closes during the snapshot may be missed or counted in full.
+    [[nodiscard]] UtilizationSnapshot snapshot() const
+    {
+      const double ns_per_tick = TickClock::ns_per_tick();
+      const auto to_nanoseconds = [ns_per_tick](std::uint64_t ticks) {
+        return std::chrono::nanoseconds{ static_cast<std::int64_t>(
+          std::llround(static_cast<double>(ticks) * ns_per_tick)) };
+      };
+
+      const std::uint64_t now = TickClock::now();
+      const auto open_for = [now](const std::atomic<std::uint64_t>& since) -> std::uint64_t {
+        const std::uint64_t begin = since.load(std::memory_order_relaxed);
+        return begin != 0 && now > begin ? now - begin : 0;
+      };
+
+      UtilizationSnapshot snapshot;
+      snapshot.threads.reserve(slots_.size());
+      slots_.for_each([&](const Slot& each) {
+        const std::uint64_t stopped = each.stopped.load(std::memory_order_relaxed);
+        const std::uint64_t started = each.started.load(std::memory_order_relaxed);
+        const std::uint64_t end = stopped != 0 ? stopped : now;
+        const std::uint64_t wall = end > started ? end - started : 0;
+        std::uint64_t handler = each.handler.load(std::memory_order_relaxed);
+        std::uint64_t parked = each.parked.load(std::memory_order_relaxed);
+        if (stopped == 0) {
+          handler += open_for(each.dispatch_since);
+          parked += open_for(each.park_since);
+        }
+        UtilizationSnapshot::Thread thread{ .name = each.name,
+          .wall = to_nanoseconds(wall),
+          .handler = to_nanoseconds(handler),
+          .parked = to_nanoseconds(parked),
+          .spinning = {},
+          .cpu = stopped != 0 ? std::chrono::nanoseconds{ each.cpu_at_exit.load(std::memory_order_relaxed) }
+                              : cpu_time(each),
+          .dispatches = each.dispatches.load(std::memory_order_relaxed) };
+        thread.spinning = std::max(thread.wall - thread.handler - thread.parked, std::chrono::nanoseconds{ 0 });
+        snapshot.threads.push_back(thread);
+      });
+      return snapshot;
+    }
+
+  private:
+    static void close(std::atomic<std::uint64_t>& since, std::atomic<std::uint64_t>& total) noexcept
+    {
+      const std::uint64_t begin = since.load(std::memory_order_relaxed);
+      if (begin == 0) { return; }
+      const std::uint64_t end = TickClock::now();
+      if (end > begin) { single_writer_add(total, end - begin); }
+      since.store(0, std::memory_order_relaxed);
+    }
+
+#if EV_HAS_EVENTFD
+    [[nodiscard]] static std::chrono::nanoseconds read_cpu_clock(clockid_t clock) noexcept
+    {
+      timespec spec{};
+      if (::clock_gettime(clock, &spec) != 0) { return std::chrono::nanoseconds{ 0 }; }
+      return std::chrono::seconds{ spec.tv_sec } + std::chrono::nanoseconds{ spec.tv_nsec };
+    }
+#endif
+
+    // The CPU clock of a slot's thread, readable from any thread; zero once that thread has exited
+    [[nodiscard]] static std::chrono::nanoseconds cpu_time([[maybe_unused]] const Slot& each) noexcept
+    {
+#if EV_HAS_EVENTFD
+      return read_cpu_clock(each.cpu_clock);
+#else
+      return std::chrono::nanoseconds{ 0 };
+#endif
+    }
+
+    ThreadSlots<Slot> slots_;
+  };
+
+} // namespace detail
+
+// =============================================================================
+// Hardware counter snapshot - perf_event_open counts per loop thread
+// =============================================================================
+
+struct PerfCounterSnapshot
+{
+  struct Thread
+  {
+    std::string_view name; // the OwnThread receiver's type, or "loop" for threads dispatching SameThread receivers
+    // User-space counts since the thread's first hook, up to now or its exit; scaled up when the kernel had to
+    // multiplex the PMU. Empty when the counter could not be opened.
+    std::optional<std::uint64_t> cycles;
+    std::optional<std::uint64_t> instructions;
+    std::optional<std::uint64_t> llc_misses; // PERF_COUNT_HW_CACHE_MISSES, last-level cache on most CPUs
+    std::optional<std::uint64_t> branch_misses;
+
+    [[nodiscard]] bool available() const noexcept
+    {
+      return cycles.has_value() || instructions.has_value() || llc_misses.has_value() || branch_misses.has_value();
+    }
+
+    // Instructions per cycle
+    [[nodiscard]] std::optional<double> ipc() const noexcept
+    {
+      if (!cycles || !instructions || *cycles == 0) { return std::nullopt; }
+      return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+    }
+  };
+
+  std::vector<Thread> threads;
+
+  [[nodiscard]] const Thread* thread(std::string_view name) const noexcept
+  {
+    const auto found = std::ranges::find(threads, name, &Thread::name);
+    return found == threads.end() ? nullptr : &*found;
+  }
+
+  // Plain-text table, one thread per line. With a non-zero event count each counter is divided by it,
+  // so runs of different length compare. Counters that could not be opened show as n/a.
+  [[nodiscard]] std::string table(std::uint64_t events = 0) const
+  {
+    const bool per_event = events != 0;
+    std::string out;
+    std::array<char, 32> cell{};
+    const auto put = [&](int written) {
+      if (written > 0) { out.append(cell.data(), std::min(static_cast<std::size_t>(written), cell.size() - 1)); }
+    };
+    const auto heading = [&](const char* title) {
+      put(std::snprintf(cell.data(), cell.size(), per_event ? "%11s  " : "%15s  ", title));
+    };
+    const auto counter = [&](const std::optional<std::uint64_t>& value) {
+      if (!value) {
+        heading("n/a");
+      } else if (per_event) {
+        put(std::snprintf(
+          cell.data(), cell.size(), "%11.2f  ", static_cast<double>(*value) / static_cast<double>(events)));
+      } else {
+        // NOLINTNEXTLINE(google-runtime-int) - matches the printf conversion
+        put(std::snprintf(cell.data(), cell.size(), "%15llu  ", static_cast<unsigned long long>(*value)));
+      }
+    };
+
+    heading(per_event ? "cycles/ev" : "cycles");
+    heading(per_event ? "instr/ev" : "instructions");
+    put(std::snprintf(cell.data(), cell.size(), "%5s  ", "IPC"));
+    heading(per_event ? "LLC miss/ev" : "LLC misses");
+    heading(per_event ? "br miss/ev" : "branch misses");
+    out += "thread\n";
+    for (const Thread& thread : threads) {
+      counter(thread.cycles);
+      counter(thread.instructions);
+      if (const auto ipc = thread.ipc()) {
+        put(std::snprintf(cell.data(), cell.size(), "%5.2f  ", *ipc));
+      } else {
+        put(std::snprintf(cell.data(), cell.size(), "%5s  ", "n/a"));
+      }
+      counter(thread.llc_misses);
+      counter(thread.branch_misses);
+      out += thread.name;
+      out += '\n';
+    }
+    return out;
+  }
+};
+
+namespace detail {
+
+  // =============================================================================
+  // Thread counters - perf_event_open on the calling thread
+  // =============================================================================
+
+  // Counts the calling thread, user space only, so the default perf_event_paranoid of 2 allows it. With a
+  // group_fd the counter joins that group, which the kernel puts on the PMU as a whole. Returns -1 when the
+  // kernel refuses: no permission, no PMU, or a counter the CPU lacks.
+  [[nodiscard]] inline int open_thread_counter([[maybe_unused]] std::uint64_t config,
+    [[maybe_unused]] std::uint64_t read_format,
+    [[maybe_unused]] int group_fd = -1) noexcept
+  {
+#if EV_HAS_PERF_EVENTS
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.read_format = read_format;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    const long result = ::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+    return result < 0 ? -1 : static_cast<int>(result);
+#else
+    return -1;
+#endif
+  }
+
+  // Cycles and instructions of the calling thread as one group, read together with a single read(2). Used by
+  // Profile<Period, Jitter, true> around sampled dispatches; opened on a thread's first sample, closed when
+  // the thread exits.
+  class ThreadCycleCounter
+  {
+  public:
+    struct Reading
+    {
+      std::uint64_t cycles = 0;
+      std::uint64_t instructions = 0;
+      std::uint64_t enabled = 0; // ns the group was enabled, and on the PMU
+      std::uint64_t running = 0;
+    };
+
+    [[nodiscard]] static ThreadCycleCounter& local() noexcept
+    {
+      thread_local ThreadCycleCounter counter;
+      return counter;
+    }
+
+    ThreadCycleCounter(const ThreadCycleCounter&) = delete;
+    ThreadCycleCounter& operator=(const ThreadCycleCounter&) = delete;
+    ThreadCycleCounter(ThreadCycleCounter&&) = delete;
+    ThreadCycleCounter& operator=(ThreadCycleCounter&&) = delete;
+
+    ~ThreadCycleCounter()
+    {
+#if EV_HAS_PERF_EVENTS
+      if (instructions_ >= 0) { ::close(instructions_); }
+      if (cycles_ >= 0) { ::close(cycles_); }
+#endif
+    }
+
+    // False when the counters could not be opened or read
+    [[nodiscard]] bool read([[maybe_unused]] Reading& out) const noexcept
+    {
+#if EV_HAS_PERF_EVENTS
+      if (instructions_ < 0) { return false; }
+      struct
+      {
+        std::uint64_t count;
+        std::uint64_t enabled;
+        std::uint64_t running;
+        std::array<std::uint64_t, 2> values;
+      } group{};
+      if (::read(cycles_, &group, sizeof(group)) != static_cast<ssize_t>(sizeof(group)) || group.count != 2) {
+        return false;
+      }
+      out = { .cycles = group.values[0],
+        .instructions = group.values[1],
+        .enabled = group.enabled,
+        .running = group.running };
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    // Counts between two readings, scaled up when the group was off the PMU for part of the time; false
+    // when it was off the whole time
+    [[nodiscard]] static bool delta(const Reading& before,
+      const Reading& after,
+      std::uint64_t& cycles,
+      std::uint64_t& instructions) noexcept
+    {
+      const std::uint64_t running = after.running - before.running;
+      if (running == 0) { return false; }
+      cycles = after.cycles - before.cycles;
+      instructions = after.instructions - before.instructions;
+      const std::uint64_t enabled = after.enabled - before.enabled;
+      if (enabled > running) {
+        const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+        cycles = static_cast<std::uint64_t>(static_cast<double>(cycles) * scale);
+        instructions = static_cast<std::uint64_t>(static_cast<double>(instructions) * scale);
+      }
+      return true;
+    }
+
+  private:
+    ThreadCycleCounter() noexcept
+    {
+#if EV_HAS_PERF_EVENTS
+      constexpr std::uint64_t format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      cycles_ = open_thread_counter(PERF_COUNT_HW_CPU_CYCLES, format);
+      if (cycles_ >= 0) { instructions_ = open_thread_counter(PERF_COUNT_HW_INSTRUCTIONS, format, cycles_); }
+#endif
+    }
+
+    int cycles_ = -1; // group leader
+    int instructions_ = -1;
+  };
+
+  // =============================================================================
+  // Perf counter registry - one perf_event_open counter set per loop thread
+  // =============================================================================
+
+  class PerfCounterRegistry : public NullObserver
+  {
+    static constexpr std::size_t counter_count = 4;
+    using Counts = std::array<std::optional<std::uint64_t>, counter_count>;
+
+    struct Slot
+    {
+      // Guarded by the ThreadSlots mutex, like everything below: the fds are only opened, read and
+      // closed under it
+      std::thread::id owner;
+      std::string_view name{ "loop" };
+      bool released = false;
+      std::array<int, counter_count> fds{ -1, -1, -1, -1 };
+      Counts at_exit{};
+
+      Slot() = default;
+      Slot(const Slot&) = delete;
+      Slot& operator=(const Slot&) = delete;
+      Slot(Slot&&) = delete;
+      Slot& operator=(Slot&&) = delete;
+      ~Slot() { close_all(); }
+
+      // Runs on the owning thread: the counters follow it from here on
+      void start() noexcept
+      {
+        close_all();
+        released = false;
+        at_exit = {};
+        for (std::size_t idx = 0; idx < counter_count; ++idx) { fds[idx] = open_counter(idx); }
+      }
+
+      void finish() noexcept
+      {
+        at_exit = read();
+        close_all();
+      }
+
+      [[nodiscard]] Counts read() const noexcept
+      {
+        if (released) { return at_exit; }
+        Counts counts{};
+        for (std::size_t idx = 0; idx < counter_count; ++idx) { counts[idx] = read_counter(fds[idx]); }
+        return counts;
+      }
+
+      void close_all() noexcept
+      {
+        for (int& fd : fds) {
+#if EV_HAS_PERF_EVENTS
+          if (fd >= 0) { ::close(fd); }
+#endif
+          fd = -1;
+        }
+      }
+    };
+
+  public:
+    PerfCounterRegistry() = default;
+
+    PerfCounterRegistry(const PerfCounterRegistry&) = delete;
+    PerfCounterRegistry& operator=(const PerfCounterRegistry&) = delete;
+    PerfCounterRegistry(PerfCounterRegistry&&) = delete;
+    PerfCounterRegistry& operator=(PerfCounterRegistry&&) = delete;
+    ~PerfCounterRegistry() = default;
+
+    // Only the first hook on a thread does work: it opens that thread's counters
+    template<typename Receiver, typename Event> void on_dispatch_begin() noexcept
+    {
+      [[maybe_unused]] Slot* current = slots_.current();
+    }
+
+    void on_park() noexcept { [[maybe_unused]] Slot* current = slots_.current(); }
+
+    // Called by an OwnThread receiver's thread before its first hook and on its way out, which reads the
+    // final counts and closes the counters
+    void enter_thread(std::string_view name) noexcept { slots_.enter(name); }
+    void leave_thread() noexcept { slots_.leave(); }
+
+    // Called by EventLoop::stop(): freezes the counts of threads that polled the loop
+    void close_loop_threads() noexcept { slots_.close("loop"); }
+
+    // Safe from any thread: reading a counter is a read(2) on its fd, which the kernel keeps in sync with
+    // the counted thread
+    [[nodiscard]] PerfCounterSnapshot snapshot() const
+    {
+      PerfCounterSnapshot snapshot;
+      snapshot.threads.reserve(slots_.size());
+      slots_.for_each([&](const Slot& each) {
+        const Counts counts = each.read();
+        snapshot.threads.push_back({ .name = each.name,
+          .cycles = counts[0],
+          .instructions = counts[1],
+          .llc_misses = counts[2],
+          .branch_misses = counts[3] });
+      });
+      return snapshot;
+    }
+
+  private:
+    [[nodiscard]] static int open_counter([[maybe_unused]] std::size_t counter) noexcept
+    {
+#if EV_HAS_PERF_EVENTS
+      constexpr std::array<std::uint64_t, counter_count> configs{ PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES };
+      return open_thread_counter(configs[counter], PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING);
+#else
+      return -1;
+#endif
+    }
+
+    [[nodiscard]] static std::optional<std::uint64_t> read_counter([[maybe_unused]] int fd) noexcept
+    {
+#if EV_HAS_PERF_EVENTS
+      if (fd < 0) { return std::nullopt; }
+      struct
+      {
+        std::uint64_t value;
+        std::uint64_t enabled;
+        std::uint64_t running;
+      } reading{};
+      if (::read(fd, &reading, sizeof(reading)) != static_cast<ssize_t>(sizeof(reading))) { return std::nullopt; }
+      if (reading.running == 0 || reading.running >= reading.enabled) { return reading.value; }
+      // Multiplexed: extrapolate from the share of time the counter was on the PMU
+      return static_cast<std::uint64_t>(static_cast<double>(reading.value) * static_cast<double>(reading.enabled)
+                                        / static_cast<double>(reading.running));
+#else
+      return std::nullopt;
+#endif
+    }
+
+    ThreadSlots<Slot> slots_;
+  };
+
+  // Observer that feeds each built-in registry in turn and then the user's Observe policy
+  template<typename... Parts> struct ObserverSet : NullObserver
+  {
+    std::tuple<Parts...> parts;
+
+    template<typename Part> [[nodiscard]] Part& get() noexcept { return std::get<Part>(parts); }
+    template<typename Part> [[nodiscard]] const Part& get() const noexcept { return std::get<Part>(parts); }
+
+    template<typename Owner, typename Event> void on_enqueue(QueueKind kind, std::size_t depth) noexcept
+    {
+      (get<Parts>().template on_enqueue<Owner, Event>(kind, depth), ...);
+    }
+
+    template<typename Owner, typename Event> void on_dequeue(QueueKind kind) noexcept
+    {
+      (get<Parts>().template on_dequeue<Owner, Event>(kind), ...);
+    }
+
+    template<typename Owner, typename Event> void on_drop(QueueKind kind) noexcept
+    {
+      (get<Parts>().template on_drop<Owner, Event>(kind), ...);
+    }
+
+    template<typename Receiver, typename Event> void on_dispatch_begin() noexcept
+    {
+      (get<Parts>().template on_dispatch_begin<Receiver, Event>(), ...);
+    }
+
+    template<typename Receiver, typename Event> void on_dispatch_end() noexcept
+    {
+      (get<Parts>().template on_dispatch_end<Receiver, Event>(), ...);
+    }
+
+    void on_park() noexcept { (get<Parts>().on_park(), ...); }
+
+    void on_unpark() noexcept { (get<Parts>().on_unpark(), ...); }
+  };
+
+  // The Observe policy alone when no registry is enabled, so a plain Observe loop pays nothing extra
+  template<typename Policy, typename Registries> struct observer_set;
+
+  template<typename Policy> struct observer_set<Policy, type_list<>>
+  {
+    using type = Policy;
+  };
+
+  template<typename Policy, typename First, typename... Rest> struct observer_set<Policy, type_list<First, Rest...>>
+  {
+    using type = ObserverSet<First, Rest..., Policy>;
+  };
+
+  template<bool WithMetrics, bool WithUtilization, bool WithPerfCounters, typename Policy, typename... Receivers>
+  struct hooks_for
+  {
+    using registries =
+      typename concat_type_lists<std::conditional_t<WithMetrics, type_list<MetricsRegistry<Receivers...>>, type_list<>>,
+        std::conditional_t<WithUtilization, type_list<UtilizationRegistry>, type_list<>>,
+        std::conditional_t<WithPerfCounters, type_list<PerfCounterRegistry>, type_list<>>>::type;
+    using type = typename observer_set<Policy, registries>::type;
+  };
+
+  template<typename... Receivers> class LatencyRegistry;
+
+} // namespace detail
+
+// =============================================================================
+// Latency histograms - log-linear buckets over TickClock ticks
+// =============================================================================
+
+// HDR-style histogram: values below 32 ticks get their own bucket, above that every power of two
+// is split into 16 linear sub-buckets, so a reported value is at most 1/16 above the true one.
+// Histograms from different receivers, loops or threads merge by adding bucket counts.
+class LatencyHistogram
+{
+public:
+  static constexpr unsigned sub_bucket_bits = 4;
+  static constexpr std::size_t sub_bucket_count = std::size_t{ 1 } << sub_bucket_bits;
+  // Ticks above 2^48 (about a day of TSC ticks) land in the last bucket
+  static constexpr unsigned max_value_bits = 48;
+  static constexpr std::size_t bucket_count =
+    ((max_value_bits - sub_bucket_bits) * sub_bucket_count) + sub_bucket_count;
+
+  [[nodiscard]] static constexpr std::size_t bucket_of(std::uint64_t ticks) noexcept
+  {
+    constexpr std::uint64_t max_ticks = (std::uint64_t{ 1 } << max_value_bits) - 1;
+    const std::uint64_t value = std::min(ticks, max_ticks);
+    const auto top_bit = static_cast<unsigned>(std::bit_width(value));
+    const unsigned shift = top_bit > sub_bucket_bits + 1 ? top_bit - sub_bucket_bits - 1 : 0;
+    return (shift * sub_bucket_count) + (value >> shift);
+  }
+
+  // Largest tick value that maps to bucket
+  [[nodiscard]] static constexpr std::uint64_t bucket_upper(std::size_t bucket) noexcept
+  {
+    if (bucket < 2 * sub_bucket_count) { return bucket; }
+    const auto shift = static_cast<unsigned>((bucket / sub_bucket_count) - 1);
+    const std::uint64_t sub = bucket - (shift * sub_bucket_count);
+    return ((sub + 1) << shift) - 1;
+  }
+
+  void record(std::uint64_t ticks) noexcept
+  {
+    ++counts_[bucket_of(ticks)];
+    ++total_;
+  }
+
+  void merge(const LatencyHistogram& other) noexcept
+  {
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) { counts_[bucket] += other.counts_[bucket]; }
+    total_ += other.total_;
+  }
+
+  [[nodiscard]] std::uint64_t count() const noexcept { return total_; }
+
+  [[nodiscard]] std::uint64_t count_in_bucket(std::size_t bucket) const noexcept { return counts_[bucket]; }
+
+  // Value at or below which `fraction` of the samples fall (0.5 = p50, 0.999 = p99.9); zero when empty
+  [[nodiscard]] std::chrono::nanoseconds percentile(double fraction) const noexcept
+  {
+    if (total_ == 0) { return std::chrono::nanoseconds{ 0 }; }
+    const auto wanted = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total_))));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+      seen += counts_[bucket];
+      if (seen >= wanted) { return to_nanoseconds(bucket_upper(bucket)); }
+    }
+    return to_nanoseconds(bucket_upper(bucket_count - 1));
+  }
+
+  [[nodiscard]] std::chrono::nanoseconds max() const noexcept { return percentile(1.0); }
+
+private:
+  template<typename...> friend class detail::LatencyRegistry;
+
+  [[nodiscard]] static std::chrono::nanoseconds to_nanoseconds(std::uint64_t ticks) noexcept
+  {
+    return std::chrono::nanoseconds{ static_cast<std::int64_t>(
+      std::llround(static_cast<double>(ticks) * detail::TickClock::ns_per_tick())) };
+  }
+
+  std::array<std::uint64_t, bucket_count> counts_{};
+  std::uint64_t total_ = 0;
+};
+
+// Where a receiver's events spend their time: waiting in a queue, then in the handler
+struct ReceiverLatency
+{
+  LatencyHistogram queue_wait;
+  LatencyHistogram handler;
+
+  void merge(const ReceiverLatency& other) noexcept
+  {
+    queue_wait.merge(other.queue_wait);
+    handler.merge(other.handler);
+  }
+};
+
+namespace detail {
+
+  // Per-receiver histogram pairs. Each receiver is dispatched by exactly one thread (the loop
+  // thread, or its own), so every counter has a single writer and readers only need relaxed loads.
+  template<typename... Receivers> class LatencyRegistry
+  {
+    struct SharedHistogram
+    {
+      std::array<std::atomic<std::uint64_t>, LatencyHistogram::bucket_count> counts{};
+      std::atomic<std::uint64_t> total{ 0 };
+
+      void record(std::uint64_t ticks) noexcept
+      {
+        auto& bucket = counts[LatencyHistogram::bucket_of(ticks)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      }
+
+      void copy_to(LatencyHistogram& out) const noexcept
+      {
+        for (std::size_t bucket = 0; bucket < LatencyHistogram::bucket_count; ++bucket) {
+          out.counts_[bucket] = counts[bucket].load(std::memory_order_relaxed);
+        }
+        // Sum of the copied buckets, so a snapshot taken mid-record stays self-consistent
+        out.total_ = 0;
+        for (const auto value : out.counts_) { out.total_ += value; }
+      }
+    };
+
+    struct Entry
+    {
+      SharedHistogram queue_wait;
+      SharedHistogram handler;
+    };
+
+  public:
+    LatencyRegistry() { std::ignore = TickClock::tsc(); }
+
+    template<typename Receiver> void record(std::uint64_t stamp, std::uint64_t begin, std::uint64_t end) noexcept
+    {
+      auto& entry = (*entries_)[index_of_v<Receiver, Receivers...>];
+      // A stamp taken on another core can read marginally ahead; clamp instead of wrapping
+      entry.queue_wait.record(begin > stamp ? begin - stamp : 0);
+      entry.handler.record(end - begin);
+    }
+
+    // Copy of one receiver's histograms; safe from any thread while the loop runs
+    template<typename Receiver> [[nodiscard]] ReceiverLatency snapshot() const
+    {
+      static_assert(contains_v<type_list<Receivers...>, Receiver>, "Receiver is not part of this loop");
+      return snapshot_at(index_of_v<Receiver, Receivers...>);
+    }
+
+    // All receivers merged into one pair
+    [[nodiscard]] ReceiverLatency merged() const
+    {
+      ReceiverLatency total;
+      for (std::size_t idx = 0; idx < sizeof...(Receivers); ++idx) { total.merge(snapshot_at(idx)); }
+      return total;
+    }
+
+  private:
+    [[nodiscard]] ReceiverLatency snapshot_at(std::size_t idx) const
+    {
+      ReceiverLatency copy;
+      (*entries_)[idx].queue_wait.copy_to(copy.queue_wait);
+      (*entries_)[idx].handler.copy_to(copy.handler);
+      return copy;
+    }
+
+    // Heap-allocated: a histogram pair is ~11 KiB per receiver
+    std::unique_ptr<std::array<Entry, sizeof...(Receivers)>> entries_ =
+      std::make_unique<std::array<Entry, sizeof...(Receivers)>>();
+  };
+
+  struct NoLatency
+  {
+  };
+
+} // namespace detail
+
+// =============================================================================
+// Sampling profiler - handler cost per receiver and event type (Profile option)
+// =============================================================================
+
+struct ProfileSnapshot
+{
+  struct Entry
+  {
+    std::string_view receiver;
+    std::string_view event;
+    std::uint64_t dispatches;
+    std::uint64_t samples;
+    std::chrono::nanoseconds mean; // over the sampled dispatches
+    std::chrono::nanoseconds max; // longest sampled dispatch
+    std::chrono::nanoseconds estimated_total; // mean * dispatches
+    // Means over the sampled dispatches the PMU counted; empty without Profile's Counters or without a PMU
+    std::optional<double> cycles;
+    std::optional<double> instructions;
+  };
+
+  // Most expensive first; pairs that were never dispatched are left out
+  std::vector<Entry> entries;
+
+  [[nodiscard]] const Entry* find(std::string_view receiver, std::string_view event) const noexcept
+  {
+    const auto found = std::ranges::find_if(
+      entries, [&](const Entry& entry) { return entry.receiver == receiver && entry.event == event; });
+    return found == entries.end() ? nullptr : &*found;
+  }
+
+  // Ranked plain-text table of the top entries, one handler per line
+  [[nodiscard]] std::string table(std::size_t top = 20) const // NOLINT(readability-magic-numbers)
+  {
+    std::chrono::nanoseconds total{ 0 };
+    for (const auto& entry : entries) { total += entry.estimated_total; }
+    const bool counted = std::ranges::any_of(entries, [](const Entry& entry) { return entry.cycles.has_value(); });
+    std::string out = " #   share     total ms      mean ns       max ns    dispatches     samples  ";
+    out += counted ? "    cycles  instructions  handler\n" : "handler\n";
+    std::array<char, 128> line{};
+    constexpr double percent = 100.0;
+    constexpr double ns_per_ms = 1e6;
+    const double whole = static_cast<double>(total.count());
+    for (std::size_t rank = 0; rank < std::min(top, entries.size()); ++rank) {
+      const Entry& entry = entries[rank];
+      const double cost = static_cast<double>(entry.estimated_total.count());
+      const double share = whole > 0.0 ? percent * cost / whole : 0.0;
+      // NOLINTBEGIN(google-runtime-int) - matches the printf conversions
+      const int written = std::snprintf(line.data(),
+        line.size(),
+        "%2zu  %5.1f%%  %11.3f  %11lld  %11lld  %12llu  %10llu  ",
+        rank + 1,
+        share,
+        static_cast<double>(entry.estimated_total.count()) / ns_per_ms,
+        static_cast<long long>(entry.mean.count()),
+        static_cast<long long>(entry.max.count()),
+        static_cast<unsigned long long>(entry.dispatches),
+        static_cast<unsigned long long>(entry.samples));
+      // NOLINTEND(google-runtime-int)
+      if (written > 0) { out.append(line.data(), std::min(static_cast<std::size_t>(written), line.size() - 1)); }
+      if (counted) {
+        const int cells =
+          entry.cycles && entry.instructions
+            ? std::snprintf(line.data(), line.size(), "%10.0f  %12.0f  ", *entry.cycles, *entry.instructions)
+            : std::snprintf(line.data(), line.size(), "%10s  %12s  ", "n/a", "n/a");
+        if (cells > 0) { out.append(line.data(), std::min(static_cast<std::size_t>(cells), line.size() - 1)); }
+      }
+      out += entry.receiver;
+      out += " <- ";
+      out += entry.event;
+      out += '\n';
+    }
+    return out;
+  }
+};
+
+namespace detail {
+
+  template<typename T> struct is_profile_option : std::false_type
+  {
+  };
+
+  template<std::uint32_t Period, bool Jitter, bool Counters>
+  struct is_profile_option<Profile<Period, Jitter, Counters>> : std::true_type
+  {
+  };
+
+  template<typename Option, typename... Receivers> class ProfileRegistry
+  {
+    using slots = DispatchSlots<Receivers...>;
+
+    // One (receiver, event) pair, written only by the thread dispatching that receiver.
+    // MSVC C4324: structure was padded due to alignment specifier (intentional for cache line separation)
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324)
+#endif
+    struct alignas(cache_line_size) Stats
+    {
+      std::atomic<std::uint64_t> dispatches{ 0 };
+      std::atomic<std::uint64_t> samples{ 0 };
+      std::atomic<std::uint64_t> ticks{ 0 };
+      std::atomic<std::uint64_t> max_ticks{ 0 };
+      std::atomic<std::uint64_t> counted{ 0 }; // samples with cycles and instructions (Counters only)
+      std::atomic<std::uint64_t> cycles{ 0 };
+      std::atomic<std::uint64_t> instructions{ 0 };
+    };
+
+    // Sampling countdown of one receiver; owner thread only
+    struct alignas(cache_line_size) Countdown
+    {
+      std::uint64_t remaining = 1;
+      std::uint32_t random = 0;
+    };
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+  public:
+    ProfileRegistry()
+    {
+      std::ignore = TickClock::tsc();
+      // Distinct non-zero xorshift seeds; the first sample lands somewhere in the first period
+      constexpr std::uint32_t golden = 0x9E3779B9U;
+      for (std::size_t idx = 0; idx < sizeof...(Receivers); ++idx) {
+        auto& countdown = (*countdowns_)[idx];
+        countdown.random = golden * static_cast<std::uint32_t>(idx + 1);
+        countdown.remaining = next_gap(countdown);
+      }
+    }
+
+    // Runs one dispatch, timing it if the receiver's countdown expires
+    template<typename Receiver, typename Event, typename Handler> void run(Handler&& handler)
+    {
+      Stats& stats = (*stats_)[slots::template index<Receiver, Event>()];
+      single_writer_add(stats.dispatches, 1);
+      Countdown& countdown = (*countdowns_)[index_of_v<Receiver, Receivers...>];
+      if (--countdown.remaining != 0) [[likely]] {
+        std::forward<Handler>(handler)();
+        return;
+      }
+      countdown.remaining = next_gap(countdown);
+      if constexpr (Option::counters) {
+        // The counter reads stay outside the timed window
+        const ThreadCycleCounter& counter = ThreadCycleCounter::local();
+        ThreadCycleCounter::Reading before;
+        const bool started = counter.read(before);
+        sample(stats, std::forward<Handler>(handler));
+        ThreadCycleCounter::Reading after;
+        std::uint64_t cycles = 0;
+        std::uint64_t instructions = 0;
+        if (started && counter.read(after) && ThreadCycleCounter::delta(before, after, cycles, instructions)) {
+          single_writer_add(stats.counted, 1);
+          single_writer_add(stats.cycles, cycles);
+          single_writer_add(stats.instructions, instructions);
+        }
+      } else {
+        sample(stats, std::forward<Handler>(handler));
+      }
+    }
+
+    // Safe from any thread while the loop runs
+    [[nodiscard]] ProfileSnapshot snapshot() const
+    {
+      const double ns_per_tick = TickClock::ns_per_tick();
+      const auto to_nanoseconds = [ns_per_tick](double ticks) {
+        return std::chrono::nanoseconds{ static_cast<std::int64_t>(std::llround(ticks * ns_per_tick)) };
+      };
+      const auto mean_of = [](std::uint64_t total, std::uint64_t count) -> std::optional<double> {
+        if (count == 0) { return std::nullopt; }
+        return static_cast<double>(total) / static_cast<double>(count);
+      };
+      ProfileSnapshot snapshot;
+      for (std::size_t slot = 0; slot < slots::count; ++slot) {
+        const Stats& stats = (*stats_)[slot];
+        const std::uint64_t dispatches = stats.dispatches.load(std::memory_order_relaxed);
+        if (dispatches == 0) { continue; }
+        const std::uint64_t samples = stats.samples.load(std::memory_order_relaxed);
+        const double mean = mean_of(stats.ticks.load(std::memory_order_relaxed), samples).value_or(0.0);
+        const std::uint64_t counted = stats.counted.load(std::memory_order_relaxed);
+        snapshot.entries.push_back({ .receiver = slots::labels[slot].first,
+          .event = slots::labels[slot].second,
+          .dispatches = dispatches,
+          .samples = samples,
+          .mean = to_nanoseconds(mean),
+          .max = to_nanoseconds(static_cast<double>(stats.max_ticks.load(std::memory_order_relaxed))),
+          .estimated_total = to_nanoseconds(mean * static_cast<double>(dispatches)),
+          .cycles = mean_of(stats.cycles.load(std::memory_order_relaxed), counted),
+          .instructions = mean_of(stats.instructions.load(std::memory_order_relaxed), counted) });
+      }
+      std::ranges::stable_sort(snapshot.entries, std::ranges::greater{}, &ProfileSnapshot::Entry::estimated_total);
+      return snapshot;
+    }
+
+  private:
+    // One timed dispatch
+    template<typename Handler> static void sample(Stats& stats, Handler&& handler)
+    {
+      const std::uint64_t begin = TickClock::now();
+      std::forward<Handler>(handler)();
+      const std::uint64_t end = TickClock::now();
+      const std::uint64_t ticks = end > begin ? end - begin : 0;
+      single_writer_add(stats.samples, 1);
+      single_writer_add(stats.ticks, ticks);
+      if (ticks > stats.max_ticks.load(std::memory_order_relaxed)) {
+        stats.max_ticks.store(ticks, std::memory_order_relaxed);
+      }
+    }
+
+    [[nodiscard]] static std::uint64_t next_gap(Countdown& countdown) noexcept
+    {
+      if constexpr (!Option::jitter) {
+        return Option::period;
+      } else {
+        // xorshift32: cheap, and only run once per sample
+        std::uint32_t value = countdown.random;
+        value ^= value << 13U;
+        value ^= value >> 17U;
+        value ^= value << 5U;
+        countdown.random = value;
+        return 1 + (value % (2 * std::uint64_t{ Option::period } - 1));
+      }
+    }
+
+    // Heap-allocated: one cache line per (receiver, event) pair and per receiver
+    std::unique_ptr<std::array<Stats, slots::count>> stats_ = std::make_unique<std::array<Stats, slots::count>>();
+    std::unique_ptr<std::array<Countdown, sizeof...(Receivers)>> countdowns_ =
+      std::make_unique<std::array<Countdown, sizeof...(Receivers)>>();
+  };
+
+  struct NoProfile
+  {
+  };
+
+} // namespace detail
+
+// =============================================================================
+// Allocation tracking - heap allocations per handler and emit (AllocationTracking option)
+// =============================================================================
+
+enum class AllocationSite : std::uint8_t {
+  dispatch, // inside a handler: source is the receiver, event the type it handles
+  emit, // inside an emit: source is the emitting receiver or external emitter, event the type emitted
+};
+
+struct AllocationSnapshot
+{
+  struct Entry
+  {
+    AllocationSite site;
+    std::string_view source;
+    std::string_view event;
+    std::uint64_t allocations;
+    std::uint64_t deallocations;
+    std::uint64_t bytes; // requested by the allocations
+  };
+
+  // Most allocations first; pairs that never allocated or freed are left out
+  std::vector<Entry> entries;
+
+  [[nodiscard]] const Entry* find(AllocationSite site, std::string_view source, std::string_view event) const noexcept
+  {
+    const auto found = std::ranges::find_if(entries, [&](const Entry& entry) {
+      return entry.site == site && entry.source == source && entry.event == event;
+    });
+    return found == entries.end() ? nullptr : &*found;
+  }
+
+  [[nodiscard]] std::uint64_t allocations() const noexcept
+  {
+    std::uint64_t total = 0;
+    for (const auto& entry : entries) { total += entry.allocations; }
+    return total;
+  }
+
+  // Plain-text table of the top entries, one pair per line
+  [[nodiscard]] std::string table(std::size_t top = 20) const // NOLINT(readability-magic-numbers)
+  {
+    std::string out = "    allocations  deallocations          bytes  site      pair\n";
+    std::array<char, 96> line{};
+    for (std::size_t rank = 0; rank < std::min(top, entries.size()); ++rank) {
+      const Entry& entry = entries[rank];
+      // NOLINTBEGIN(google-runtime-int) - matches the printf conversions
+      const int written = std::snprintf(line.data(),
+        line.size(),
+        "%15llu  %13llu  %13llu  %-8s  ",
+        static_cast<unsigned long long>(entry.allocations),
+        static_cast<unsigned long long>(entry.deallocations),
+        static_cast<unsigned long long>(entry.bytes),
+        entry.site == AllocationSite::dispatch ? "dispatch" : "emit");
+      // NOLINTEND(google-runtime-int)
+      if (written > 0) { out.append(line.data(), std::min(static_cast<std::size_t>(written), line.size() - 1)); }
+      out += entry.source;
+      out += entry.site == AllocationSite::dispatch ? " <- " : " -> ";
+      out += entry.event;
+      out += '\n';
+    }
+    return out;
+  }
+};
+
+// Called for each allocation while a no_alloc receiver's handler runs; must not throw. Allocations made by the
+// handler itself are not tracked.
+using NoAllocHandler = void (*)(std::string_view receiver, std::string_view event, std::size_t bytes);
+
+namespace detail {
+
+  struct AllocationCounters
+  {
+    std::atomic<std::uint64_t> allocations{ 0 };
+    std::atomic<std::uint64_t> deallocations{ 0 };
+    std::atomic<std::uint64_t> bytes{ 0 };
+  };
+
+  // The handler or emit running on a thread; receiver/event name the no_alloc handler when no_alloc is set
+  struct AllocationScope
+  {
+    AllocationCounters* counters;
+    std::string_view receiver;
+    std::string_view event;
+    bool no_alloc;
+  };
+
+  // nullptr outside tracked handlers and emits
+  inline thread_local AllocationScope* allocation_scope = nullptr;
+
+  [[noreturn]] inline void abort_on_allocation(std::string_view receiver, std::string_view event, std::size_t bytes)
+  {
+    std::fprintf(stderr,
+      "ev_loop: %zu-byte allocation in no_alloc receiver %.*s handling %.*s\n",
+      bytes,
+      static_cast<int>(receiver.size()),
+      receiver.data(),
+      static_cast<int>(event.size()),
+      event.data());
+    std::abort();
+  }
+
+  inline std::atomic<NoAllocHandler> no_alloc_handler{ &abort_on_allocation };
+
+  template<typename T>
+  concept declares_no_alloc = requires { requires T::no_alloc; };
+
+  // Tags the current thread for its lifetime and restores the enclosing scope afterwards. An emit made by a
+  // no_alloc handler stays no_alloc and reports the handler.
+  class AllocationGuard
+  {
+  public:
+    AllocationGuard(
+      AllocationCounters& counters, std::string_view receiver, std::string_view event, bool no_alloc) noexcept
+      : outer_(allocation_scope), scope_{ &counters, receiver, event, no_alloc }
+    {
+      if (!no_alloc && outer_ != nullptr && outer_->no_alloc) {
+        scope_.receiver = outer_->receiver;
+        scope_.event = outer_->event;
+        scope_.no_alloc = true;
+      }
+      allocation_scope = &scope_;
+    }
+
+    ~AllocationGuard() { allocation_scope = outer_; }
+
+    AllocationGuard(const AllocationGuard&) = delete;
+    AllocationGuard& operator=(const AllocationGuard&) = delete;
+    AllocationGuard(AllocationGuard&&) = delete;
+    AllocationGuard& operator=(AllocationGuard&&) = delete;
+
+  private:
+    AllocationScope* outer_;
+    AllocationScope scope_;
+  };
+
+  template<typename... Receivers> class AllocationRegistry
+  {
+    using dispatch_slots = DispatchSlots<Receivers...>;
+    using emit_slots = EmitSlots<Receivers...>;
+    // Handler pairs, then emit pairs, then EventLoop::emit (which has no emitter type)
+    static constexpr std::size_t loop_emit_slot = dispatch_slots::count + emit_slots::count;
+    static constexpr std::size_t slot_count = loop_emit_slot + 1;
+
+  public:
+    template<typename Receiver, typename Event> [[nodiscard]] AllocationGuard dispatch_guard() noexcept
+    {
+      return { (*counters_)[dispatch_slots::template index<Receiver, Event>()],
+        type_name<Receiver>(),
+        type_name<Event>(),
+        declares_no_alloc<Receiver> };
+    }
+
+    template<typename Emitter, typename Event> [[nodiscard]] AllocationGuard emit_guard() noexcept
+    {
+      return { (*counters_)[dispatch_slots::count + emit_slots::template index<Emitter, Event>()],
+        type_name<Emitter>(),
+        type_name<Event>(),
+        false };
+    }
+
+    [[nodiscard]] AllocationGuard loop_emit_guard() noexcept
+    {
+      return { (*counters_)[loop_emit_slot], "EventLoop", "emit", false };
+    }
+
+    // Safe from any thread while the loop runs
+    [[nodiscard]] AllocationSnapshot snapshot() const
+    {
+      AllocationSnapshot snapshot;
+      const auto add = [&](AllocationSite site, std::size_t slot, std::string_view source, std::string_view event) {
+        const AllocationCounters& counters = (*counters_)[slot];
+        const std::uint64_t allocations = counters.allocations.load(std::memory_order_relaxed);
+        const std::uint64_t deallocations = counters.deallocations.load(std::memory_order_relaxed);
+        if (allocations == 0 && deallocations == 0) { return; }
+        snapshot.entries.push_back({ .site = site,
+          .source = source,
+          .event = event,
+          .allocations = allocations,
+          .deallocations = deallocations,
+          .bytes = counters.bytes.load(std::memory_order_relaxed) });
+      };
+      for (std::size_t slot = 0; slot < dispatch_slots::count; ++slot) {
+        add(AllocationSite::dispatch, slot, dispatch_slots::labels[slot].first, dispatch_slots::labels[slot].second);
+      }
+      for (std::size_t slot = 0; slot < emit_slots::count; ++slot) {
+        add(AllocationSite::emit,
+          dispatch_slots::count + slot,
+          emit_slots::labels[slot].first,
+          emit_slots::labels[slot].second);
+      }
+      add(AllocationSite::emit, loop_emit_slot, "EventLoop", "emit");
+      std::ranges::stable_sort(snapshot.entries, std::ranges::greater{}, &AllocationSnapshot::Entry::allocations);
+      return snapshot;
+    }
+
+  private:
+    // Heap-allocated, before any scope can point into it
+    std::unique_ptr<std::array<AllocationCounters, slot_count>> counters_ =
+      std::make_unique<std::array<AllocationCounters, slot_count>>();
+  };
+
+  // Guards of a loop without AllocationTracking - nothing to install
+  struct NoAllocationGuard
+  {
+  };
+
+  struct NoAllocationRegistry
+  {
+    template<typename Receiver, typename Event> [[nodiscard]] static NoAllocationGuard dispatch_guard() noexcept
+    {
+      return {};
+    }
+    template<typename Emitter, typename Event> [[nodiscard]] static NoAllocationGuard emit_guard() noexcept
+    {
+      return {};
+    }
+    [[nodiscard]] static NoAllocationGuard loop_emit_guard() noexcept { return {}; }
+  };
+
+} // namespace detail
+
+// Charges an allocation of `bytes` to the handler or emit running on this thread. Call it from a replacement
+// operator new (see EV_LOOP_TRACK_ALLOCATIONS); it does nothing outside loops with AllocationTracking.
+inline void note_allocation(std::size_t bytes) noexcept
+{
+  detail::AllocationScope* scope = detail::allocation_scope;
+  if (scope == nullptr) [[likely]] { return; }
+  scope->counters->allocations.fetch_add(1, std::memory_order_relaxed);
+  scope->counters->bytes.fetch_add(bytes, std::memory_order_relaxed);
+  if (scope->no_alloc) {
+    detail::allocation_scope = nullptr;
+    detail::no_alloc_handler.load(std::memory_order_acquire)(scope->receiver, scope->event, bytes);
+    detail::allocation_scope = scope;
+  }
+}
+
+// Counterpart of note_allocation for a replacement operator delete
+inline void note_deallocation() noexcept
+{
+  detail::AllocationScope* scope = detail::allocation_scope;
+  if (scope == nullptr) [[likely]] { return; }
+  scope->counters->deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Replaces what happens on an allocation in a no_alloc receiver (print and abort by default); returns the
+// previous handler
+inline NoAllocHandler set_no_alloc_handler(NoAllocHandler handler) noexcept
+{
+  return detail::no_alloc_handler.exchange(handler, std::memory_order_acq_rel);
+}
+
+// Counting replacements of the global operator new/delete that report to note_allocation/note_deallocation.
+// Expand once, at namespace scope, in one translation unit of the program. Over-aligned new/delete keep the
+// standard library's versions and are not counted.
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+#define EV_LOOP_TRACK_ALLOCATIONS()                                                                   \
+  void* operator new(std::size_t size)                                                                \
+  {                                                                                                   \
+    ::ev_loop::note_allocation(size);                                                                 \
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) { return ptr; } /* NOLINT(*-no-malloc) */     \
+    throw std::bad_alloc{};                                                                           \
+  }                                                                                                   \
+  void* operator new[](std::size_t size) { return ::operator new(size); }                             \
+  void operator delete(void* ptr) noexcept                                                            \
+  {                                                                                                   \
+    if (ptr == nullptr) { return; }                                                                   \
+    ::ev_loop::note_deallocation();                                                                   \
+    std::free(ptr); /* NOLINT(*-no-malloc) */                                                         \
+  }                                                                                                   \
+  void operator delete[](void* ptr) noexcept { ::operator delete(ptr); }                              \
+  void operator delete(void* ptr, std::size_t /*size*/) noexcept { ::operator delete(ptr); }          \
+  void operator delete[](void* ptr, std::size_t /*size*/) noexcept { ::operator delete(ptr); }        \
+  static_assert(true)
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+// =============================================================================
+// Trace session - Chrome trace JSON writer for the per-thread trace rings
+// =============================================================================
+
+// Collects the trace rings of all threads into a Chrome trace JSON file (chrome://tracing,
+// ui.perfetto.dev) for as long as it lives. Only loops listing the Trace option record. Dispatches
+// become slices on the dispatching thread's track, and flow arrows link each enqueue to its dispatch.
+// At most one session exists at a time.
+class TraceSession
+{
+public:
+  explicit TraceSession(const char* path, std::chrono::milliseconds flush_interval = std::chrono::milliseconds{ 10 })
+    : flush_interval_(flush_interval), ns_per_tick_(detail::TickClock::ns_per_tick())
+  {
+    auto& registry = detail::trace_registry;
+    const std::scoped_lock lock(registry.mutex);
+    if (registry.session) {
+      throw std::system_error(std::make_error_code(std::errc::device_or_resource_busy), "TraceSession");
+    }
+    file_ = std::fopen(path, "wb"); // NOLINT(cppcoreguidelines-owning-memory)
+    if (file_ == nullptr) { throw std::system_error(errno, std::generic_category(), "fopen"); }
+    // Records left over from an earlier session are not part of this one
+    for (const auto& ring : registry.rings) { reset_ring(*ring); }
+    try {
+      writer_ = std::thread([this] { run_writer(); });
+    } catch (...) {
+      std::ignore = std::fclose(file_); // NOLINT(cppcoreguidelines-owning-memory)
+      throw;
+    }
+    registry.session = true;
+    base_tick_ = detail::TickClock::now();
+    write("{\"traceEvents\":[\n"
+          R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"ev_loop"}})");
+    registry.active.store(true, std::memory_order_release);
+  }
+
+  ~TraceSession()
+  {
+    auto& registry = detail::trace_registry;
+    registry.active.store(false, std::memory_order_release);
+    {
+      const std::scoped_lock lock(stop_mutex_);
+      stop_ = true;
+    }
+    stop_cv_.notify_one();
+    writer_.join();
+    flush();
+    write("\n],\"displayTimeUnit\":\"ns\"}\n");
+    std::ignore = std::fclose(file_); // NOLINT(cppcoreguidelines-owning-memory)
+    const std::scoped_lock lock(registry.mutex);
+    registry.session = false;
+  }
+
+  TraceSession(const TraceSession&) = delete;
+  TraceSession& operator=(const TraceSession&) = delete;
+  TraceSession(TraceSession&&) = delete;
+  TraceSession& operator=(TraceSession&&) = delete;
+
+  // Writes out everything recorded so far (the writer thread does this every flush_interval)
+  void flush()
+  {
+    const std::scoped_lock lock(drain_mutex_);
+    std::vector<std::shared_ptr<detail::TraceRing>> rings;
+    std::vector<std::string> names;
+    {
+      const std::scoped_lock registry_lock(detail::trace_registry.mutex);
+      rings = detail::trace_registry.rings;
+      for (const auto& ring : rings) { names.push_back(ring->name); }
+    }
+    std::string out;
+    for (std::size_t idx = 0; idx < rings.size(); ++idx) {
+      auto& ring = *rings[idx];
+      ring.drain([&](const detail::TraceRecord& record) { append_record(out, ring, names[idx], record); });
+      const std::uint64_t dropped = ring.dropped();
+      dropped_.fetch_add(dropped - ring.dropped_seen, std::memory_order_relaxed);
+      ring.dropped_seen = dropped;
+    }
+    write(out);
+    std::ignore = std::fflush(file_);
+    rings.clear();
+    // Rings of exited threads are only referenced by the registry once drained
+    const std::scoped_lock registry_lock(detail::trace_registry.mutex);
+    std::erase_if(
+      detail::trace_registry.rings, [](const auto& ring) { return ring.use_count() == 1 && ring->empty(); });
+  }
+
+  // Records lost because a thread's ring was full between two flushes
+  [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  static void reset_ring(detail::TraceRing& ring)
+  {
+    ring.drain([](const detail::TraceRecord& /*record*/) {});
+    ring.open.clear();
+    ring.parked_at.reset();
+    ring.dropped_seen = ring.dropped();
+    ring.announced = false;
+  }
+
+  void run_writer()
+  {
+    std::unique_lock lock(stop_mutex_);
+    while (!stop_cv_.wait_for(lock, flush_interval_, [this] { return stop_; })) {
+      lock.unlock();
+      flush();
+      lock.lock();
+    }
+  }
+
+  void write(std::string_view text) noexcept
+  {
+    if (!text.empty()) { std::ignore = std::fwrite(text.data(), 1, text.size(), file_); }
+  }
+
+  [[nodiscard]] double micros(std::uint64_t tick) const noexcept
+  {
+    constexpr double ns_per_us = 1000.0;
+    return static_cast<double>(static_cast<std::int64_t>(tick - base_tick_)) * ns_per_tick_ / ns_per_us;
+  }
+
+  static void append_string(std::string& out, std::string_view text)
+  {
+    out += '"';
+    for (const char chr : text) {
+      if (chr == '"' || chr == '\\') { out += '\\'; }
+      out += chr;
+    }
+    out += '"';
+  }
+
+  // Integers as is, microseconds with nanosecond precision
+  template<typename Number> static void append_number(std::string& out, Number value)
+  {
+    std::array<char, 32> buffer{}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    std::to_chars_result result{};
+    if constexpr (std::is_floating_point_v<Number>) {
+      result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed, 3);
+    } else {
+      result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    }
+    out.append(buffer.data(), result.ptr);
+  }
+
+  // Opens one trace event: ,\n{"name":..,"cat":..,"ph":"X","ts":..,"dur":..,"pid":1,"tid":..
+  void open_slice(std::string& out,
+    const detail::TraceRing& ring,
+    std::string_view name,
+    std::string_view category,
+    std::uint64_t begin,
+    std::uint64_t end) const
+  {
+    out += ",\n{\"name\":";
+    append_string(out, name);
+    out += ",\"cat\":";
+    append_string(out, category);
+    out += ",\"ph\":\"X\",\"ts\":";
+    append_number(out, micros(begin));
+    out += ",\"dur\":";
+    append_number(out, micros(end) - micros(begin));
+    out += ",\"pid\":1,\"tid\":";
+    append_number(out, ring.index());
+  }
+
+  static void append_flow(std::string& out, std::uint64_t flow, const char* direction)
+  {
+    if (flow == 0) { return; }
+    out += ",\"bind_id\":";
+    append_number(out, flow);
+    out += ",\"";
+    out += direction;
+    out += "\":true";
+  }
+
+  static std::string_view queue_name(QueueKind queue) noexcept
+  {
+    switch (queue) {
+    case QueueKind::local:
+      return "local";
+    case QueueKind::remote:
+      return "remote";
+    case QueueKind::own_thread:
+      return "own_thread";
+    }
+    return "local";
+  }
+
+  void append_record(std::string& out,
+    detail::TraceRing& ring,
+    std::string_view thread_name,
+    const detail::TraceRecord& record) const
+  {
+    if (!ring.announced) {
+      ring.announced = true;
+      out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+      append_number(out, ring.index());
+      out += ",\"args\":{\"name\":";
+      if (thread_name.empty()) {
+        append_string(out, "thread " + std::to_string(ring.index()));
+      } else {
+        append_string(out, thread_name);
+      }
+      out += "}}";
+    }
+    switch (record.kind) {
+    case detail::TraceKind::enqueue:
+      open_slice(out, ring, record.label->event, "enqueue", record.tick, record.tick);
+      out += ",\"args\":{\"queue\":";
+      append_string(out, queue_name(record.queue));
+      if (record.queue == QueueKind::own_thread) {
+        out += ",\"receiver\":";
+        append_string(out, record.label->owner);
+      }
+      out += '}';
+      append_flow(out, record.flow, "flow_out");
+      out += '}';
+      break;
+    case detail::TraceKind::dispatch_begin:
+      ring.open.push_back(record);
+      break;
+    case detail::TraceKind::dispatch_end: {
+      if (ring.open.empty()) { break; }
+      const detail::TraceRecord begin = ring.open.back();
+      ring.open.pop_back();
+      open_slice(out, ring, begin.label->owner, "dispatch", begin.tick, record.tick);
+      out += ",\"args\":{\"event\":";
+      append_string(out, begin.label->event);
+      out += '}';
+      append_flow(out, begin.flow, "flow_in");
+      out += '}';
+      break;
+    }
+    case detail::TraceKind::park:
+      ring.parked_at = record.tick;
+      break;
+    case detail::TraceKind::unpark:
+      if (!ring.parked_at) { break; }
+      open_slice(out, ring, "park", "park", *ring.parked_at, record.tick);
+      out += '}';
+      ring.parked_at.reset();
+      break;
+    }
+  }
+
+  std::FILE* file_ = nullptr;
+  std::chrono::milliseconds flush_interval_;
+  double ns_per_tick_;
+  std::uint64_t base_tick_ = 0;
+  std::atomic<std::uint64_t> dropped_{ 0 };
+  std::mutex drain_mutex_;
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_ = false;
+  std::thread writer_;
+};
+
+// =============================================================================
+// Stall watchdog - reports long-running handlers and queues that stop draining
+// =============================================================================
+
+struct StallReport
+{
+  enum class Kind : std::uint8_t
+  {
+    slow_handler, // a handler has been running for longer than the threshold
+    stuck_queue, // events have waited for longer than the threshold while the thread dispatched nothing
+  };
+
+  Kind kind;
+  std::string_view thread; // "loop" or the OwnThread receiver's type
+  std::string_view receiver; // the running handler, or the thread's last dispatch for stuck_queue (empty if none)
+  std::string_view event;
+  std::chrono::nanoseconds duration;
+};
+
+struct WatchdogConfig
+{
+  std::chrono::milliseconds threshold{ 100 };
+  std::chrono::milliseconds interval{ 10 }; // how often the stamps are checked
+  // Called on the watchdog thread and must not throw. Empty: one line per stall on stderr.
+  std::function<void(const StallReport&)> on_stall;
+};
+
+// Polls the dispatch stamps of a loop built with the Watchdog option from its own thread, every
+// config.interval. Each stalled dispatch, and each stretch in which a backlogged queue makes no
+// progress, is reported once. Destroy the watchdog before its loop.
+template<typename Loop> class StallWatchdog
+{
+  static_assert(Loop::uses_watchdog, "StallWatchdog needs a loop built with the ev_loop::Watchdog option");
+
+public:
+  explicit StallWatchdog(Loop& loop, WatchdogConfig config = {})
+    : loop_(loop), config_(std::move(config)), ns_per_tick_(detail::TickClock::ns_per_tick()),
+      threshold_ticks_(static_cast<std::uint64_t>(
+        static_cast<double>(std::chrono::nanoseconds{ config_.threshold }.count()) / ns_per_tick_))
+  {
+    if (!config_.on_stall) { config_.on_stall = log_stall; }
+    thread_ = std::thread([this] { run(); });
+  }
+
+  ~StallWatchdog()
+  {
+    {
+      const std::scoped_lock lock(stop_mutex_);
+      stop_ = true;
+    }
+    stop_cv_.notify_one();
+    thread_.join();
+  }
+
+  StallWatchdog(const StallWatchdog&) = delete;
+  StallWatchdog& operator=(const StallWatchdog&) = delete;
+  StallWatchdog(StallWatchdog&&) = delete;
+  StallWatchdog& operator=(StallWatchdog&&) = delete;
+
+  // Checks every stamp once; the watchdog thread does this every interval
+  void check()
+  {
+    const std::scoped_lock lock(check_mutex_);
+    if (!loop_.is_running()) { return; }
+    const std::uint64_t now = detail::TickClock::now();
+    std::size_t lane = 0;
+    loop_.visit_dispatch_stamps([&](std::string_view thread, const detail::DispatchStamp& stamp, bool backlogged) {
+      if (lanes_.size() == lane) { lanes_.emplace_back(); }
+      inspect(lanes_[lane++], thread, stamp, backlogged, now);
+    });
+  }
+
+  // Stalls reported so far
+  [[nodiscard]] std::uint64_t stalls() const noexcept { return stalls_.load(std::memory_order_relaxed); }
+
+private:
+  // Watchdog-side view of one dispatching thread
+  struct Lane
+  {
+    std::uint64_t reported_start = 0; // started tick of the dispatch last reported as slow
+    std::uint64_t completed = 0;
+    std::uint64_t stuck_since = 0; // first check that saw a backlog without progress
+    bool stuck_reported = false;
+  };
+
+  void run()
+  {
+    std::unique_lock lock(stop_mutex_);
+    while (!stop_cv_.wait_for(lock, config_.interval, [this] { return stop_; })) {
+      lock.unlock();
+      check();
+      lock.lock();
+    }
+  }
+
+  void inspect(Lane& lane,
+    std::string_view thread,
+    const detail::DispatchStamp& stamp,
+    bool backlogged,
+    std::uint64_t now)
+  {
+    const auto [started, label] = stamp.running();
+    if (started != 0) {
+      // A running handler is reported as slow, never as a stuck queue
+      lane.stuck_since = 0;
+      if (started != lane.reported_start && now > started && now - started >= threshold_ticks_) {
+        lane.reported_start = started;
+        report(StallReport::Kind::slow_handler, thread, label, now - started);
+      }
+      return;
+    }
+    const std::uint64_t completed = stamp.completed.load(std::memory_order_acquire);
+    if (!backlogged || completed != lane.completed) {
+      lane.completed = completed;
+      lane.stuck_since = 0;
+      lane.stuck_reported = false;
+      return;
+    }
+    if (lane.stuck_since == 0) {
+      lane.stuck_since = now;
+    } else if (!lane.stuck_reported && now - lane.stuck_since >= threshold_ticks_) {
+      lane.stuck_reported = true;
+      report(StallReport::Kind::stuck_queue, thread, label, now - lane.stuck_since);
+    }
+  }
+
+  void report(StallReport::Kind kind, std::string_view thread, const detail::TraceLabel* label, std::uint64_t ticks)
+  {
+    stalls_.fetch_add(1, std::memory_order_relaxed);
+    config_.on_stall(StallReport{ .kind = kind,
+      .thread = thread,
+      .receiver = label != nullptr ? label->owner : std::string_view{},
+      .event = label != nullptr ? label->event : std::string_view{},
+      .duration = std::chrono::nanoseconds{ static_cast<std::int64_t>(static_cast<double>(ticks) * ns_per_tick_) } });
+  }
+
+  static void log_stall(const StallReport& report)
+  {
+    const auto millis = static_cast<long long>( // NOLINT(google-runtime-int) - matches %lld
+      std::chrono::duration_cast<std::chrono::milliseconds>(report.duration).count());
+    const auto width = [](std::string_view text) { return static_cast<int>(text.size()); };
+    if (report.kind == StallReport::Kind::slow_handler) {
+      std::ignore = std::fprintf(stderr,
+        "ev_loop watchdog: %.*s <- %.*s has been running for %lld ms on thread %.*s\n",
+        width(report.receiver),
+        report.receiver.data(),
+        width(report.event),
+        report.event.data(),
+        millis,
+        width(report.thread),
+        report.thread.data());
+    } else {
+      std::ignore = std::fprintf(stderr,
+        "ev_loop watchdog: queue of thread %.*s has not drained for %lld ms\n",
+        width(report.thread),
+        report.thread.data(),
+        millis);
+    }
+  }
 
-} // namespace detail
+  Loop& loop_;
+  WatchdogConfig config_;
+  double ns_per_tick_;
+  std::uint64_t threshold_ticks_;
+  std::vector<Lane> lanes_; // Protected by check_mutex_, in visit order
+  std::mutex check_mutex_;
+  std::atomic<std::uint64_t> stalls_{ 0 };
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_ = false;
+  std::thread thread_;
+};
 
 // =============================================================================
 // Poll strategies - use with loop.run<Strategy>() or Strategy{loop}.run()
@@ -1169,7 +6548,8 @@ template<typename EventLoop> struct Spin
   }
 };
 
-// Wait strategy: blocks on CV when idle, zero CPU when idle, higher latency
+// Wait strategy: blocks on CV (eventfd/epoll with EventFdWakeup/FdSources) when idle, zero CPU when idle,
+// higher latency
 template<typename EventLoop> struct Wait
 {
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
@@ -1178,7 +6558,7 @@ template<typename EventLoop> struct Wait
 
   [[nodiscard]] bool poll()
   {
-    auto* event = event_loop.queue().wait_pop_any();
+    auto* event = event_loop.wait_get_event();
     if (event == nullptr) { return false; }
     event_loop.dispatch_event(*event);
     return true;
@@ -1253,7 +6633,7 @@ template<typename EventLoop> struct Hybrid
 
     // Exceeded spin count - fall back to wait
     empty_spins = 0;
-    event = event_loop.queue().wait_pop_any();
+    event = event_loop.wait_get_event();
     if (event == nullptr) { return false; }
     event_loop.dispatch_event(*event);
     return true;
@@ -1281,7 +6661,51 @@ public:
   using same_thread_events = detail::collect_same_thread_events_t<Receivers...>;
   using own_thread_events = detail::collect_own_thread_events_t<Receivers...>;
   using tagged_event = detail::to_tagged_event_t<same_thread_events>;
-  using queue_type = detail::DualQueue<tagged_event>;
+
+  // Loop options listed alongside the receivers
+  using io_options = detail::filter_t<detail::is_io_uring_option, Receivers...>;
+  static_assert(detail::type_list_size_v<io_options> <= 1, "At most one IoUring option per loop");
+  static constexpr bool uses_async_io = detail::type_list_size_v<io_options> == 1;
+  static constexpr bool uses_fd_sources = uses_async_io || detail::contains_v<receiver_list, FdSources>;
+  static constexpr bool uses_eventfd_wakeup = uses_fd_sources || detail::contains_v<receiver_list, EventFdWakeup>;
+
+  using request_options = detail::filter_t<detail::is_request_reply_option, Receivers...>;
+  static_assert(detail::type_list_size_v<request_options> <= 1, "At most one RequestReply option per loop");
+  static constexpr bool uses_request_reply = detail::type_list_size_v<request_options> == 1;
+
+  using observe_options = detail::filter_t<detail::is_observe_option, Receivers...>;
+  static_assert(detail::type_list_size_v<observe_options> <= 1, "At most one Observe option per loop");
+  static constexpr bool uses_observer = detail::type_list_size_v<observe_options> == 1;
+  using observer_type = typename detail::observer_policy<observe_options>::type;
+  static constexpr bool uses_metrics = detail::contains_v<receiver_list, Metrics>;
+  static constexpr bool uses_utilization = detail::contains_v<receiver_list, Utilization>;
+  static constexpr bool uses_perf_counters = detail::contains_v<receiver_list, PerfCounters>;
+  // What the queues and dispatch path call: the Observe policy, teed with the enabled registries
+  using hooks_type =
+    typename detail::hooks_for<uses_metrics, uses_utilization, uses_perf_counters, observer_type, Receivers...>::type;
+  static constexpr bool observed = uses_observer || uses_metrics || uses_utilization || uses_perf_counters;
+  // Queue slots carry their enqueue tick so dispatch can split queue wait from handler time
+  static constexpr bool uses_latency = detail::contains_v<receiver_list, DispatchLatency>;
+  // Traced slots also carry the flow id that links a dispatch back to its enqueue
+  static constexpr bool uses_trace = detail::contains_v<receiver_list, Trace>;
+  using slot_event = std::conditional_t<uses_trace,
+    detail::Traced<tagged_event>,
+    std::conditional_t<uses_latency, detail::Stamped<tagged_event>, tagged_event>>;
+  static constexpr bool uses_flight_recorder = detail::contains_v<receiver_list, FlightRecorder>;
+  static_assert(!uses_flight_recorder || EV_HAS_EVENTFD, "FlightRecorder requires Linux signals and write(2)");
+  static constexpr bool uses_watchdog = detail::contains_v<receiver_list, Watchdog>;
+  using profile_options = detail::filter_t<detail::is_profile_option, Receivers...>;
+  static_assert(detail::type_list_size_v<profile_options> <= 1, "At most one Profile option per loop");
+  static constexpr bool uses_profile = detail::type_list_size_v<profile_options> == 1;
+  static constexpr bool uses_allocation_tracking = detail::contains_v<receiver_list, AllocationTracking>;
+  static constexpr bool uses_lock_profile = detail::contains_v<receiver_list, LockProfile>;
+  using lock_mutex = std::conditional_t<uses_lock_profile, detail::ProfiledMutex, std::mutex>;
+
+  // Coroutine machinery (frame pool, timers) exists only when a handler returns ev_loop::task
+  static constexpr bool uses_coroutines = (detail::is_coroutine_receiver<Receivers, self_type> || ...);
+  static_assert(!uses_fd_sources || EV_HAS_EVENTFD, "FdSources requires Linux epoll support");
+
+  using queue_type = detail::DualQueue<slot_event, uses_eventfd_wakeup, hooks_type, lock_mutex>;
 
   // ECS-style precomputed emitter event lists
   using ot_emitted_events = detail::collect_ot_emitted_events_t<Receivers...>;
@@ -1296,7 +6720,7 @@ public:
   using own_thread_receivers_for =
     detail::filter_list_t<detail::own_thread_receiver_for<Event>::template pred, receiver_list>;
 
-  // Compile-time flag: true if OwnThread receivers emit to SameThread events
+  // Compile-time flag: true if OwnThread receivers or external emitters emit to SameThread events
   // When true, the DualQueue's remote (thread-safe) queue is needed
 private:
   template<typename OTEvents, std::size_t... Is>
@@ -1308,7 +6732,9 @@ private:
 
 public:
   static constexpr bool needs_remote_queue =
-    needs_remote_queue_impl<ot_emitted_events>(std::make_index_sequence<detail::type_list_size_v<ot_emitted_events>>{});
+    needs_remote_queue_impl<ot_emitted_events>(std::make_index_sequence<detail::type_list_size_v<ot_emitted_events>>{})
+    || needs_remote_queue_impl<ext_emitted_events>(
+      std::make_index_sequence<detail::type_list_size_v<ext_emitted_events>>{});
 
   // Consteval checks for receiver existence - uses precomputed event lists
   template<typename Event> static consteval bool has_same_thread_receivers()
@@ -1400,9 +6826,27 @@ public:
   // Helper to get the queue type used for an OwnThread receiver
   template<typename Receiver> using queue_type_for = typename detail::OwnThreadWrapper<Receiver, self_type>::queue_type;
 
-  EventLoop() : receivers_(detail::ReceiverStorage<Receivers, self_type>(this)...) {}
+  EventLoop() : receivers_(detail::ReceiverStorage<Receivers, self_type>(this)...)
+  {
+    if constexpr (observed) { queue_.attach_observer(&hooks_); }
+    if constexpr (uses_flight_recorder) { detail::install_flight_recorder(); }
+    if constexpr (uses_fd_sources) {
+      if (!epoll_.watch(queue_.native_handle(), EPOLLIN, wakeup_token)) {
+        throw std::system_error(errno, std::system_category(), "epoll_ctl");
+      }
+    }
+    if constexpr (uses_async_io) {
+      if (!epoll_.watch(io_.native_handle(), EPOLLIN, io_token)) {
+        throw std::system_error(errno, std::system_category(), "epoll_ctl");
+      }
+    }
+  }
 
-  ~EventLoop() { stop(); }
+  ~EventLoop()
+  {
+    stop();
+    if constexpr (uses_coroutines) { timers_.destroy_all(); }
+  }
 
   EventLoop(const EventLoop&) = delete;
   EventLoop& operator=(const EventLoop&) = delete;
@@ -1420,18 +6864,150 @@ public:
 
   [[nodiscard]] queue_type& queue() & noexcept { return queue_; }
 
-  [[nodiscard]] tagged_event* try_get_event()
+  // The Observe policy instance (Observe option only)
+  template<typename Self>
+  [[nodiscard]] auto& observer(this Self& self) noexcept
+    requires uses_observer
+  {
+    if constexpr (uses_metrics || uses_utilization || uses_perf_counters) {
+      return self.hooks_.template get<observer_type>();
+    } else {
+      return self.hooks_;
+    }
+  }
+
+  // Counter registry (Metrics option only) - snapshot() and write_openmetrics() are safe from any thread
+  template<typename Self>
+  [[nodiscard]] auto& metrics(this Self& self) noexcept
+    requires uses_metrics
+  {
+    return self.hooks_.template get<detail::MetricsRegistry<Receivers...>>();
+  }
+
+  // Per-thread handler, parked, spinning and CPU time (Utilization option only) - snapshot() is safe
+  // from any thread
+  template<typename Self>
+  [[nodiscard]] auto& utilization(this Self& self) noexcept
+    requires uses_utilization
+  {
+    return self.hooks_.template get<detail::UtilizationRegistry>();
+  }
+
+  // Per-thread cycles, instructions, cache and branch misses (PerfCounters option only) - snapshot() is safe
+  // from any thread
+  template<typename Self>
+  [[nodiscard]] auto& perf_counters(this Self& self) noexcept
+    requires uses_perf_counters
+  {
+    return self.hooks_.template get<detail::PerfCounterRegistry>();
+  }
+
+  // Queue-wait and handler histograms (DispatchLatency option only) - snapshot<Receiver>() and
+  // merged() are safe from any thread
+  template<typename Self>
+  [[nodiscard]] auto& latency(this Self& self) noexcept
+    requires uses_latency
+  {
+    return self.latency_;
+  }
+
+  // Sampled handler cost per receiver and event type (Profile option only) - snapshot() is safe from any
+  // thread
+  template<typename Self>
+  [[nodiscard]] auto& profile(this Self& self) noexcept
+    requires uses_profile
+  {
+    return self.profile_;
+  }
+
+  // Heap allocations per handler and emit (AllocationTracking option only) - snapshot() is safe from any thread.
+  // Counts only reach it through note_allocation(), see EV_LOOP_TRACK_ALLOCATIONS.
+  template<typename Self>
+  [[nodiscard]] auto& allocations(this Self& self) noexcept
+    requires uses_allocation_tracking
+  {
+    return self.allocations_;
+  }
+
+  // Wait, hold and contention of the loop queue and OwnThread inbox mutexes, per (queue, thread) (LockProfile
+  // option only) - safe from any thread
+  [[nodiscard]] LockSnapshot lock_snapshot() const
+    requires uses_lock_profile
+  {
+    LockSnapshot snapshot;
+    queue_.mutex().collect("loop", snapshot.entries);
+    collect_inbox_locks(snapshot.entries, std::make_index_sequence<sizeof...(Receivers)>{});
+    std::ranges::stable_sort(snapshot.entries, std::ranges::greater{}, &LockSnapshot::Entry::wait);
+    return snapshot;
+  }
+
+  // Writes the last dispatches of every thread to fd (FlightRecorder option only).
+  // Async-signal-safe, so it may also be called from the application's own signal handlers.
+  // NOLINTNEXTLINE(readability-convert-member-functions-to-static) - tied to the option
+  bool dump_flight_recorder(int fd) const noexcept
+    requires uses_flight_recorder
+  {
+    return detail::dump_flight_buffers(fd);
+  }
+
+  // Calls visit(thread name, stamp, backlogged) for the loop thread and each OwnThread receiver
+  // (Watchdog option only). Backlogged means events wait in an OwnThread inbox, or on the remote side of
+  // the loop queue; the local ring belongs to the loop thread and is not visible from others.
+  template<typename Visitor>
+  void visit_dispatch_stamps(Visitor&& visit)
+    requires uses_watchdog
+  {
+    visit(std::string_view{ "loop" }, std::as_const(watchdog_stamp_), queue_.has_remote());
+    visit_own_thread_stamps(visit, std::make_index_sequence<sizeof...(Receivers)>{});
+  }
+
+  [[nodiscard]] slot_event* try_get_event()
   {
-    if constexpr (needs_remote_queue) {
+    if constexpr (uses_coroutines || uses_request_reply) {
+      // Sleeping handlers and request deadlines are checked on every poll while any are pending
+      if (deadlines_pending()) [[unlikely]] { std::ignore = fire_deadlines(detail::TimerList::clock::now()); }
+    }
+    if constexpr (uses_fd_sources) {
+      return pop_or_poll_fds();
+    } else if constexpr (needs_remote_queue) {
       return queue_.try_pop();
     } else {
       return queue_.try_pop_local();
     }
   }
 
-  void dispatch_event(tagged_event& event)
+  // Blocking pop used by Wait and Hybrid - returns nullptr once stopped, or when sleeping
+  // coroutines were resumed / requests timed out / either is due, so the strategy re-checks its predicate
+  [[nodiscard]] slot_event* wait_get_event()
+  {
+    if constexpr (uses_coroutines || uses_request_reply) {
+      if (deadlines_pending()) {
+        if (fire_deadlines(detail::TimerList::clock::now()) > 0) { return nullptr; }
+        return wait_get_event_until(next_deadline());
+      }
+    }
+    if constexpr (uses_fd_sources) {
+      while (true) {
+        if (auto* event = pop_or_poll_fds()) { return event; }
+        if (queue_.stopped()) { return nullptr; }
+        queue_.park();
+        std::ignore = poll_fd_sources(-1);
+        queue_.unpark();
+      }
+    } else {
+      return queue_.wait_pop_any();
+    }
+  }
+
+  void dispatch_event(slot_event& event)
   {
+    if constexpr (uses_latency) { dispatch_stamp_ = event.enqueued_at; }
+    if constexpr (uses_trace) { dispatch_flow_ = event.flow; }
     fast_dispatch(event, [this]<typename E>(E& event2) {
+      if constexpr (observed) { hooks_.template on_dequeue<void, E>(QueueKind::local); }
+      if constexpr (uses_request_reply && detail::is_correlated<E>) {
+        if (event2.correlation_id != 0 && route_correlated(event2)) { return; }
+      }
       // Use consteval count to avoid filter_list_t instantiation
       constexpr std::size_t count = count_same_thread_receivers<std::decay_t<E>>();
       if constexpr (count == 1) {
@@ -1450,17 +7026,120 @@ public:
     running_.store(false, std::memory_order_release);
     queue_.stop();
     stop_all(std::index_sequence_for<Receivers...>{});
+    if constexpr (uses_utilization) { hooks_.template get<detail::UtilizationRegistry>().close_loop_threads(); }
+    if constexpr (uses_perf_counters) { hooks_.template get<detail::PerfCounterRegistry>().close_loop_threads(); }
+  }
+
+  // Release a pending request before its reply arrives (loop thread only). A continuation that accepts
+  // RequestStatus is called with RequestStatus::cancelled; a late reply goes to the requester's on_event.
+  // False if id is not pending.
+  bool cancel(correlation_id id)
+    requires uses_request_reply
+  {
+    return requests_.cancel(id);
+  }
+
+  // Pollable fd for embedding the loop in an external reactor (EventFdWakeup/FdSources only)
+  // Readable while remote events or watched fds are pending; call poll_ready() when it fires.
+  // With FdSources this is the epoll fd, which nests inside an outer epoll set.
+  [[nodiscard]] int native_handle() const noexcept
+    requires uses_eventfd_wakeup
+  {
+    if constexpr (uses_fd_sources) {
+      return epoll_.native_handle();
+    } else {
+      return queue_.native_handle();
+    }
+  }
+
+#if EV_HAS_EVENTFD
+  // Register fd with the loop's epoll set; readiness is delivered as Event{ fd, revents }
+  // to the SameThread receivers of Event. Re-watching an fd replaces its event type and mask.
+  // Returns false (errno set) if epoll_ctl fails.
+  template<typename Event>
+    requires(uses_fd_sources && detail::is_fd_event<Event>)
+  bool watch_fd(int fd, std::uint32_t events = EPOLLIN)
+  {
+    static_assert(has_same_thread_receivers<Event>(), "watch_fd event must be received by a SameThread receiver");
+    constexpr std::uint64_t tag = detail::type_list_index_of_v<same_thread_events, Event>;
+    return epoll_.watch(fd, events, (tag << fd_token_shift) | static_cast<std::uint32_t>(fd));
+  }
+
+  bool unwatch_fd(int fd)
+    requires uses_fd_sources
+  {
+    return epoll_.unwatch(fd);
+  }
+
+  // Async I/O (IoUring only). Completions arrive as Completion{ fd, result, buffer } on the loop
+  // thread; requests are staged and flushed in one batch when the loop runs out of queued events.
+  [[nodiscard]] IoBuffer acquire_io_buffer() noexcept
+    requires uses_async_io
+  {
+    return io_.acquire_buffer();
+  }
+
+  // Read up to length bytes (clamped to the pool buffer size) at offset into a pooled buffer.
+  // Returns false when every in-flight slot or pool buffer is in use.
+  template<typename Completion>
+    requires(uses_async_io && detail::is_io_completion<Completion>)
+  bool submit_read(int fd, std::size_t length, std::uint64_t offset)
+  {
+    return io_.submit_read(io_completion_tag<Completion>(), fd, length, offset);
+  }
+
+  // Write buffer.bytes() at offset; the buffer comes back in the completion
+  template<typename Completion>
+    requires(uses_async_io && detail::is_io_completion<Completion>)
+  bool submit_write(int fd, IoBuffer buffer, std::uint64_t offset)
+  {
+    return io_.submit_write(io_completion_tag<Completion>(), fd, std::move(buffer), offset);
+  }
+
+  [[nodiscard]] IoBackend io_backend() const noexcept
+    requires uses_async_io
+  {
+    return io_.backend();
+  }
+#endif
+
+  // Non-blocking: dispatch queued events (local and remote) until empty or max_events reached
+  // If the budget runs out with events left, the wakeup is re-armed so a level-triggered
+  // reactor calls back in. Returns the number of events dispatched.
+  std::size_t poll_ready(std::size_t max_events = std::numeric_limits<std::size_t>::max())
+  {
+    queue_.clear_wakeup();
+    if constexpr (uses_fd_sources) { std::ignore = poll_fd_sources(0); }
+    std::size_t dispatched = 0;
+    while (dispatched < max_events) {
+      if constexpr (uses_fd_sources) {
+        // A long batch still picks up fd readiness
+        if (dispatched != 0 && dispatched % fd_poll_interval == 0) { std::ignore = poll_fd_sources(0); }
+      }
+      auto* event = queue_.try_pop();
+      if (event == nullptr) { break; }
+      dispatch_event(*event);
+      ++dispatched;
+    }
+    flush_io();
+    if (!queue_.empty()) { queue_.rearm_wakeup(); }
+    return dispatched;
   }
 
   // Emit from EV thread (uses local queue)
   template<typename Event> void emit(Event&& event)
   {
     using E = std::decay_t<Event>;
+    [[maybe_unused]] const auto allocation_guard = allocations_.loop_emit_guard();
     // Use consteval checks to avoid filter_list_t instantiation
     constexpr bool to_queue = has_same_thread_receivers<E>();
     constexpr bool to_threads = has_own_thread_receivers<E>();
 
     if constexpr (to_queue && to_threads) {
+      if (routed_by_loop(event)) {
+        queue_.push_local_event(std::forward<Event>(event));
+        return;
+      }
       queue_.push_local_event(event);
       push_to_own_thread(std::forward<Event>(event));
     } else if constexpr (to_queue) {
@@ -1480,6 +7159,7 @@ private:
   template<typename, typename> friend class SameThreadTypedDispatcher;
   template<typename, typename> friend class OwnThreadTypedDispatcher;
   template<typename...> friend class SharedEventLoopPtr;
+  template<typename, typename> friend class detail::OwnThreadWrapper;
 
   template<std::size_t I> void start_one()
   {
@@ -1497,6 +7177,34 @@ private:
     }
   }
 
+  template<std::size_t I, typename Visitor> void visit_own_thread_stamp(Visitor& visit)
+  {
+    using T = detail::type_list_at_t<I, receiver_list>;
+    if constexpr (detail::is_receiver<T> && detail::is_own_thread_v<T>) {
+      auto& wrapper = *std::get<I>(receivers_);
+      visit(detail::type_name<T>(), wrapper.watchdog_stamp(), wrapper.backlogged());
+    }
+  }
+
+  template<typename Visitor, std::size_t... Is>
+  void visit_own_thread_stamps(Visitor& visit, std::index_sequence<Is...> /*unused*/)
+  {
+    (visit_own_thread_stamp<Is>(visit), ...);
+  }
+
+  template<std::size_t... Is>
+  void collect_inbox_locks(std::vector<LockSnapshot::Entry>& out, std::index_sequence<Is...> /*unused*/) const
+  {
+    (
+      [&] {
+        using T = detail::type_list_at_t<Is, receiver_list>;
+        if constexpr (detail::is_receiver<T> && detail::is_own_thread_v<T>) {
+          std::get<Is>(receivers_)->collect_lock_profile(out);
+        }
+      }(),
+      ...);
+  }
+
   template<std::size_t... Is> void start_all(std::index_sequence<Is...> /*unused*/) { (start_one<Is>(), ...); }
 
   template<std::size_t... Is> void stop_all(std::index_sequence<Is...> /*unused*/) { (stop_one<Is>(), ...); }
@@ -1505,9 +7213,7 @@ private:
   template<typename Event, typename ReceiverList, std::size_t... Is>
   void fanout_copy_n(const Event& event, std::index_sequence<Is...> /*unused*/)
   {
-    (std::get<detail::ReceiverStorage<detail::type_list_at_t<Is, ReceiverList>, self_type>>(receivers_)
-        ->dispatch(event),
-      ...);
+    (observed_dispatch<detail::type_list_at_t<Is, ReceiverList>>(event), ...);
   }
 
   template<typename Event, typename ReceiverList> void fanout_to_same_thread_ecs(Event& event, ReceiverList /*unused*/)
@@ -1515,13 +7221,60 @@ private:
     constexpr std::size_t count = detail::type_list_size_v<ReceiverList>;
     if constexpr (count == 1) {
       using R = detail::type_list_at_t<0, ReceiverList>;
-      std::get<detail::ReceiverStorage<R, self_type>>(receivers_)->dispatch(std::move(event));
+      observed_dispatch<R>(std::move(event));
     } else {
       // Copy to first N-1 receivers
       fanout_copy_n<Event, ReceiverList>(event, std::make_index_sequence<count - 1>{});
       // Move to last receiver
       using LastR = detail::type_list_at_t<count - 1, ReceiverList>;
-      std::get<detail::ReceiverStorage<LastR, self_type>>(receivers_)->dispatch(std::move(event));
+      observed_dispatch<LastR>(std::move(event));
+    }
+  }
+
+  // Hand one event to a SameThread receiver, bracketed by the observer's dispatch hooks
+  template<typename Receiver, typename Event> void observed_dispatch(Event&& event)
+  {
+    observed_dispatch_at<Receiver>(
+      *std::get<detail::ReceiverStorage<Receiver, self_type>>(receivers_), std::forward<Event>(event));
+  }
+
+  template<typename Receiver, typename Wrapper, typename Event>
+  void observed_dispatch_at(Wrapper& wrapper, Event&& event)
+  {
+    EV_PROBE(dispatch_begin,
+      this,
+      detail::type_name_cstr<Receiver>.data(),
+      detail::type_name_cstr<std::decay_t<Event>>.data());
+    if constexpr (observed) { hooks_.template on_dispatch_begin<Receiver, std::decay_t<Event>>(); }
+    if constexpr (uses_trace) {
+      detail::trace_dispatch<Receiver, std::decay_t<Event>>(detail::TraceKind::dispatch_begin, dispatch_flow_);
+    }
+    if constexpr (uses_flight_recorder) { detail::flight_begin<Receiver, std::decay_t<Event>>(); }
+    if constexpr (uses_watchdog) { watchdog_stamp_.template begin<Receiver, std::decay_t<Event>>(); }
+    if constexpr (uses_latency) {
+      const std::uint64_t begin = detail::TickClock::now();
+      run_handler<Receiver>(wrapper, std::forward<Event>(event));
+      latency_.template record<Receiver>(dispatch_stamp_, begin, detail::TickClock::now());
+    } else {
+      run_handler<Receiver>(wrapper, std::forward<Event>(event));
+    }
+    if constexpr (uses_watchdog) { watchdog_stamp_.end(); }
+    if constexpr (uses_flight_recorder) { detail::flight_end(); }
+    if constexpr (uses_trace) {
+      detail::trace_dispatch<Receiver, std::decay_t<Event>>(detail::TraceKind::dispatch_end, 0);
+    }
+    if constexpr (observed) { hooks_.template on_dispatch_end<Receiver, std::decay_t<Event>>(); }
+    EV_PROBE(dispatch_end, this, detail::type_name_cstr<Receiver>.data());
+  }
+
+  template<typename Receiver, typename Wrapper, typename Event> void run_handler(Wrapper& wrapper, Event&& event)
+  {
+    [[maybe_unused]] const auto allocation_guard =
+      allocations_.template dispatch_guard<Receiver, std::decay_t<Event>>();
+    if constexpr (uses_profile) {
+      profile_.template run<Receiver, std::decay_t<Event>>([&] { wrapper.dispatch(std::forward<Event>(event)); });
+    } else {
+      wrapper.dispatch(std::forward<Event>(event));
     }
   }
 
@@ -1531,7 +7284,8 @@ private:
     // cppcheck-suppress unreadVariable ; used by std::get
     constexpr std::size_t idx = find_st_receiver_index<std::decay_t<Event>>();
     // Use index-based std::get (O(1)) instead of type-based (O(N) template instantiation)
-    std::get<idx>(receivers_)->dispatch(std::forward<Event>(event));
+    observed_dispatch_at<detail::type_list_at_t<idx, receiver_list>>(
+      *std::get<idx>(receivers_), std::forward<Event>(event));
   }
 
   // ECS-style push: copy to first N-1, move to last
@@ -1558,9 +7312,264 @@ private:
     }
   }
 
+  // Hook target for the queues and OwnThread wrappers
+  [[nodiscard]] hooks_type& hooks() noexcept
+    requires observed
+  {
+    return hooks_;
+  }
+
+  // Epoll data word: event tag in the high half, fd in the low half; all-ones marks the queue wakeup
+  static constexpr unsigned fd_token_shift = 32;
+  static constexpr std::uint64_t wakeup_token = ~std::uint64_t{ 0 };
+  static constexpr std::uint64_t io_token = wakeup_token - 1;
+  // Queued events dispatched between non-blocking epoll checks while the queue stays busy
+  static constexpr std::uint32_t fd_poll_interval = 64;
+
+  [[nodiscard]] slot_event* wait_get_event_until(detail::TimerList::clock::time_point deadline)
+  {
+    if constexpr (uses_fd_sources) {
+      if (auto* event = pop_or_poll_fds()) { return event; }
+      queue_.park();
+      std::ignore = poll_fd_sources(detail::poll_timeout_ms(deadline));
+      queue_.unpark();
+      return queue_.try_pop();
+    } else {
+      return queue_.wait_pop_any_until(deadline);
+    }
+  }
+
+  template<typename Event> static consteval std::uint32_t event_tag()
+  {
+    return static_cast<std::uint32_t>(detail::type_list_index_of_v<same_thread_events, Event>);
+  }
+
+  // Correlated events carrying an id reach OwnThread receivers through the loop thread, which owns the
+  // request table and so knows whether the event answers a request (see route_correlated)
+  template<typename Event> [[nodiscard]] static bool routed_by_loop(const Event& event) noexcept
+  {
+    if constexpr (uses_request_reply && detail::is_correlated<Event>) {
+      return event.correlation_id != 0;
+    } else {
+      return false;
+    }
+  }
+
+  // A reply to a pending request runs the requester's continuation; a late one goes to the requester's
+  // on_event only. False for any other id: the caller dispatches the event as usual, and the OwnThread
+  // receivers that emit left out get it here.
+  template<typename Event> bool route_correlated(Event& event)
+  {
+    if (requests_.complete(event_tag<Event>(), event)) { return true; }
+    const std::uint32_t requester = requests_.requester_of(event_tag<Event>(), event.correlation_id);
+    if (dispatch_to_requester(requester, event, same_thread_receivers_for<Event>{})) { return true; }
+    if constexpr (has_own_thread_receivers<Event>()) { push_to_own_thread(event); }
+    return false;
+  }
+
+  template<typename Event, typename... Rs>
+  bool dispatch_to_requester(std::uint32_t requester, Event& event, type_list<Rs...> /*unused*/)
+  {
+    return ((requester == detail::index_of_v<Rs, Receivers...> && (observed_dispatch<Rs>(std::move(event)), true))
+            || ...);
+  }
+
+  template<typename Requester, typename Reply, typename Callback>
+  [[nodiscard]] correlation_id add_request(Callback&& callback,
+    detail::TimerList::clock::time_point deadline = detail::TimerList::clock::time_point::max())
+  {
+    static_assert(detail::contains_v<detail::get_receives_t<Requester>, Reply>,
+      "Requesters must receive Reply - late replies are delivered to on_event");
+    return requests_.template add<Reply>(event_tag<Reply>(),
+      static_cast<std::uint32_t>(detail::index_of_v<Requester, Receivers...>),
+      std::forward<Callback>(callback),
+      deadline);
+  }
+
+  // Sleeping coroutines and request deadlines share the poll-time check and the bounded wait
+  [[nodiscard]] bool deadlines_pending() const noexcept
+  {
+    bool pending = false;
+    if constexpr (uses_coroutines) { pending = timers_.pending(); }
+    if constexpr (uses_request_reply) { pending = pending || requests_.timed(); }
+    return pending;
+  }
+
+  std::size_t fire_deadlines(detail::TimerList::clock::time_point now)
+  {
+    std::size_t fired = 0;
+    if constexpr (uses_coroutines) { fired += timers_.fire(now); }
+    if constexpr (uses_request_reply) { fired += requests_.expire(now); }
+    return fired;
+  }
+
+  [[nodiscard]] detail::TimerList::clock::time_point next_deadline() const noexcept
+  {
+    auto deadline = detail::TimerList::clock::time_point::max();
+    if constexpr (uses_coroutines) { deadline = timers_.next_deadline(); }
+    if constexpr (uses_request_reply) {
+      if (requests_.timed()) { deadline = std::min(deadline, requests_.next_deadline()); }
+    }
+    return deadline;
+  }
+
+  template<typename Receiver, typename Event> [[nodiscard]] detail::AwaitList<Event>& await_list() noexcept
+  {
+    static_assert(detail::is_coroutine_receiver<Receiver, self_type>,
+      "next<Event>() needs a SameThread receiver with an ev_loop::task handler");
+    return std::get<detail::ReceiverStorage<Receiver, self_type>>(receivers_)->template await_list<Event>();
+  }
+
+  template<typename Completion> static consteval std::uint32_t io_completion_tag()
+  {
+    static_assert(count_same_thread_receivers<Completion>() == 1,
+      "IoCompletion events are move-only and need exactly one SameThread receiver");
+    return static_cast<std::uint32_t>(detail::type_list_index_of_v<same_thread_events, Completion>);
+  }
+
+  void flush_io()
+  {
+    if constexpr (uses_async_io) {
+      io_.flush();
+      if (io_.has_set_aside()) { reap_io(); }
+    }
+  }
+
+  // Queue first, asking epoll (non-blocking) when it is empty - and every fd_poll_interval pops regardless, so
+  // a queue that never drains cannot starve the fds. Returns nullptr with pending I/O flushed.
+  [[nodiscard]] slot_event* pop_or_poll_fds()
+  {
+    if (++pops_since_fd_poll_ < fd_poll_interval) {
+      if (auto* event = queue_.try_pop()) { return event; }
+    }
+    pops_since_fd_poll_ = 0;
+    flush_io();
+    std::ignore = poll_fd_sources(0);
+    return queue_.try_pop();
+  }
+
+  // Harvest epoll readiness into the local queue; returns the number of notifications
+  [[nodiscard]] int poll_fd_sources([[maybe_unused]] int timeout_ms)
+  {
+#if EV_HAS_EVENTFD
+    std::array<epoll_event, detail::Epoll::max_events> ready{};
+    const int count = epoll_.wait(ready, timeout_ms);
+    if (count < 0) [[unlikely]] { throw std::system_error(errno, std::system_category(), "epoll_wait"); }
+    for (int idx = 0; idx < count; ++idx) {
+      const auto& entry = ready[static_cast<std::size_t>(idx)];
+      if (entry.data.u64 == wakeup_token) {
+        // Consumed before the next try_pop drains the remote queue
+        queue_.clear_wakeup();
+      } else if (entry.data.u64 == io_token) {
+        reap_io();
+      } else {
+        deliver_fd_event(entry.data.u64 >> fd_token_shift,
+          static_cast<int>(static_cast<std::uint32_t>(entry.data.u64)),
+          entry.events,
+          std::make_index_sequence<detail::type_list_size_v<same_thread_events>>{});
+      }
+    }
+    return count;
+#else
+    return 0;
+#endif
+  }
+
+  template<std::size_t... Is>
+  void deliver_fd_event(std::uint64_t tag, int fd, std::uint32_t events, std::index_sequence<Is...> /*unused*/)
+  {
+    std::ignore = ((tag == Is ? (deliver_fd_event_at<Is>(fd, events), true) : false) || ...);
+  }
+
+  template<std::size_t I> void deliver_fd_event_at(int fd, std::uint32_t events)
+  {
+    using Event = detail::type_list_at_t<I, same_thread_events>;
+    if constexpr (detail::is_fd_event<Event>) { queue_.push_local_event(Event{ fd, events }); }
+  }
+
+  void reap_io()
+  {
+    if constexpr (uses_async_io) {
+      io_.reap([this](std::uint32_t tag, int fd, int result, IoBuffer buffer) {
+        deliver_io_completion(
+          tag, fd, result, buffer, std::make_index_sequence<detail::type_list_size_v<same_thread_events>>{});
+      });
+    }
+  }
+
+  template<std::size_t... Is>
+  void deliver_io_completion(std::uint32_t tag,
+    int fd,
+    int result,
+    IoBuffer& buffer,
+    std::index_sequence<Is...> /*unused*/)
+  {
+    std::ignore = ((tag == Is ? (deliver_io_completion_at<Is>(fd, result, buffer), true) : false) || ...);
+  }
+
+  template<std::size_t I> void deliver_io_completion_at(int fd, int result, IoBuffer& buffer)
+  {
+    using Event = detail::type_list_at_t<I, same_thread_events>;
+    if constexpr (detail::is_io_completion<Event>) { queue_.push_local_event(Event{ fd, result, std::move(buffer) }); }
+  }
+
+  // Declared first so hooks fired while receivers and queues are torn down still have a target
+  [[no_unique_address]] hooks_type hooks_;
+  [[no_unique_address]] std::conditional_t<uses_latency, detail::LatencyRegistry<Receivers...>, detail::NoLatency>
+    latency_;
+  template<typename List> struct profile_registry_for
+  {
+    using type = detail::NoProfile;
+  };
+  template<typename Option> struct profile_registry_for<type_list<Option>>
+  {
+    using type = detail::ProfileRegistry<Option, Receivers...>;
+  };
+  [[no_unique_address]] typename profile_registry_for<profile_options>::type profile_;
+  [[no_unique_address]] std::
+    conditional_t<uses_allocation_tracking, detail::AllocationRegistry<Receivers...>, detail::NoAllocationRegistry>
+      allocations_;
+  // Enqueue tick and trace flow of the event being dispatched on the loop thread (DispatchLatency, Trace)
+  std::uint64_t dispatch_stamp_ = 0;
+  std::uint64_t dispatch_flow_ = 0;
+  // What the loop thread is dispatching, polled by a StallWatchdog (Watchdog)
+  [[no_unique_address]] std::conditional_t<uses_watchdog, detail::DispatchStamp, detail::NoDispatchStamp>
+    watchdog_stamp_;
+  // Declared early so the frame pool outlives suspended handlers owned by the receivers
+  [[no_unique_address]] std::conditional_t<uses_coroutines, detail::FramePool, detail::NoFramePool> frame_pool_;
+  [[no_unique_address]] std::conditional_t<uses_coroutines, detail::TimerList, detail::NoTimerList> timers_;
+  template<typename List> struct request_table_for
+  {
+    using type = detail::NoRequestTable;
+  };
+  template<typename Option> struct request_table_for<type_list<Option>>
+  {
+    using type = detail::RequestTable<Option>;
+  };
+  [[no_unique_address]] typename request_table_for<request_options>::type requests_;
+  // Declared before receivers_ so the I/O pool outlives buffers held by receivers and queued completions
+#if EV_HAS_EVENTFD
+  template<typename List> struct async_io_for
+  {
+    using type = detail::NoAsyncIo;
+  };
+  template<typename Option> struct async_io_for<type_list<Option>>
+  {
+    using type = detail::AsyncIo<Option>;
+  };
+  [[no_unique_address]] typename async_io_for<io_options>::type io_;
+#else
+  [[no_unique_address]] detail::NoAsyncIo io_;
+#endif
   std::tuple<detail::ReceiverStorage<Receivers, self_type>...> receivers_;
   queue_type queue_;
   std::atomic<bool> running_{ false };
+  std::uint32_t pops_since_fd_poll_ = 0; // FdSources only
+#if EV_HAS_EVENTFD
+  [[no_unique_address]] std::conditional_t<uses_fd_sources, detail::Epoll, detail::NoEpoll> epoll_;
+#else
+  [[no_unique_address]] detail::NoEpoll epoll_;
+#endif
 };
 
 // =============================================================================
@@ -1581,7 +7590,13 @@ public:
   void emit(Event&& event)
   {
     using E = std::decay_t<Event>;
+    [[maybe_unused]] const auto allocation_guard =
+      event_loop_->allocations_.template emit_guard<EmitterType, E>();
     if constexpr (to_queue<E> && to_threads<E>) {
+      if (EventLoopType::routed_by_loop(event)) {
+        event_loop_->queue_.push_local_event(std::forward<Event>(event));
+        return;
+      }
       event_loop_->queue_.push_local_event(event);
       event_loop_->push_to_own_thread(std::forward<Event>(event));
     } else if constexpr (to_queue<E>) {
@@ -1591,6 +7606,123 @@ public:
     }
   }
 
+#if EV_HAS_EVENTFD
+  // Register an fd with the loop's epoll set (FdSources loops only) - see EventLoop::watch_fd
+  template<typename Event>
+    requires(EventLoopType::uses_fd_sources && detail::is_fd_event<Event>)
+  bool watch_fd(int fd, std::uint32_t events = EPOLLIN)
+  {
+    return event_loop_->template watch_fd<Event>(fd, events);
+  }
+
+  bool unwatch_fd(int fd)
+    requires EventLoopType::uses_fd_sources
+  {
+    return event_loop_->unwatch_fd(fd);
+  }
+
+  [[nodiscard]] IoBuffer acquire_io_buffer() noexcept
+    requires EventLoopType::uses_async_io
+  {
+    return event_loop_->acquire_io_buffer();
+  }
+
+  template<typename Completion>
+    requires EventLoopType::uses_async_io
+  bool submit_read(int fd, std::size_t length, std::uint64_t offset)
+  {
+    return event_loop_->template submit_read<Completion>(fd, length, offset);
+  }
+
+  template<typename Completion>
+    requires EventLoopType::uses_async_io
+  bool submit_write(int fd, IoBuffer buffer, std::uint64_t offset)
+  {
+    return event_loop_->template submit_write<Completion>(fd, std::move(buffer), offset);
+  }
+#endif
+
+  // Emit request stamped with a fresh correlation id; the matching Reply invokes callback(Reply)
+  // on the loop thread instead of being dispatched. Returns the id, for cancel(), or 0 (nothing
+  // emitted) when the RequestReply slot table is full.
+  template<typename Reply, typename Request, typename Callback>
+    requires(EventLoopType::uses_request_reply && detail::is_correlated<Request> && detail::is_correlated<Reply>
+             && detail::contains_v<detail::get_emits_t<EmitterType>, Request>)
+  correlation_id request(Request request, Callback&& callback)
+  {
+    const correlation_id id =
+      event_loop_->template add_request<EmitterType, Reply>(std::forward<Callback>(callback));
+    if (id == 0) { return 0; }
+    request.correlation_id = id;
+    emit(std::move(request));
+    return id;
+  }
+
+  // As above, but when no reply arrives within timeout the loop calls callback(RequestStatus::timed_out)
+  // on a later poll, frees the slot, and a late reply goes to this receiver's on_event
+  template<typename Reply, typename Request, typename Rep, typename Period, typename Callback>
+    requires(EventLoopType::uses_request_reply && detail::is_correlated<Request> && detail::is_correlated<Reply>
+             && detail::contains_v<detail::get_emits_t<EmitterType>, Request>)
+  correlation_id request(Request request, std::chrono::duration<Rep, Period> timeout, Callback&& callback)
+  {
+    static_assert(std::is_invocable_v<std::decay_t<Callback>&, RequestStatus>,
+      "A request with a timeout needs a callback that also accepts ev_loop::RequestStatus");
+    const auto deadline =
+      detail::TimerList::clock::now() + std::chrono::ceil<detail::TimerList::clock::duration>(timeout);
+    const correlation_id id =
+      event_loop_->template add_request<EmitterType, Reply>(std::forward<Callback>(callback), deadline);
+    if (id == 0) { return 0; }
+    request.correlation_id = id;
+    emit(std::move(request));
+    return id;
+  }
+
+  // Release a pending request of this loop; see EventLoop::cancel
+  bool cancel(correlation_id id)
+    requires EventLoopType::uses_request_reply
+  {
+    return event_loop_->cancel(id);
+  }
+
+  // Answer a request: reply carries the request's correlation id back to the requester
+  template<typename Request, typename Reply>
+    requires(detail::is_correlated<Request> && detail::is_correlated<Reply>
+             && detail::contains_v<detail::get_emits_t<EmitterType>, Reply>)
+  void reply(const Request& request, Reply reply)
+  {
+    reply.correlation_id = request.correlation_id;
+    emit(std::move(reply));
+  }
+
+  // Coroutine handlers only: co_await next<Event>() yields this receiver's next Event
+  // (the event bypasses on_event while a coroutine is waiting for it)
+  template<typename Event>
+    requires detail::contains_v<detail::get_receives_t<EmitterType>, Event>
+  [[nodiscard]] detail::NextAwaiter<Event> next() noexcept
+  {
+    return detail::NextAwaiter<Event>(event_loop_->template await_list<EmitterType, Event>());
+  }
+
+  // co_await sleep(duration) resumes the coroutine on the loop thread once duration has passed
+  template<typename Rep, typename Period>
+    requires EventLoopType::uses_coroutines
+  [[nodiscard]] detail::SleepAwaiter sleep(std::chrono::duration<Rep, Period> duration) noexcept
+  {
+    const auto deadline =
+      detail::TimerList::clock::now() + std::chrono::ceil<detail::TimerList::clock::duration>(duration);
+    return { event_loop_->timers_, deadline };
+  }
+
+  // Frame allocator picked up by ev_loop::task (nullptr when the loop has no coroutine handlers)
+  [[nodiscard]] detail::FramePool* frame_pool() const noexcept
+  {
+    if constexpr (EventLoopType::uses_coroutines) {
+      return &event_loop_->frame_pool_;
+    } else {
+      return nullptr;
+    }
+  }
+
 private:
   EventLoopType* event_loop_;
 };
@@ -1609,7 +7741,13 @@ public:
   void emit(Event&& event)
   {
     using E = std::decay_t<Event>;
+    [[maybe_unused]] const auto allocation_guard =
+      event_loop_->allocations_.template emit_guard<EmitterType, E>();
     if constexpr (to_queue<E> && to_threads<E>) {
+      if (EventLoopType::routed_by_loop(event)) {
+        event_loop_->queue_.push_remote_event(std::forward<Event>(event));
+        return;
+      }
       event_loop_->queue_.push_remote_event(event);
       event_loop_->push_to_own_thread(std::forward<Event>(event));
     } else if constexpr (to_queue<E>) {
@@ -1619,6 +7757,16 @@ public:
     }
   }
 
+  // Answer a request: reply carries the request's correlation id back to the requester
+  template<typename Request, typename Reply>
+    requires(detail::is_correlated<Request> && detail::is_correlated<Reply>
+             && detail::contains_v<detail::get_emits_t<EmitterType>, Reply>)
+  void reply(const Request& request, Reply reply)
+  {
+    reply.correlation_id = request.correlation_id;
+    emit(std::move(reply));
+  }
+
 private:
   EventLoopType* event_loop_;
 };
@@ -1643,6 +7791,10 @@ public:
   bool emit(Event&& event)
   {
     if (auto locked = loop_.lock()) {
+      // Pushes show up under the emitter's name in lock profiles
+      [[maybe_unused]] const std::
+        conditional_t<EventLoopType::uses_lock_profile, detail::LockThreadScope, detail::NoLockThreadScope>
+          lock_thread{ detail::type_name<EmitterType>() };
       dispatcher_type dispatcher(locked.get());
       dispatcher.emit(std::forward<Event>(event));
       return true;
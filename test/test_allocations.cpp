@@ -0,0 +1,256 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ev_loop/ev.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Replaces the global operator new/delete, so this file builds into its own test executable
+EV_LOOP_TRACK_ALLOCATIONS();
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 10;
+constexpr std::size_t kNoteLength = 64;
+
+struct Ping
+{
+  int value;
+};
+
+struct Pong
+{
+  int value;
+};
+
+// Long enough to stay out of the small-string buffer, so every copy allocates
+struct Note
+{
+  std::string text;
+};
+
+struct Payload
+{
+  std::uint64_t words[8]; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+};
+
+// Allocates once per event and frees the previous allocation
+struct Allocator
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  std::unique_ptr<Payload> held;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/) { held = std::make_unique<Payload>(); }
+};
+
+struct Quiet
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/) { ++received; }
+};
+
+// Emits a copy of its note, so the allocation happens inside the emit
+struct Announcer
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Note>;
+  using thread_mode = ev_loop::SameThread;
+
+  Note note{ std::string(kNoteLength, 'n') };
+
+  template<typename D> void on_event(Ping /*ping*/, D& dispatcher) { dispatcher.emit(note); }
+};
+
+struct NoteSink
+{
+  using receives = ev_loop::type_list<Note>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(const Note& /*note*/, D& /*dispatcher*/) { ++received; }
+};
+
+struct Strict
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+  static constexpr bool no_alloc = true;
+
+  std::unique_ptr<Payload> held;
+
+  template<typename D> void on_event(Ping ping, D& /*dispatcher*/)
+  {
+    if (ping.value % 2 == 1) { held = std::make_unique<Payload>(); }
+  }
+};
+
+struct Worker
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  std::unique_ptr<Payload> held;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher)
+  {
+    held = std::make_unique<Payload>();
+    dispatcher.emit(Pong{ ping.value });
+  }
+};
+
+struct Collector
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++received; }
+};
+
+template<typename Loop> void send(Loop& loop, int count)
+{
+  ev_loop::Spin spin{ loop };
+  for (int idx = 0; idx < count; ++idx) {
+    loop.emit(Ping{ idx });
+    while (spin.poll()) {}
+  }
+}
+
+// What the no_alloc handler saw; written on the loop thread only
+int violations = 0;
+std::string_view violating_receiver;
+std::size_t violating_bytes = 0;
+
+void record_violation(std::string_view receiver, std::string_view /*event*/, std::size_t bytes)
+{
+  ++violations;
+  violating_receiver = receiver;
+  violating_bytes = bytes;
+}
+
+} // namespace
+
+// =============================================================================
+// Attribution
+// =============================================================================
+
+TEST_CASE("AllocationTracking charges allocations to the handler that made them", "[allocation]")
+{
+  ev_loop::EventLoop<Allocator, Quiet, ev_loop::AllocationTracking> loop;
+  loop.start();
+  send(loop, kEvents);
+  loop.stop();
+
+  const auto snapshot = loop.allocations().snapshot();
+  const auto* allocator = snapshot.find(ev_loop::AllocationSite::dispatch,
+    ev_loop::detail::type_name<Allocator>(),
+    ev_loop::detail::type_name<Ping>());
+  REQUIRE(allocator != nullptr);
+  REQUIRE(allocator->allocations == kEvents);
+  REQUIRE(allocator->deallocations == kEvents - 1);
+  REQUIRE(allocator->bytes == kEvents * sizeof(Payload));
+  REQUIRE(snapshot.find(ev_loop::AllocationSite::dispatch,
+            ev_loop::detail::type_name<Quiet>(),
+            ev_loop::detail::type_name<Ping>())
+          == nullptr);
+  REQUIRE(snapshot.entries.front().source == allocator->source);
+
+  // Outside handlers nothing is counted
+  const auto outside = std::make_unique<Payload>();
+  REQUIRE(loop.allocations().snapshot().allocations() == snapshot.allocations());
+
+  const std::string table = snapshot.table();
+  REQUIRE(table.find("Allocator <- ") != std::string::npos);
+  REQUIRE(table.find("Quiet") == std::string::npos);
+}
+
+TEST_CASE("AllocationTracking charges allocations inside an emit to the emitter", "[allocation]")
+{
+  ev_loop::EventLoop<Announcer, NoteSink, ev_loop::AllocationTracking> loop;
+  loop.start();
+  send(loop, kEvents);
+  loop.stop();
+  REQUIRE(loop.get<NoteSink>().received == kEvents);
+
+  const auto snapshot = loop.allocations().snapshot();
+  const auto* emit = snapshot.find(ev_loop::AllocationSite::emit,
+    ev_loop::detail::type_name<Announcer>(),
+    ev_loop::detail::type_name<Note>());
+  REQUIRE(emit != nullptr);
+  REQUIRE(emit->allocations >= kEvents);
+  REQUIRE(emit->bytes >= kEvents * (kNoteLength + 1));
+  REQUIRE(snapshot.find(ev_loop::AllocationSite::dispatch,
+            ev_loop::detail::type_name<Announcer>(),
+            ev_loop::detail::type_name<Ping>())
+          == nullptr);
+  REQUIRE(snapshot.table().find("Announcer -> ") != std::string::npos);
+}
+
+TEST_CASE("AllocationTracking covers OwnThread receivers", "[allocation]")
+{
+  ev_loop::EventLoop<Worker, Collector, ev_loop::AllocationTracking> loop;
+  loop.start();
+  for (int idx = 0; idx < kEvents; ++idx) { loop.emit(Ping{ idx }); }
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received < kEvents; });
+  loop.stop();
+
+  const auto snapshot = loop.allocations().snapshot();
+  const auto* worker = snapshot.find(
+    ev_loop::AllocationSite::dispatch, ev_loop::detail::type_name<Worker>(), ev_loop::detail::type_name<Ping>());
+  REQUIRE(worker != nullptr);
+  REQUIRE(worker->allocations == kEvents);
+  REQUIRE(worker->bytes == kEvents * sizeof(Payload));
+}
+
+// =============================================================================
+// no_alloc receivers
+// =============================================================================
+
+TEST_CASE("AllocationTracking reports allocations in no_alloc receivers", "[allocation]")
+{
+  violations = 0;
+  const ev_loop::NoAllocHandler previous = ev_loop::set_no_alloc_handler(&record_violation);
+
+  ev_loop::EventLoop<Strict, ev_loop::AllocationTracking> loop;
+  loop.start();
+  send(loop, kEvents);
+  loop.stop();
+  ev_loop::set_no_alloc_handler(previous);
+
+  // Only odd values allocate
+  REQUIRE(violations == kEvents / 2);
+  REQUIRE(violating_receiver.ends_with("Strict"));
+  REQUIRE(violating_bytes == sizeof(Payload));
+  const auto* strict = loop.allocations().snapshot().find(
+    ev_loop::AllocationSite::dispatch, ev_loop::detail::type_name<Strict>(), ev_loop::detail::type_name<Ping>());
+  REQUIRE(strict != nullptr);
+  REQUIRE(strict->allocations == kEvents / 2);
+}
+
+TEST_CASE("AllocationTracking leaves loops without the option alone", "[allocation]")
+{
+  violations = 0;
+  const ev_loop::NoAllocHandler previous = ev_loop::set_no_alloc_handler(&record_violation);
+
+  ev_loop::EventLoop<Strict> loop;
+  loop.start();
+  send(loop, kEvents);
+  loop.stop();
+  ev_loop::set_no_alloc_handler(previous);
+
+  REQUIRE(violations == 0);
+}
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ev_loop/ev.hpp>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if EV_HAS_EVENTFD
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr std::size_t kChunkSize = 64;
+constexpr std::size_t kChunkCount = 4; // kChunkSize * kChunkCount <= 256 keeps offsets byte-encodable
+constexpr std::size_t kSmallPool = 2;
+
+using BlockWritten = ev_loop::IoCompletion<struct WriteTag>;
+using BlockRead = ev_loop::IoCompletion<struct ReadTag>;
+
+struct StartCopy
+{
+  int fd;
+};
+
+// RAII temporary file, unlinked on creation
+struct TempFile
+{
+  int fd = -1;
+  TempFile()
+  {
+    std::array<char, 32> path{ "/tmp/ev_loop_ioXXXXXX" };
+    fd = ::mkstemp(path.data());
+    REQUIRE(fd >= 0);
+    ::unlink(path.data());
+  }
+  ~TempFile() { ::close(fd); }
+  TempFile(const TempFile&) = delete;
+  TempFile& operator=(const TempFile&) = delete;
+  TempFile(TempFile&&) = delete;
+  TempFile& operator=(TempFile&&) = delete;
+};
+
+// Writes kChunkCount chunks, then reads every chunk back once all writes completed
+struct FileReceiver
+{
+  using receives = ev_loop::type_list<StartCopy, BlockWritten, BlockRead>;
+  using thread_mode = ev_loop::SameThread;
+
+  int writes_done = 0;
+  int reads_done = 0;
+  int errors = 0;
+  bool data_matches = true;
+
+  static std::byte pattern(std::size_t chunk, std::size_t idx)
+  {
+    return static_cast<std::byte>((chunk * kChunkSize + idx) & 0xFFU);
+  }
+
+  template<typename D> void on_event(StartCopy event, D& dispatcher)
+  {
+    for (std::size_t chunk = 0; chunk < kChunkCount; ++chunk) {
+      ev_loop::IoBuffer buffer = dispatcher.acquire_io_buffer();
+      REQUIRE(buffer);
+      buffer.resize(kChunkSize);
+      for (std::size_t idx = 0; idx < kChunkSize; ++idx) { buffer.data()[idx] = pattern(chunk, idx); }
+      REQUIRE(dispatcher.template submit_write<BlockWritten>(event.fd, std::move(buffer), chunk * kChunkSize));
+    }
+  }
+
+  template<typename D> void on_event(BlockWritten event, D& dispatcher)
+  {
+    if (event.result != static_cast<int>(kChunkSize)) { ++errors; }
+    REQUIRE(event.buffer.size() == kChunkSize);
+    if (++writes_done == static_cast<int>(kChunkCount)) {
+      for (std::size_t chunk = 0; chunk < kChunkCount; ++chunk) {
+        REQUIRE(dispatcher.template submit_read<BlockRead>(event.fd, kChunkSize, chunk * kChunkSize));
+      }
+    }
+  }
+
+  template<typename D> void on_event(BlockRead event, D& /*dispatcher*/)
+  {
+    if (event.result != static_cast<int>(kChunkSize) || event.buffer.data() == nullptr) {
+      ++errors;
+      return;
+    }
+    // Every byte encodes its file offset, so the chunk is recoverable from the first byte
+    const std::span<std::byte> bytes = event.buffer.bytes();
+    const auto chunk = static_cast<std::size_t>(bytes.front()) / kChunkSize;
+    for (std::size_t idx = 0; idx < bytes.size(); ++idx) {
+      data_matches = data_matches && bytes[idx] == pattern(chunk, idx);
+    }
+    ++reads_done;
+  }
+};
+
+// Reads from a pipe nobody writes to, so the read stays in flight until the loop is destroyed
+struct StalledReader
+{
+  using receives = ev_loop::type_list<StartCopy, BlockRead>;
+  using thread_mode = ev_loop::SameThread;
+
+  bool submitted = false;
+
+  template<typename D> void on_event(StartCopy event, D& dispatcher)
+  {
+    submitted = dispatcher.template submit_read<BlockRead>(event.fd, kChunkSize, 0);
+  }
+
+  template<typename D> void on_event(BlockRead /*event*/, D& /*dispatcher*/) {}
+};
+
+template<ev_loop::IoBackend Backend>
+using FileLoop = ev_loop::EventLoop<FileReceiver, ev_loop::IoUring<16, 16, 64, Backend>>;
+
+template<typename Loop, typename Strategy> void run_copy()
+{
+  Loop loop;
+  loop.start();
+  TempFile file;
+  loop.emit(StartCopy{ file.fd });
+  Strategy{ loop }.run_while(
+    [&] { return loop.template get<FileReceiver>().reads_done < static_cast<int>(kChunkCount); });
+
+  const auto& receiver = loop.template get<FileReceiver>();
+  REQUIRE(receiver.writes_done == static_cast<int>(kChunkCount));
+  REQUIRE(receiver.reads_done == static_cast<int>(kChunkCount));
+  REQUIRE(receiver.errors == 0);
+  REQUIRE(receiver.data_matches);
+  loop.stop();
+}
+
+} // namespace
+
+// =============================================================================
+// Round trips
+// =============================================================================
+
+TEST_CASE("IoUring writes and reads back a file", "[async_io]")
+{
+  SECTION("automatic backend with Spin")
+  {
+    run_copy<FileLoop<ev_loop::IoBackend::automatic>, ev_loop::Spin<FileLoop<ev_loop::IoBackend::automatic>>>();
+  }
+
+  SECTION("automatic backend with Wait")
+  {
+    run_copy<FileLoop<ev_loop::IoBackend::automatic>, ev_loop::Wait<FileLoop<ev_loop::IoBackend::automatic>>>();
+  }
+
+  SECTION("thread-pool backend with Spin")
+  {
+    run_copy<FileLoop<ev_loop::IoBackend::thread_pool>, ev_loop::Spin<FileLoop<ev_loop::IoBackend::thread_pool>>>();
+  }
+
+  SECTION("thread-pool backend with Hybrid")
+  {
+    run_copy<FileLoop<ev_loop::IoBackend::thread_pool>, ev_loop::Hybrid<FileLoop<ev_loop::IoBackend::thread_pool>>>();
+  }
+}
+
+TEST_CASE("IoUring reports the backend in use", "[async_io]")
+{
+  FileLoop<ev_loop::IoBackend::thread_pool> pool_loop;
+  REQUIRE(pool_loop.io_backend() == ev_loop::IoBackend::thread_pool);
+
+  FileLoop<ev_loop::IoBackend::automatic> auto_loop;
+  REQUIRE(auto_loop.io_backend() != ev_loop::IoBackend::automatic);
+}
+
+// =============================================================================
+// Errors and limits
+// =============================================================================
+
+TEST_CASE("IoUring surfaces errors and pool exhaustion", "[async_io]")
+{
+  using SmallLoop = ev_loop::EventLoop<FileReceiver, ev_loop::IoUring<4, kSmallPool, 64>>;
+  SmallLoop loop;
+  loop.start();
+
+  SECTION("buffers are returned to the pool when released")
+  {
+    std::vector<ev_loop::IoBuffer> held;
+    for (std::size_t idx = 0; idx < kSmallPool; ++idx) { held.push_back(loop.acquire_io_buffer()); }
+    REQUIRE(std::ranges::all_of(held, [](const ev_loop::IoBuffer& buffer) { return static_cast<bool>(buffer); }));
+    REQUIRE_FALSE(loop.acquire_io_buffer());
+    REQUIRE_FALSE(loop.submit_read<BlockRead>(0, kChunkSize, 0));
+
+    held.pop_back();
+    REQUIRE(loop.acquire_io_buffer());
+  }
+
+  SECTION("read lengths are clamped to the buffer size")
+  {
+    ev_loop::IoBuffer buffer = loop.acquire_io_buffer();
+    buffer.resize(kChunkSize * 4);
+    REQUIRE(buffer.size() == buffer.capacity());
+  }
+
+  SECTION("failed operations complete with -errno")
+  {
+    REQUIRE(loop.submit_read<BlockRead>(-1, kChunkSize, 0));
+    ev_loop::Spin{ loop }.run_while([&] { return loop.get<FileReceiver>().errors == 0; });
+    REQUIRE(loop.get<FileReceiver>().errors == 1);
+    REQUIRE(loop.get<FileReceiver>().reads_done == 0);
+    // The failed read's buffer went back to the pool
+    std::vector<ev_loop::IoBuffer> held;
+    for (std::size_t idx = 0; idx < kSmallPool; ++idx) {
+      held.push_back(loop.acquire_io_buffer());
+      REQUIRE(held.back());
+    }
+  }
+
+  loop.stop();
+}
+
+#if EV_HAS_IO_URING
+TEST_CASE("IoUringRing submits every staged request", "[async_io]")
+{
+  constexpr unsigned kEntries = 8;
+  ev_loop::detail::IoUringRing ring{ kEntries };
+  REQUIRE(ring.valid());
+  std::array<std::byte, kChunkSize> target{};
+  for (std::uint32_t slot = 0; slot < kEntries; ++slot) {
+    REQUIRE(ring.push(ev_loop::detail::IoRequest{ .slot = slot,
+      .is_write = false,
+      .fd = -1,
+      .offset = 0,
+      .data = target.data(),
+      .length = kChunkSize,
+      .buffer = 0 }));
+  }
+
+  // Completions reaped or refused during submit come back through the callback, the rest through reap()
+  std::vector<int> results;
+  const auto complete = [&](std::uint32_t /*slot*/, int result) { results.push_back(result); };
+  ring.submit(complete);
+  while (results.size() < kEntries) { std::ignore = ring.reap(complete); }
+  REQUIRE(std::ranges::all_of(results, [](int result) { return result == -EBADF; }));
+}
+
+TEST_CASE("IoUring cancels reads still in flight when the loop is destroyed", "[async_io]")
+{
+  std::array<int, 2> fds{};
+  REQUIRE(::pipe(fds.data()) == 0);
+  {
+    ev_loop::EventLoop<StalledReader, ev_loop::IoUring<4, 4, 64, ev_loop::IoBackend::io_uring>> loop;
+    loop.start();
+    loop.emit(StartCopy{ fds[0] });
+    ev_loop::Spin{ loop }.run_while([&] { return !loop.get<StalledReader>().submitted; });
+    loop.stop();
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST_CASE("IoUringRing cancels a read that would never complete", "[async_io]")
+{
+  ev_loop::detail::IoUringRing ring{ 4 };
+  REQUIRE(ring.valid());
+  std::array<int, 2> fds{};
+  REQUIRE(::pipe(fds.data()) == 0);
+  std::array<std::byte, kChunkSize> target{};
+  REQUIRE(ring.push(ev_loop::detail::IoRequest{ .slot = 3,
+    .is_write = false,
+    .fd = fds[0],
+    .offset = 0,
+    .data = target.data(),
+    .length = kChunkSize,
+    .buffer = 0 }));
+
+  // Nothing is ever written, so only the cancel completes the read; the cancel's own CQE stays internal
+  std::vector<std::pair<std::uint32_t, int>> results;
+  const auto complete = [&](std::uint32_t slot, int result) { results.emplace_back(slot, result); };
+  ring.submit(complete);
+  REQUIRE(ring.cancel(3));
+  ring.submit(complete);
+  while (results.empty()) {
+    REQUIRE(ring.wait());
+    std::ignore = ring.reap(complete);
+  }
+  REQUIRE(results.size() == 1);
+  REQUIRE(results.front() == std::pair<std::uint32_t, int>{ 3, -ECANCELED });
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+#endif
+
+#endif // EV_HAS_EVENTFD
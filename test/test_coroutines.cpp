@@ -0,0 +1,263 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <ev_loop/ev.hpp>
+#include <vector>
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr int kCycles = 100;
+constexpr auto kShortSleep = 2ms;
+constexpr auto kLongSleep = 10ms;
+
+struct Start
+{
+  int id;
+};
+
+struct Ping
+{
+  int id;
+};
+
+struct Pong
+{
+  int id;
+};
+
+struct Reply
+{
+  int value;
+};
+
+struct Nap
+{
+  int id;
+  std::chrono::milliseconds duration;
+};
+
+// Two-step protocol: Ping the responder thread, await its Pong, then sleep
+struct Client
+{
+  using receives = ev_loop::type_list<Start, Pong>;
+  using emits = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  std::vector<int> replies;
+  int finished = 0;
+  int unsolicited = 0;
+
+  template<typename D> ev_loop::task on_event(Start start, D& dispatcher)
+  {
+    dispatcher.emit(Ping{ start.id });
+    const Pong pong = co_await dispatcher.template next<Pong>();
+    replies.push_back(pong.id);
+    co_await dispatcher.sleep(kShortSleep);
+    ++finished;
+  }
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++unsolicited; }
+};
+
+struct Responder
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.id * 10 }); }
+};
+
+using ClientLoop = ev_loop::EventLoop<Client, Responder>;
+
+// Local-only coroutines driven by the test thread
+struct Sequencer
+{
+  using receives = ev_loop::type_list<Start, Reply, Nap>;
+  using thread_mode = ev_loop::SameThread;
+
+  std::vector<int> order;
+  std::size_t frame_blocks = 0;
+  int* destroyed = nullptr;
+
+  // Counts frame teardown through a local destructor
+  struct Guard
+  {
+    int* counter;
+    explicit Guard(int* target) : counter(target) {}
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    Guard(Guard&&) = delete;
+    Guard& operator=(Guard&&) = delete;
+    ~Guard()
+    {
+      if (counter != nullptr) { ++*counter; }
+    }
+  };
+
+  template<typename D> ev_loop::task on_event(Start start, D& dispatcher)
+  {
+    const Guard guard{ destroyed };
+    const Reply reply = co_await dispatcher.template next<Reply>();
+    order.push_back((start.id * 100) + reply.value);
+    frame_blocks = dispatcher.frame_pool()->blocks();
+  }
+
+  template<typename D> ev_loop::task on_event(Nap nap, D& dispatcher)
+  {
+    const Guard guard{ destroyed };
+    co_await dispatcher.sleep(nap.duration);
+    order.push_back(nap.id);
+  }
+
+  template<typename D> void on_event(Reply reply, D& /*dispatcher*/) { order.push_back(-reply.value); }
+};
+
+using SequencerLoop = ev_loop::EventLoop<Sequencer>;
+
+template<typename Loop, typename Strategy> void run_ping_pong()
+{
+  Loop loop;
+  loop.start();
+  loop.emit(Start{ 1 });
+  loop.emit(Start{ 2 });
+  Strategy{ loop }.run_while([&] { return loop.template get<Client>().finished < 2; });
+
+  const auto& client = loop.template get<Client>();
+  REQUIRE(client.replies == std::vector<int>{ 10, 20 });
+  REQUIRE(client.unsolicited == 0);
+  loop.stop();
+}
+
+} // namespace
+
+// =============================================================================
+// Awaiting events
+// =============================================================================
+
+TEST_CASE("Coroutine handlers await replies from an OwnThread receiver", "[coroutine]")
+{
+  SECTION("Spin") { run_ping_pong<ClientLoop, ev_loop::Spin<ClientLoop>>(); }
+  SECTION("Wait") { run_ping_pong<ClientLoop, ev_loop::Wait<ClientLoop>>(); }
+  SECTION("Hybrid") { run_ping_pong<ClientLoop, ev_loop::Hybrid<ClientLoop>>(); }
+}
+
+TEST_CASE("next<Event>() intercepts events only while a coroutine waits", "[coroutine]")
+{
+  SequencerLoop loop;
+  loop.start();
+  auto& sequencer = loop.get<Sequencer>();
+  ev_loop::Spin spin{ loop };
+
+  SECTION("without a waiter the event reaches on_event")
+  {
+    loop.emit(Reply{ 5 });
+    REQUIRE(spin.poll());
+    REQUIRE(sequencer.order == std::vector<int>{ -5 });
+  }
+
+  SECTION("waiters resume in FIFO order")
+  {
+    loop.emit(Start{ 1 });
+    loop.emit(Start{ 2 });
+    loop.emit(Reply{ 7 });
+    loop.emit(Reply{ 8 });
+    loop.emit(Reply{ 9 });
+    while (spin.poll()) {}
+    REQUIRE(sequencer.order == std::vector<int>{ 107, 208, -9 });
+  }
+
+  loop.stop();
+}
+
+// =============================================================================
+// Timers
+// =============================================================================
+
+TEST_CASE("sleep() resumes coroutines in deadline order", "[coroutine]")
+{
+  SequencerLoop loop;
+  loop.start();
+  auto& sequencer = loop.get<Sequencer>();
+
+  SECTION("Spin")
+  {
+    loop.emit(Nap{ 1, kLongSleep });
+    loop.emit(Nap{ 2, kShortSleep });
+    ev_loop::Spin{ loop }.run_while([&] { return sequencer.order.size() < 2; });
+  }
+
+  SECTION("Wait blocks until the next deadline")
+  {
+    loop.emit(Nap{ 1, kLongSleep });
+    loop.emit(Nap{ 2, kShortSleep });
+    const auto start = std::chrono::steady_clock::now();
+    ev_loop::Wait{ loop }.run_while([&] { return sequencer.order.size() < 2; });
+    REQUIRE(std::chrono::steady_clock::now() - start >= kLongSleep);
+  }
+
+  REQUIRE(sequencer.order == std::vector<int>{ 2, 1 });
+  loop.stop();
+}
+
+#if EV_HAS_EVENTFD
+TEST_CASE("sleep() with eventfd and epoll waits", "[coroutine]")
+{
+  SECTION("EventFdWakeup")
+  {
+    using Loop = ev_loop::EventLoop<Client, Responder, ev_loop::EventFdWakeup>;
+    run_ping_pong<Loop, ev_loop::Wait<Loop>>();
+  }
+
+  SECTION("FdSources")
+  {
+    using Loop = ev_loop::EventLoop<Client, Responder, ev_loop::FdSources>;
+    run_ping_pong<Loop, ev_loop::Wait<Loop>>();
+  }
+}
+#endif
+
+// =============================================================================
+// Frame lifetime
+// =============================================================================
+
+TEST_CASE("Coroutine frames come from the loop's frame pool", "[coroutine]")
+{
+  SequencerLoop loop;
+  loop.start();
+  auto& sequencer = loop.get<Sequencer>();
+  ev_loop::Spin spin{ loop };
+
+  for (int cycle = 0; cycle < kCycles; ++cycle) {
+    loop.emit(Start{ 0 });
+    loop.emit(Reply{ cycle });
+    while (spin.poll()) {}
+  }
+
+  REQUIRE(sequencer.order.size() == static_cast<std::size_t>(kCycles));
+  // One frame in flight at a time: the first block is reused for every later cycle
+  REQUIRE(sequencer.frame_blocks == 1);
+  loop.stop();
+}
+
+TEST_CASE("Destroying the loop destroys suspended coroutines", "[coroutine]")
+{
+  int destroyed = 0;
+  {
+    SequencerLoop loop;
+    loop.start();
+    loop.get<Sequencer>().destroyed = &destroyed;
+    loop.emit(Start{ 1 });
+    loop.emit(Nap{ 2, std::chrono::hours{ 1 } });
+    ev_loop::Spin spin{ loop };
+    while (spin.poll()) {}
+    REQUIRE(destroyed == 0);
+  }
+  REQUIRE(destroyed == 2);
+}
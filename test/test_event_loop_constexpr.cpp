@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <ev_loop/ev.hpp>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -24,6 +25,13 @@ struct OwnThreadReceiver
   template<typename D> static void on_event(ConstexprTestEvent /*unused*/, D& /*unused*/) {}
 };
 
+struct CoroutineReceiver
+{
+  using receives = ev_loop::type_list<ConstexprTestEvent>;
+  using thread_mode = ev_loop::SameThread;
+  template<typename D> static ev_loop::task on_event(ConstexprTestEvent /*unused*/, D& /*unused*/) { co_return; }
+};
+
 struct ExternalEmitter
 {
   using emits = ev_loop::type_list<ConstexprTestEvent>;
@@ -69,6 +77,301 @@ TEST_CASE("Typed dispatcher constructors are noexcept", "[event_loop][constexpr]
   }
 }
 
+// =============================================================================
+// constexpr tests - loop options
+// =============================================================================
+
+TEST_CASE("EventFdWakeup option", "[event_loop][constexpr][eventfd]")
+{
+  SECTION("is an empty loop option tag")
+  {
+    STATIC_REQUIRE(std::is_empty_v<ev_loop::EventFdWakeup>);
+    STATIC_REQUIRE(ev_loop::detail::is_loop_option<ev_loop::EventFdWakeup>);
+    STATIC_REQUIRE_FALSE(ev_loop::detail::is_receiver<ev_loop::EventFdWakeup>);
+    STATIC_REQUIRE_FALSE(ev_loop::detail::is_external_emitter<ev_loop::EventFdWakeup>);
+  }
+
+  SECTION("default loop uses the condition variable wakeup")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver>;
+    STATIC_REQUIRE_FALSE(Loop::uses_eventfd_wakeup);
+    STATIC_REQUIRE(std::is_same_v<Loop::queue_type, ev_loop::detail::DualQueue<Loop::tagged_event, false>>);
+  }
+
+  SECTION("option selects the eventfd wakeup")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::EventFdWakeup>;
+    STATIC_REQUIRE(Loop::uses_eventfd_wakeup);
+    STATIC_REQUIRE(std::is_same_v<Loop::queue_type, ev_loop::detail::DualQueue<Loop::tagged_event, true>>);
+  }
+
+  SECTION("option takes no receiver storage")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::EventFdWakeup>;
+    STATIC_REQUIRE(std::is_empty_v<ev_loop::detail::ReceiverStorage<ev_loop::EventFdWakeup, Loop>>);
+    STATIC_REQUIRE_FALSE(std::is_empty_v<ev_loop::detail::ReceiverStorage<ConstexprTestReceiver, Loop>>);
+  }
+}
+
+TEST_CASE("FdSources option", "[event_loop][constexpr][fd_sources]")
+{
+  SECTION("implies the eventfd wakeup")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::FdSources>;
+    STATIC_REQUIRE(Loop::uses_fd_sources);
+    STATIC_REQUIRE(Loop::uses_eventfd_wakeup);
+  }
+
+  SECTION("FdEvent instantiations are distinct fd events")
+  {
+    using ReadReady = ev_loop::FdEvent<struct ReadTag>;
+    using WriteReady = ev_loop::FdEvent<struct WriteTag>;
+    STATIC_REQUIRE_FALSE(std::is_same_v<ReadReady, WriteReady>);
+    STATIC_REQUIRE(ev_loop::detail::is_fd_event<ReadReady>);
+    STATIC_REQUIRE_FALSE(ev_loop::detail::is_fd_event<ConstexprTestEvent>);
+  }
+}
+
+TEST_CASE("Coroutine handlers", "[event_loop][constexpr][coroutine]")
+{
+  SECTION("task-returning handlers enable the coroutine machinery")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, CoroutineReceiver>;
+    STATIC_REQUIRE(Loop::uses_coroutines);
+    STATIC_REQUIRE(ev_loop::detail::is_coroutine_receiver<CoroutineReceiver, Loop>);
+    STATIC_REQUIRE_FALSE(ev_loop::detail::is_coroutine_receiver<ConstexprTestReceiver, Loop>);
+  }
+
+  SECTION("plain loops carry no frame pool or timers")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, OwnThreadReceiver>;
+    STATIC_REQUIRE_FALSE(Loop::uses_coroutines);
+  }
+}
+
+TEST_CASE("RequestReply option", "[event_loop][constexpr][request_reply]")
+{
+  struct Correlated
+  {
+    ev_loop::correlation_id correlation_id;
+    int payload;
+  };
+
+  SECTION("option enables the request table")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::RequestReply<>>;
+    STATIC_REQUIRE(Loop::uses_request_reply);
+    STATIC_REQUIRE_FALSE(ev_loop::EventLoop<ConstexprTestReceiver>::uses_request_reply);
+  }
+
+  SECTION("correlated events carry a correlation_id member")
+  {
+    STATIC_REQUIRE(ev_loop::detail::is_correlated<Correlated>);
+    STATIC_REQUIRE_FALSE(ev_loop::detail::is_correlated<ConstexprTestEvent>);
+  }
+}
+
+TEST_CASE("Observe option", "[event_loop][constexpr][observer]")
+{
+  struct Counting : ev_loop::NullObserver
+  {
+    int parks = 0;
+    void on_park() noexcept { ++parks; }
+  };
+
+  SECTION("default loop has no observer")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver>;
+    STATIC_REQUIRE_FALSE(Loop::uses_observer);
+    STATIC_REQUIRE(std::is_same_v<Loop::observer_type, ev_loop::NullObserver>);
+    STATIC_REQUIRE(sizeof(Loop::queue_type) == sizeof(ev_loop::detail::DualQueue<Loop::tagged_event, false>));
+  }
+
+  SECTION("option selects the policy")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Observe<Counting>>;
+    STATIC_REQUIRE(Loop::uses_observer);
+    STATIC_REQUIRE(std::is_same_v<Loop::observer_type, Counting>);
+    STATIC_REQUIRE(std::is_same_v<Loop::queue_type, ev_loop::detail::DualQueue<Loop::tagged_event, false, Counting>>);
+  }
+}
+
+TEST_CASE("Metrics option", "[event_loop][constexpr][metrics]")
+{
+  SECTION("option installs the registry hooks")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Metrics>;
+    STATIC_REQUIRE(Loop::uses_metrics);
+    STATIC_REQUIRE(Loop::observed);
+    STATIC_REQUIRE_FALSE(Loop::uses_observer);
+    STATIC_REQUIRE_FALSE(ev_loop::EventLoop<ConstexprTestReceiver>::observed);
+  }
+
+  SECTION("labels use the type names")
+  {
+    STATIC_REQUIRE(ev_loop::detail::type_name<ConstexprTestEvent>().ends_with("ConstexprTestEvent"));
+    STATIC_REQUIRE(ev_loop::detail::type_name<int>() == "int");
+  }
+
+  SECTION("probe arguments carry NUL-terminated type names")
+  {
+    constexpr auto& name = ev_loop::detail::type_name_cstr<ConstexprTestEvent>;
+    STATIC_REQUIRE(std::string_view{ name.data() } == ev_loop::detail::type_name<ConstexprTestEvent>());
+    STATIC_REQUIRE(name.back() == '\0');
+  }
+}
+
+TEST_CASE("DispatchLatency option", "[event_loop][constexpr][latency]")
+{
+  SECTION("option stamps the queue slots")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::DispatchLatency>;
+    STATIC_REQUIRE(Loop::uses_latency);
+    STATIC_REQUIRE_FALSE(Loop::observed);
+    STATIC_REQUIRE(std::is_base_of_v<Loop::tagged_event, Loop::slot_event>);
+    STATIC_REQUIRE(std::is_same_v<ev_loop::EventLoop<ConstexprTestReceiver>::slot_event,
+      ev_loop::EventLoop<ConstexprTestReceiver>::tagged_event>);
+  }
+
+  SECTION("histogram buckets")
+  {
+    STATIC_REQUIRE(ev_loop::LatencyHistogram::bucket_of(31) == 31);
+    STATIC_REQUIRE(ev_loop::LatencyHistogram::bucket_of(32) == 32);
+    STATIC_REQUIRE(ev_loop::LatencyHistogram::bucket_of(33) == 32);
+    STATIC_REQUIRE(ev_loop::LatencyHistogram::bucket_upper(32) == 33);
+  }
+}
+
+TEST_CASE("Trace option", "[event_loop][constexpr][trace]")
+{
+  using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Trace>;
+  STATIC_REQUIRE(Loop::uses_trace);
+  STATIC_REQUIRE_FALSE(Loop::uses_latency);
+  STATIC_REQUIRE(ev_loop::detail::is_traced<Loop::slot_event>);
+  STATIC_REQUIRE(ev_loop::detail::is_stamped<Loop::slot_event>);
+  STATIC_REQUIRE_FALSE(ev_loop::detail::is_traced<ev_loop::EventLoop<ConstexprTestReceiver>::slot_event>);
+  STATIC_REQUIRE(sizeof(ev_loop::detail::TraceRecord) == 32);
+}
+
+TEST_CASE("Utilization option", "[event_loop][constexpr][utilization]")
+{
+  struct Counting : ev_loop::NullObserver
+  {
+    int parks = 0;
+    void on_park() noexcept { ++parks; }
+  };
+
+  SECTION("option installs the registry hooks")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Utilization>;
+    STATIC_REQUIRE(Loop::uses_utilization);
+    STATIC_REQUIRE(Loop::observed);
+    STATIC_REQUIRE_FALSE(Loop::uses_metrics);
+  }
+
+  SECTION("registries and the policy share one observer set")
+  {
+    using Loop =
+      ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Metrics, ev_loop::Utilization, ev_loop::Observe<Counting>>;
+    STATIC_REQUIRE(std::is_same_v<Loop::hooks_type,
+      ev_loop::detail::ObserverSet<ev_loop::detail::MetricsRegistry<ConstexprTestReceiver,
+                                     ev_loop::Metrics,
+                                     ev_loop::Utilization,
+                                     ev_loop::Observe<Counting>>,
+        ev_loop::detail::UtilizationRegistry,
+        Counting>>);
+  }
+}
+
+TEST_CASE("PerfCounters option", "[event_loop][constexpr][perf_counters]")
+{
+  SECTION("option installs the registry hooks")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::PerfCounters>;
+    STATIC_REQUIRE(Loop::uses_perf_counters);
+    STATIC_REQUIRE(Loop::observed);
+    STATIC_REQUIRE(std::is_same_v<Loop::hooks_type,
+      ev_loop::detail::ObserverSet<ev_loop::detail::PerfCounterRegistry, ev_loop::NullObserver>>);
+    STATIC_REQUIRE_FALSE(ev_loop::EventLoop<ConstexprTestReceiver>::uses_perf_counters);
+  }
+
+  SECTION("counters follow the other registries")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Utilization, ev_loop::PerfCounters>;
+    STATIC_REQUIRE(std::is_same_v<Loop::hooks_type,
+      ev_loop::detail::ObserverSet<ev_loop::detail::UtilizationRegistry,
+        ev_loop::detail::PerfCounterRegistry,
+        ev_loop::NullObserver>>);
+  }
+}
+
+TEST_CASE("Watchdog option", "[event_loop][constexpr][watchdog]")
+{
+  using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Watchdog>;
+  STATIC_REQUIRE(Loop::uses_watchdog);
+  STATIC_REQUIRE_FALSE(Loop::observed);
+  STATIC_REQUIRE_FALSE(ev_loop::EventLoop<ConstexprTestReceiver>::uses_watchdog);
+  // Stamps live beside the loop, not in the queue slots
+  STATIC_REQUIRE(std::is_same_v<Loop::slot_event, Loop::tagged_event>);
+}
+
+TEST_CASE("Profile option", "[event_loop][constexpr][profile]")
+{
+  SECTION("option selects the sampling period")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::Profile<128, false>>;
+    STATIC_REQUIRE(Loop::uses_profile);
+    STATIC_REQUIRE_FALSE(Loop::observed);
+    STATIC_REQUIRE(ev_loop::Profile<>::period == 64);
+    STATIC_REQUIRE(ev_loop::Profile<>::jitter);
+    STATIC_REQUIRE_FALSE(ev_loop::EventLoop<ConstexprTestReceiver>::uses_profile);
+  }
+
+  SECTION("dispatch slots cover every receiver and event pair")
+  {
+    using Slots = ev_loop::detail::DispatchSlots<ConstexprTestReceiver, ev_loop::Metrics>;
+    STATIC_REQUIRE(Slots::count == 1);
+    STATIC_REQUIRE(Slots::index<ConstexprTestReceiver, ConstexprTestEvent>() == 0);
+    STATIC_REQUIRE(Slots::labels[0].second.ends_with("ConstexprTestEvent"));
+  }
+}
+
+#if EV_HAS_EVENTFD
+TEST_CASE("FlightRecorder option", "[event_loop][constexpr][flight_recorder]")
+{
+  using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::FlightRecorder>;
+  STATIC_REQUIRE(Loop::uses_flight_recorder);
+  STATIC_REQUIRE_FALSE(Loop::observed);
+  // Recording needs no queue slot changes
+  STATIC_REQUIRE(std::is_same_v<Loop::slot_event, Loop::tagged_event>);
+}
+#endif
+
+TEST_CASE("IoUring option", "[event_loop][constexpr][async_io]")
+{
+  SECTION("implies fd sources")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver, ev_loop::IoUring<>>;
+    STATIC_REQUIRE(Loop::uses_async_io);
+    STATIC_REQUIRE(Loop::uses_fd_sources);
+    STATIC_REQUIRE(Loop::uses_eventfd_wakeup);
+  }
+
+  SECTION("plain loops carry no I/O state")
+  {
+    using Loop = ev_loop::EventLoop<ConstexprTestReceiver>;
+    STATIC_REQUIRE_FALSE(Loop::uses_async_io);
+  }
+
+  SECTION("IoCompletion instantiations are move-only completion events")
+  {
+    using Done = ev_loop::IoCompletion<struct DoneTag>;
+    STATIC_REQUIRE(ev_loop::detail::is_io_completion<Done>);
+    STATIC_REQUIRE_FALSE(std::is_copy_constructible_v<Done>);
+    STATIC_REQUIRE_FALSE(ev_loop::detail::is_io_completion<ConstexprTestEvent>);
+  }
+}
+
 // =============================================================================
 // constexpr tests - thread_mode tag types and traits
 // =============================================================================
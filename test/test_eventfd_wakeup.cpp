@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <ev_loop/ev.hpp>
+#include <thread>
+
+#if EV_HAS_EVENTFD
+
+#include <poll.h>
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEventCount = 100;
+constexpr int kChainLength = 5;
+constexpr int kStopDelayMs = 10;
+
+struct RemoteEvent
+{
+  int value;
+};
+
+struct ChainEvent
+{
+  int value;
+};
+
+struct Trigger
+{
+};
+
+struct CollectingReceiver
+{
+  using receives = ev_loop::type_list<RemoteEvent, ChainEvent>;
+  using emits = ev_loop::type_list<ChainEvent>;
+  using thread_mode = ev_loop::SameThread;
+
+  int remote_count = 0;
+  int chain_count = 0;
+
+  template<typename D> void on_event(RemoteEvent /*event*/, D& /*dispatcher*/) { ++remote_count; }
+
+  template<typename D> void on_event(ChainEvent event, D& dispatcher)
+  {
+    ++chain_count;
+    if (event.value > 1) { dispatcher.emit(ChainEvent{ event.value - 1 }); }
+  }
+};
+
+// OwnThread producer that forwards each trigger as a remote event to the loop thread
+struct ThreadedProducer
+{
+  using receives = ev_loop::type_list<Trigger>;
+  using emits = ev_loop::type_list<RemoteEvent>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Trigger /*event*/, D& dispatcher) { dispatcher.emit(RemoteEvent{ 1 }); }
+};
+
+struct NetworkEmitter
+{
+  using emits = ev_loop::type_list<RemoteEvent>;
+};
+
+using FdLoop = ev_loop::EventLoop<CollectingReceiver, NetworkEmitter, ev_loop::EventFdWakeup>;
+
+bool is_readable(int fd, int timeout_ms = 0)
+{
+  pollfd pfd{ .fd = fd, .events = POLLIN, .revents = 0 };
+  return ::poll(&pfd, 1, timeout_ms) == 1 && (pfd.revents & POLLIN) != 0;
+}
+
+} // namespace
+
+// =============================================================================
+// native_handle / poll_ready
+// =============================================================================
+
+TEST_CASE("EventFdWakeup exposes a pollable handle", "[eventfd]")
+{
+  ev_loop::SharedEventLoopPtr<CollectingReceiver, NetworkEmitter, ev_loop::EventFdWakeup> loop;
+  loop.start();
+  auto emitter = loop.get_external_emitter<NetworkEmitter>();
+  const int fd = loop->native_handle();
+
+  REQUIRE(fd >= 0);
+
+  SECTION("not readable while idle") { REQUIRE_FALSE(is_readable(fd)); }
+
+  SECTION("readable after a remote emit, cleared by poll_ready")
+  {
+    REQUIRE(emitter.emit(RemoteEvent{ 1 }));
+    REQUIRE(is_readable(fd));
+    REQUIRE(loop->poll_ready() == 1);
+    REQUIRE(loop.get<CollectingReceiver>().remote_count == 1);
+    REQUIRE_FALSE(is_readable(fd));
+  }
+
+  SECTION("several remote emits coalesce into one wakeup")
+  {
+    for (int idx = 0; idx < kEventCount; ++idx) { REQUIRE(emitter.emit(RemoteEvent{ idx })); }
+    REQUIRE(is_readable(fd));
+    REQUIRE(loop->poll_ready() == static_cast<std::size_t>(kEventCount));
+    REQUIRE_FALSE(is_readable(fd));
+  }
+
+  loop.stop();
+}
+
+TEST_CASE("poll_ready drains local events emitted during dispatch", "[eventfd]")
+{
+  FdLoop loop;
+  loop.start();
+
+  loop.emit(ChainEvent{ kChainLength });
+  REQUIRE(loop.poll_ready() == static_cast<std::size_t>(kChainLength));
+  REQUIRE(loop.get<CollectingReceiver>().chain_count == kChainLength);
+  REQUIRE(loop.poll_ready() == 0U);
+
+  loop.stop();
+}
+
+TEST_CASE("poll_ready budget re-arms the handle", "[eventfd]")
+{
+  FdLoop loop;
+  loop.start();
+
+  loop.emit(ChainEvent{ kChainLength });
+  REQUIRE(loop.poll_ready(2) == 2U);
+  REQUIRE(is_readable(loop.native_handle()));
+  REQUIRE(loop.poll_ready() == static_cast<std::size_t>(kChainLength - 2));
+  REQUIRE_FALSE(is_readable(loop.native_handle()));
+
+  loop.stop();
+}
+
+// =============================================================================
+// Blocking strategies on the eventfd
+// =============================================================================
+
+TEST_CASE("Wait strategy blocks on the eventfd", "[eventfd][strategies]")
+{
+  ev_loop::EventLoop<CollectingReceiver, ThreadedProducer, ev_loop::EventFdWakeup> loop;
+  loop.start();
+
+  SECTION("wakes for events emitted from an OwnThread receiver")
+  {
+    for (int idx = 0; idx < kEventCount; ++idx) { loop.emit(Trigger{}); }
+    ev_loop::Wait{ loop }.run_while([&] { return loop.get<CollectingReceiver>().remote_count < kEventCount; });
+    REQUIRE(loop.get<CollectingReceiver>().remote_count == kEventCount);
+  }
+
+  SECTION("Hybrid falls back to the eventfd")
+  {
+    constexpr std::size_t kSpinCount = 10;
+    for (int idx = 0; idx < kEventCount; ++idx) { loop.emit(Trigger{}); }
+    ev_loop::Hybrid{ loop, kSpinCount }.run_while(
+      [&] { return loop.get<CollectingReceiver>().remote_count < kEventCount; });
+    REQUIRE(loop.get<CollectingReceiver>().remote_count == kEventCount);
+  }
+
+  SECTION("stop unblocks a waiting consumer")
+  {
+    std::thread stopper([&loop] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kStopDelayMs));
+      loop.stop();
+    });
+    REQUIRE_FALSE(ev_loop::Wait{ loop }.poll());
+    stopper.join();
+  }
+
+  loop.stop();
+}
+
+#endif
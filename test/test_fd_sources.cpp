@@ -0,0 +1,315 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <ev_loop/ev.hpp>
+#include <thread>
+
+#if EV_HAS_EVENTFD
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEventCount = 50;
+constexpr int kWriterDelayMs = 10;
+constexpr long kTimerNanos = 1'000'000;
+
+using PipeReadable = ev_loop::FdEvent<struct PipeTag>;
+using TimerExpired = ev_loop::FdEvent<struct TimerTag>;
+
+// Custom aggregate readiness event (no FdEvent template)
+struct ControlReadable
+{
+  int fd;
+  std::uint32_t events;
+};
+
+struct WatchRequest
+{
+  int fd;
+};
+
+struct RemoteEvent
+{
+  int value;
+};
+
+// Non-blocking so handlers can drain the read end
+constexpr int kPipeFlags = O_NONBLOCK | O_CLOEXEC;
+
+struct IngestReceiver
+{
+  using receives = ev_loop::type_list<PipeReadable, TimerExpired, ControlReadable, WatchRequest>;
+  using thread_mode = ev_loop::SameThread;
+
+  int bytes_read = 0;
+  int timer_ticks = 0;
+  int control_count = 0;
+  std::uint32_t last_events = 0;
+
+  template<typename D> void on_event(PipeReadable event, D& /*dispatcher*/)
+  {
+    last_events = event.events;
+    char byte = 0;
+    while (::read(event.fd, &byte, 1) == 1) { ++bytes_read; }
+  }
+
+  template<typename D> void on_event(TimerExpired event, D& /*dispatcher*/)
+  {
+    std::uint64_t expirations = 0;
+    if (::read(event.fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+      timer_ticks += static_cast<int>(expirations);
+    }
+  }
+
+  template<typename D> void on_event(ControlReadable event, D& dispatcher)
+  {
+    ++control_count;
+    char byte = 0;
+    std::ignore = ::read(event.fd, &byte, 1);
+    // Stop listening after the first control message
+    REQUIRE(dispatcher.unwatch_fd(event.fd));
+  }
+
+  template<typename D> void on_event(WatchRequest event, D& dispatcher)
+  {
+    REQUIRE(dispatcher.template watch_fd<ControlReadable>(event.fd));
+  }
+};
+
+struct RemoteReceiver
+{
+  using receives = ev_loop::type_list<RemoteEvent>;
+  using thread_mode = ev_loop::SameThread;
+  int count = 0;
+  template<typename D> void on_event(RemoteEvent /*event*/, D& /*dispatcher*/) { ++count; }
+};
+
+struct RemoteEmitter
+{
+  using emits = ev_loop::type_list<RemoteEvent>;
+};
+
+// Re-emits itself forever, so the loop queue never drains
+struct Churn
+{
+  using receives = ev_loop::type_list<RemoteEvent>;
+  using emits = ev_loop::type_list<RemoteEvent>;
+  using thread_mode = ev_loop::SameThread;
+  int count = 0;
+  template<typename D> void on_event(RemoteEvent event, D& dispatcher)
+  {
+    ++count;
+    dispatcher.emit(RemoteEvent{ event.value + 1 });
+  }
+};
+
+using FdLoop = ev_loop::EventLoop<IngestReceiver, ev_loop::FdSources>;
+
+} // namespace
+
+// =============================================================================
+// Readiness delivery
+// =============================================================================
+
+TEST_CASE("FdSources delivers readiness as typed events", "[fd_sources]")
+{
+  FdLoop loop;
+  loop.start();
+  Pipe pipe{ kPipeFlags };
+  REQUIRE(loop.watch_fd<PipeReadable>(pipe.read_end()));
+
+  SECTION("nothing is delivered while the fd is idle") { REQUIRE_FALSE(ev_loop::Spin{ loop }.poll()); }
+
+  SECTION("Spin picks up readiness without blocking")
+  {
+    REQUIRE(pipe.send('a'));
+    REQUIRE(pipe.send('b'));
+    REQUIRE(ev_loop::Spin{ loop }.poll());
+    REQUIRE(loop.get<IngestReceiver>().bytes_read == 2);
+    REQUIRE((loop.get<IngestReceiver>().last_events & EPOLLIN) != 0U);
+    REQUIRE_FALSE(ev_loop::Spin{ loop }.poll());
+  }
+
+  SECTION("unwatch_fd stops delivery")
+  {
+    REQUIRE(loop.unwatch_fd(pipe.read_end()));
+    REQUIRE(pipe.send('a'));
+    REQUIRE_FALSE(ev_loop::Spin{ loop }.poll());
+    REQUIRE(loop.get<IngestReceiver>().bytes_read == 0);
+  }
+
+  SECTION("watching twice updates the registration")
+  {
+    REQUIRE(loop.watch_fd<PipeReadable>(pipe.read_end(), EPOLLIN | EPOLLET));
+    REQUIRE(pipe.send('a'));
+    REQUIRE(ev_loop::Spin{ loop }.poll());
+    REQUIRE(loop.get<IngestReceiver>().bytes_read == 1);
+  }
+
+  SECTION("watch_fd reports epoll_ctl failures") { REQUIRE_FALSE(loop.watch_fd<PipeReadable>(-1)); }
+
+  loop.stop();
+}
+
+TEST_CASE("FdSources polls fds while the queue never drains", "[fd_sources]")
+{
+  constexpr int kMaxDispatches = 10'000;
+  ev_loop::EventLoop<IngestReceiver, Churn, ev_loop::FdSources> loop;
+  loop.start();
+  Pipe pipe{ kPipeFlags };
+  REQUIRE(loop.watch_fd<PipeReadable>(pipe.read_end()));
+  loop.emit(RemoteEvent{ 0 });
+  REQUIRE(pipe.send('s'));
+
+  ev_loop::Spin{ loop }.run_while([&] {
+    return loop.get<IngestReceiver>().bytes_read == 0 && loop.get<Churn>().count < kMaxDispatches;
+  });
+  REQUIRE(loop.get<IngestReceiver>().bytes_read == 1);
+  REQUIRE(loop.get<Churn>().count < kMaxDispatches);
+
+  loop.stop();
+}
+
+TEST_CASE("FdSources routes each fd to its own event type", "[fd_sources]")
+{
+  FdLoop loop;
+  loop.start();
+  Pipe pipe{ kPipeFlags };
+
+  const int timer = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  REQUIRE(timer >= 0);
+  itimerspec spec{};
+  spec.it_value.tv_nsec = kTimerNanos;
+  REQUIRE(::timerfd_settime(timer, 0, &spec, nullptr) == 0);
+
+  REQUIRE(loop.watch_fd<PipeReadable>(pipe.read_end()));
+  REQUIRE(loop.watch_fd<TimerExpired>(timer));
+  REQUIRE(pipe.send('x'));
+
+  ev_loop::Wait{ loop }.run_while([&] {
+    const auto& receiver = loop.get<IngestReceiver>();
+    return receiver.timer_ticks < 1 || receiver.bytes_read < 1;
+  });
+
+  REQUIRE(loop.get<IngestReceiver>().timer_ticks == 1);
+  REQUIRE(loop.get<IngestReceiver>().bytes_read == 1);
+
+  loop.stop();
+  ::close(timer);
+}
+
+TEST_CASE("Receivers register fds through the dispatcher", "[fd_sources]")
+{
+  FdLoop loop;
+  loop.start();
+  Pipe control{ kPipeFlags };
+
+  loop.emit(WatchRequest{ control.read_end() });
+  REQUIRE(ev_loop::Spin{ loop }.poll());
+
+  REQUIRE(control.send('1'));
+  REQUIRE(ev_loop::Spin{ loop }.poll());
+  REQUIRE(loop.get<IngestReceiver>().control_count == 1);
+
+  // Handler unwatched the fd after the first message
+  REQUIRE(control.send('2'));
+  REQUIRE_FALSE(ev_loop::Spin{ loop }.poll());
+  REQUIRE(loop.get<IngestReceiver>().control_count == 1);
+
+  loop.stop();
+}
+
+// =============================================================================
+// Blocking strategies wait on fds and the remote queue together
+// =============================================================================
+
+TEST_CASE("Wait and Hybrid block in epoll_wait", "[fd_sources][strategies]")
+{
+  ev_loop::SharedEventLoopPtr<IngestReceiver, RemoteReceiver, RemoteEmitter, ev_loop::FdSources> loop;
+  loop.start();
+  auto emitter = loop.get_external_emitter<RemoteEmitter>();
+  Pipe pipe{ kPipeFlags };
+  REQUIRE(loop->watch_fd<PipeReadable>(pipe.read_end()));
+
+  SECTION("Wait wakes for fd readiness from another thread")
+  {
+    std::thread writer([&pipe] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWriterDelayMs));
+      std::ignore = pipe.send('z');
+    });
+    REQUIRE(ev_loop::Wait{ *loop }.poll());
+    REQUIRE(loop.get<IngestReceiver>().bytes_read == 1);
+    writer.join();
+  }
+
+  SECTION("Wait wakes for remote events")
+  {
+    std::thread producer([&emitter] {
+      for (int idx = 0; idx < kEventCount; ++idx) { std::ignore = emitter.emit(RemoteEvent{ idx }); }
+    });
+    ev_loop::Wait{ *loop }.run_while([&] { return loop.get<RemoteReceiver>().count < kEventCount; });
+    REQUIRE(loop.get<RemoteReceiver>().count == kEventCount);
+    producer.join();
+  }
+
+  SECTION("Hybrid handles mixed fd and remote traffic")
+  {
+    constexpr std::size_t kSpinCount = 10;
+    std::thread producer([&emitter, &pipe] {
+      for (int idx = 0; idx < kEventCount; ++idx) {
+        std::ignore = emitter.emit(RemoteEvent{ idx });
+        std::ignore = pipe.send('m');
+      }
+    });
+    ev_loop::Hybrid{ *loop, kSpinCount }.run_while([&] {
+      return loop.get<RemoteReceiver>().count < kEventCount || loop.get<IngestReceiver>().bytes_read < kEventCount;
+    });
+    REQUIRE(loop.get<RemoteReceiver>().count == kEventCount);
+    REQUIRE(loop.get<IngestReceiver>().bytes_read == kEventCount);
+    producer.join();
+  }
+
+  SECTION("stop unblocks epoll_wait")
+  {
+    std::thread stopper([&loop] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWriterDelayMs));
+      loop.stop();
+    });
+    REQUIRE_FALSE(ev_loop::Wait{ *loop }.poll());
+    stopper.join();
+  }
+
+  loop.stop();
+}
+
+TEST_CASE("FdSources native_handle is the pollable epoll fd", "[fd_sources][eventfd]")
+{
+  FdLoop loop;
+  loop.start();
+  Pipe pipe{ kPipeFlags };
+  REQUIRE(loop.watch_fd<PipeReadable>(pipe.read_end()));
+
+  pollfd pfd{ .fd = loop.native_handle(), .events = POLLIN, .revents = 0 };
+  REQUIRE(::poll(&pfd, 1, 0) == 0);
+
+  REQUIRE(pipe.send('q'));
+  REQUIRE(::poll(&pfd, 1, 0) == 1);
+  REQUIRE(loop.poll_ready() == 1U);
+  REQUIRE(loop.get<IngestReceiver>().bytes_read == 1);
+  REQUIRE(::poll(&pfd, 1, 0) == 0);
+
+  loop.stop();
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <ev_loop/ev.hpp>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+
+#include "test_utils.hpp"
+
+#if EV_HAS_EVENTFD
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 10;
+constexpr std::size_t kDepth = ev_loop::detail::FlightBuffer::depth;
+
+struct Ping
+{
+  int value;
+};
+
+struct Pong
+{
+  int value;
+};
+
+struct Recorded
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/) {}
+};
+
+struct Echo
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.value }); }
+};
+
+struct Collector
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++received; }
+};
+
+// Dumps from inside its own handler, so the dump shows it as running
+struct SelfDumper
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  std::function<bool()> dump;
+  bool dumped = false;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { dumped = dump(); }
+};
+
+// Large enough for a full dump without a reader
+constexpr int kPipeSize = 1 << 20;
+
+} // namespace
+
+// =============================================================================
+// On-demand dumps
+// =============================================================================
+
+TEST_CASE("Flight recorder dumps the last dispatches of each thread", "[flight_recorder]")
+{
+  ev_loop::EventLoop<Echo, Collector, ev_loop::FlightRecorder> loop;
+  loop.start();
+  for (int idx = 0; idx < kEvents; ++idx) { loop.emit(Ping{ idx }); }
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received < kEvents; });
+
+  Pipe pipe{ O_CLOEXEC, kPipeSize };
+  REQUIRE(loop.dump_flight_recorder(pipe.write_end()));
+  loop.stop();
+  const std::string text = pipe.read_all();
+
+  REQUIRE(text.starts_with("=== ev_loop flight recorder ===\n"));
+  REQUIRE(count(text, "Echo <- ") >= kEvents);
+  REQUIRE(count(text, "Collector <- ") >= kEvents);
+  REQUIRE(text.find(" ns ago  ") != std::string::npos);
+  // The OwnThread track is named after its receiver
+  REQUIRE(text.find("Echo: ") != std::string::npos);
+}
+
+TEST_CASE("Flight recorder keeps only the most recent dispatches", "[flight_recorder]")
+{
+  ev_loop::EventLoop<Recorded, ev_loop::FlightRecorder> loop;
+  loop.start();
+  // Runs on a fresh thread so this buffer holds Recorded dispatches only
+  Pipe pipe{ O_CLOEXEC, kPipeSize };
+  bool dumped = false;
+  std::thread worker([&] {
+    for (std::size_t idx = 0; idx < 3 * kDepth; ++idx) {
+      loop.emit(Ping{ static_cast<int>(idx) });
+      drain(loop);
+    }
+    dumped = loop.dump_flight_recorder(pipe.write_end());
+  });
+  worker.join();
+  loop.stop();
+  const std::string text = pipe.read_all();
+
+  REQUIRE(dumped);
+  REQUIRE(text.find(": " + std::to_string(3 * kDepth) + " dispatches\n") != std::string::npos);
+  REQUIRE(count(text, "Recorded <- ") == kDepth);
+}
+
+TEST_CASE("Flight recorder marks the dispatch that is still running", "[flight_recorder]")
+{
+  ev_loop::EventLoop<Echo, SelfDumper, ev_loop::FlightRecorder> loop;
+  Pipe pipe{ O_CLOEXEC, kPipeSize };
+  loop.get<SelfDumper>().dump = [&] { return loop.dump_flight_recorder(pipe.write_end()); };
+  loop.start();
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return !loop.get<SelfDumper>().dumped; });
+  loop.stop();
+  const std::string text = pipe.read_all();
+
+  REQUIRE(text.find("SelfDumper <- ") != std::string::npos);
+  REQUIRE(count(text, "  [running]\n") >= 1);
+}
+
+// =============================================================================
+// Crash dumps
+// =============================================================================
+
+TEST_CASE("Flight recorder dumps to stderr on SIGABRT", "[flight_recorder]")
+{
+  Pipe pipe{ O_CLOEXEC, kPipeSize };
+  const pid_t child = ::fork();
+  REQUIRE(child >= 0);
+  if (child == 0) {
+    ::dup2(pipe.write_end(), STDERR_FILENO);
+    ev_loop::EventLoop<Recorded, ev_loop::FlightRecorder> loop;
+    loop.start();
+    loop.emit(Ping{ 1 });
+    drain(loop);
+    std::abort();
+  }
+  const std::string text = pipe.read_all();
+  int status = 0;
+  REQUIRE(::waitpid(child, &status, 0) == child);
+  REQUIRE(WIFSIGNALED(status));
+  REQUIRE(WTERMSIG(status) == SIGABRT);
+
+  REQUIRE(text.find("=== ev_loop flight recorder ===\n") != std::string::npos);
+  REQUIRE(text.find("Recorded <- ") != std::string::npos);
+}
+
+TEST_CASE("Flight recorder forwards to a previous SA_SIGINFO handler", "[flight_recorder]")
+{
+  constexpr int kChainedExit = 3;
+  Pipe pipe{ O_CLOEXEC, kPipeSize };
+  const pid_t child = ::fork();
+  REQUIRE(child >= 0);
+  if (child == 0) {
+    ::dup2(pipe.write_end(), STDERR_FILENO);
+    struct sigaction chained{};
+    chained.sa_sigaction = [](int signo, siginfo_t* info, void* /*context*/) {
+      constexpr std::string_view marker = "chained handler saw siginfo\n";
+      if (info != nullptr && info->si_signo == signo) {
+        std::ignore = ::write(STDERR_FILENO, marker.data(), marker.size());
+      }
+      ::_exit(kChainedExit);
+    };
+    sigemptyset(&chained.sa_mask);
+    chained.sa_flags = SA_SIGINFO;
+    ::sigaction(SIGABRT, &chained, nullptr);
+
+    ev_loop::EventLoop<Recorded, ev_loop::FlightRecorder> loop;
+    loop.start();
+    loop.emit(Ping{ 1 });
+    drain(loop);
+    std::abort();
+  }
+  const std::string text = pipe.read_all();
+  int status = 0;
+  REQUIRE(::waitpid(child, &status, 0) == child);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == kChainedExit);
+
+  const auto dump = text.find("=== ev_loop flight recorder ===\n");
+  REQUIRE(dump != std::string::npos);
+  REQUIRE(text.find("chained handler saw siginfo\n") > dump);
+  REQUIRE(text.find("chained handler saw siginfo\n") != std::string::npos);
+}
+
+#endif
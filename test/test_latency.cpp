@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ev_loop/ev.hpp>
+#include <thread>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 100;
+constexpr auto kDelay = test_receivers::SlowSink::default_delay;
+
+using test_receivers::Ping;
+using test_receivers::Sink;
+using test_receivers::SlowSink;
+using test_receivers::Echo;
+using test_receivers::Collector;
+
+} // namespace
+
+// =============================================================================
+// Histogram
+// =============================================================================
+
+TEST_CASE("LatencyHistogram buckets are exact below 32 ticks and within 1/16 above", "[latency]")
+{
+  using ev_loop::LatencyHistogram;
+  for (std::uint64_t ticks = 0; ticks < 32; ++ticks) {
+    REQUIRE(LatencyHistogram::bucket_of(ticks) == ticks);
+    REQUIRE(LatencyHistogram::bucket_upper(ticks) == ticks);
+  }
+  for (const std::uint64_t ticks : { 32ULL, 33ULL, 1000ULL, 123'456'789ULL, (1ULL << 40) + 12345 }) {
+    const auto upper = LatencyHistogram::bucket_upper(LatencyHistogram::bucket_of(ticks));
+    REQUIRE(upper >= ticks);
+    REQUIRE(upper - ticks <= ticks / 16);
+  }
+  REQUIRE(LatencyHistogram::bucket_of(~std::uint64_t{ 0 }) == LatencyHistogram::bucket_count - 1);
+}
+
+TEST_CASE("LatencyHistogram reports percentiles and merges", "[latency]")
+{
+  ev_loop::LatencyHistogram low;
+  ev_loop::LatencyHistogram high;
+  REQUIRE(low.percentile(0.5).count() == 0);
+
+  for (std::uint64_t ticks = 1; ticks <= 10; ++ticks) { low.record(ticks); }
+  for (int idx = 0; idx < 10; ++idx) { high.record(1'000'000); }
+  REQUIRE(low.count() == 10);
+  REQUIRE(low.percentile(0.5) <= low.max());
+
+  low.merge(high);
+  REQUIRE(low.count() == 20);
+  REQUIRE(low.percentile(0.25) < low.percentile(0.75));
+  REQUIRE(low.max() == high.max());
+}
+
+// =============================================================================
+// Loop integration
+// =============================================================================
+
+TEST_CASE("DispatchLatency measures time spent in the queue", "[latency]")
+{
+  ev_loop::EventLoop<Sink, ev_loop::DispatchLatency> loop;
+  loop.start();
+  loop.emit(Ping{ 1 });
+  std::this_thread::sleep_for(kDelay);
+  drain(loop);
+  loop.stop();
+
+  const auto sink = loop.latency().snapshot<Sink>();
+  REQUIRE(sink.queue_wait.count() == 1);
+  REQUIRE(sink.handler.count() == 1);
+  // Bucket upper bounds never under-report, so the sleep is a hard lower bound
+  REQUIRE(sink.queue_wait.max() >= kDelay);
+  REQUIRE(sink.handler.max() < kDelay);
+}
+
+TEST_CASE("DispatchLatency measures time spent in the handler", "[latency]")
+{
+  ev_loop::EventLoop<Sink, SlowSink, ev_loop::DispatchLatency> loop;
+  loop.start();
+  loop.emit(Ping{ 1 });
+  drain(loop);
+  loop.stop();
+
+  const auto slow = loop.latency().snapshot<SlowSink>();
+  REQUIRE(slow.handler.count() == 1);
+  REQUIRE(slow.handler.max() >= kDelay);
+  REQUIRE(loop.latency().snapshot<Sink>().handler.count() == 1);
+
+  const auto total = loop.latency().merged();
+  REQUIRE(total.handler.count() == 2);
+  REQUIRE(total.queue_wait.count() == 2);
+}
+
+TEST_CASE("DispatchLatency covers OwnThread receivers and the remote queue", "[latency]")
+{
+  using Loop = ev_loop::EventLoop<Echo, Collector, ev_loop::DispatchLatency>;
+  Loop loop;
+  loop.start();
+  for (int idx = 0; idx < kEvents; ++idx) { loop.emit(Ping{ idx }); }
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received < kEvents; });
+  loop.stop();
+
+  REQUIRE(loop.latency().snapshot<Echo>().handler.count() == kEvents);
+  REQUIRE(loop.latency().snapshot<Echo>().queue_wait.count() == kEvents);
+  REQUIRE(loop.latency().snapshot<Collector>().queue_wait.count() == kEvents);
+}
+
+TEST_CASE("DispatchLatency combines with Metrics", "[latency]")
+{
+  using Loop = ev_loop::EventLoop<Echo, Collector, ev_loop::Metrics, ev_loop::DispatchLatency>;
+  Loop loop;
+  loop.start();
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+  loop.stop();
+
+  REQUIRE(loop.latency().snapshot<Collector>().handler.count() == 1);
+  const auto snapshot = loop.metrics().snapshot();
+  const auto* remote = snapshot.queue("remote");
+  REQUIRE(remote != nullptr);
+  REQUIRE(remote->dequeued == 1);
+}
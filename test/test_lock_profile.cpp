@@ -0,0 +1,167 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <ev_loop/ev.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 10;
+constexpr auto kHold = std::chrono::milliseconds{ 5 };
+
+using test_receivers::Ping;
+using test_receivers::Pong;
+using test_receivers::Sink;
+using test_receivers::Collector;
+
+// Two external emitters of Ping make Worker's inbox an MPSC queue
+struct FeedA
+{
+  using emits = ev_loop::type_list<Ping>;
+};
+
+struct FeedB
+{
+  using emits = ev_loop::type_list<Ping>;
+};
+
+struct Worker
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.value }); }
+};
+
+} // namespace
+
+// =============================================================================
+// Attribution
+// =============================================================================
+
+TEST_CASE("LockProfile counts acquisitions of the loop queue per thread", "[lock_profile]")
+{
+  ev_loop::SharedEventLoopPtr<Sink, FeedA, ev_loop::LockProfile> loop;
+  loop.start();
+  auto feed = loop.get_external_emitter<FeedA>();
+  for (int idx = 0; idx < kEvents; ++idx) { REQUIRE(feed.emit(Ping{ idx })); }
+  ev_loop::Spin{ *loop }.run_while([&] { return loop.get<Sink>().received < kEvents; });
+  loop.stop();
+
+  const auto snapshot = loop->lock_snapshot();
+  const auto* pushes = snapshot.find("loop", ev_loop::detail::type_name<FeedA>());
+  REQUIRE(pushes != nullptr);
+  REQUIRE(pushes->acquisitions == kEvents);
+  REQUIRE(pushes->contended == 0);
+  REQUIRE(pushes->wait.count() == 0);
+  REQUIRE(pushes->max_hold <= pushes->hold);
+
+  // The same thread drained the queue as the loop
+  const auto* drains = snapshot.find("loop", "loop");
+  REQUIRE(drains != nullptr);
+  REQUIRE(drains->acquisitions >= 1);
+  REQUIRE(drains->thread_id == pushes->thread_id);
+  REQUIRE(snapshot.queue_total("loop").acquisitions == pushes->acquisitions + drains->acquisitions);
+
+  const std::string table = snapshot.table();
+  REQUIRE(table.find("loop <- loop #") != std::string::npos);
+  REQUIRE(table.find("FeedA #") != std::string::npos);
+}
+
+TEST_CASE("LockProfile covers MPSC OwnThread inboxes", "[lock_profile]")
+{
+  ev_loop::SharedEventLoopPtr<Worker, Collector, FeedA, FeedB, ev_loop::LockProfile> loop;
+  loop.start();
+  auto feed_a = loop.get_external_emitter<FeedA>();
+  auto feed_b = loop.get_external_emitter<FeedB>();
+  std::thread other([&] {
+    for (int idx = 0; idx < kEvents; ++idx) { feed_b.emit(Ping{ idx }); }
+  });
+  for (int idx = 0; idx < kEvents; ++idx) { feed_a.emit(Ping{ idx }); }
+  other.join();
+  ev_loop::Spin{ *loop }.run_while([&] { return loop.get<Collector>().received < 2 * kEvents; });
+  loop.stop();
+
+  const auto snapshot = loop->lock_snapshot();
+  const std::string_view worker = ev_loop::detail::type_name<Worker>();
+  const auto* from_a = snapshot.find(worker, ev_loop::detail::type_name<FeedA>());
+  const auto* from_b = snapshot.find(worker, ev_loop::detail::type_name<FeedB>());
+  REQUIRE(from_a != nullptr);
+  REQUIRE(from_b != nullptr);
+  REQUIRE(from_a->acquisitions == kEvents);
+  REQUIRE(from_b->acquisitions == kEvents);
+  REQUIRE(from_a->thread_id != from_b->thread_id);
+  REQUIRE(snapshot.find(worker, worker) != nullptr);
+
+  // Worker's replies go through the remote side of the loop queue
+  const auto* replies = snapshot.find("loop", worker);
+  REQUIRE(replies != nullptr);
+  REQUIRE(replies->acquisitions == 2 * kEvents);
+}
+
+TEST_CASE("LockProfile sees one acquisition per push into an observed inbox", "[lock_profile]")
+{
+  ev_loop::SharedEventLoopPtr<Worker, Collector, FeedA, FeedB, ev_loop::Metrics, ev_loop::LockProfile> loop;
+  loop.start();
+  auto feed = loop.get_external_emitter<FeedA>();
+  for (int idx = 0; idx < kEvents; ++idx) { feed.emit(Ping{ idx }); }
+  ev_loop::Spin{ *loop }.run_while([&] { return loop.get<Collector>().received < kEvents; });
+  loop.stop();
+
+  // The enqueue hook gets its depth from the push, not from a second locked size()
+  const auto locks = loop->lock_snapshot();
+  const auto* pushes = locks.find(ev_loop::detail::type_name<Worker>(), ev_loop::detail::type_name<FeedA>());
+  REQUIRE(pushes != nullptr);
+  REQUIRE(pushes->acquisitions == kEvents);
+  const auto metrics = loop->metrics().snapshot();
+  const auto* inbox = metrics.queue(ev_loop::detail::type_name<Worker>());
+  REQUIRE(inbox != nullptr);
+  REQUIRE(inbox->enqueued == kEvents);
+  REQUIRE(inbox->high_water >= 1);
+}
+
+// =============================================================================
+// Contention
+// =============================================================================
+
+TEST_CASE("ProfiledMutex records blocked acquisitions and hold time", "[lock_profile]")
+{
+  ev_loop::detail::ProfiledMutex mutex;
+  std::atomic<bool> waiting{ false };
+  mutex.lock();
+  std::thread other([&] {
+    const ev_loop::detail::LockThreadScope scope{ "other" };
+    waiting.store(true);
+    mutex.lock();
+    mutex.unlock();
+  });
+  while (!waiting.load()) { std::this_thread::yield(); }
+  std::this_thread::sleep_for(kHold);
+  mutex.unlock();
+  other.join();
+
+  std::vector<ev_loop::LockSnapshot::Entry> entries;
+  mutex.collect("queue", entries);
+  REQUIRE(entries.size() == 2);
+  const ev_loop::LockSnapshot snapshot{ entries };
+  const auto* holder = snapshot.find("queue", "loop");
+  const auto* blocked = snapshot.find("queue", "other");
+  REQUIRE(holder != nullptr);
+  REQUIRE(blocked != nullptr);
+  REQUIRE(holder->contended == 0);
+  REQUIRE(holder->hold >= kHold);
+  REQUIRE(blocked->acquisitions == 1);
+  REQUIRE(blocked->contended == 1);
+  REQUIRE(blocked->contention() == 1.0);
+  REQUIRE(blocked->wait > std::chrono::nanoseconds{ 0 });
+  REQUIRE(blocked->max_wait == blocked->wait);
+}
@@ -0,0 +1,307 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <ev_loop/ev.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 100;
+constexpr int kOverflow = 10;
+constexpr int kLocalCapacity = 4096;
+constexpr auto kIdle = std::chrono::milliseconds{ 20 };
+
+struct Start
+{
+  int value;
+};
+
+struct Ping
+{
+  int value;
+};
+
+struct Pong
+{
+  int value;
+};
+
+struct Relay
+{
+  using receives = ev_loop::type_list<Start>;
+  using emits = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  template<typename D> void on_event(Start start, D& dispatcher) { dispatcher.emit(Ping{ start.value }); }
+};
+
+struct Sink
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/) { ++received; }
+};
+
+struct Echo
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.value }); }
+};
+
+struct Collector
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++received; }
+};
+
+struct ParkCounter : ev_loop::NullObserver
+{
+  std::atomic<int> parks{ 0 };
+  void on_park() noexcept { parks.fetch_add(1, std::memory_order_relaxed); }
+};
+
+using PipelineLoop = ev_loop::EventLoop<Relay, Sink, Echo, Collector, ev_loop::Metrics>;
+
+std::uint64_t dispatched(const ev_loop::MetricsSnapshot& snapshot, std::string_view receiver, std::string_view event)
+{
+  for (const auto& entry : snapshot.dispatched) {
+    if (entry.receiver.ends_with(receiver) && entry.event.ends_with(event)) { return entry.count; }
+  }
+  return 0;
+}
+
+// OwnThread inboxes are named after the receiver type, which carries its namespace
+const ev_loop::MetricsSnapshot::Queue* inbox(const ev_loop::MetricsSnapshot& snapshot, std::string_view receiver)
+{
+  for (const auto& entry : snapshot.queues) {
+    if (entry.name.ends_with(receiver)) { return &entry; }
+  }
+  return nullptr;
+}
+
+// Emits kEvents Starts and runs until every Pong came back
+template<typename Loop, typename Strategy> void run_pipeline(Loop& loop)
+{
+  for (int idx = 0; idx < kEvents; ++idx) { loop.emit(Start{ idx }); }
+  Strategy{ loop }.run_while([&] { return loop.template get<Collector>().received < kEvents; });
+}
+
+} // namespace
+
+// =============================================================================
+// Counters
+// =============================================================================
+
+TEST_CASE("Metrics count dispatches per receiver and event type", "[metrics]")
+{
+  PipelineLoop loop;
+  loop.start();
+  run_pipeline<PipelineLoop, ev_loop::Spin<PipelineLoop>>(loop);
+  loop.stop();
+
+  const auto snapshot = loop.metrics().snapshot();
+  REQUIRE(dispatched(snapshot, "Relay", "Start") == kEvents);
+  REQUIRE(dispatched(snapshot, "Sink", "Ping") == kEvents);
+  REQUIRE(dispatched(snapshot, "Echo", "Ping") == kEvents);
+  REQUIRE(dispatched(snapshot, "Collector", "Pong") == kEvents);
+}
+
+TEST_CASE("Metrics track every queue the events pass through", "[metrics]")
+{
+  PipelineLoop loop;
+  loop.start();
+  run_pipeline<PipelineLoop, ev_loop::Spin<PipelineLoop>>(loop);
+  loop.stop();
+
+  const auto snapshot = loop.metrics().snapshot();
+  REQUIRE(snapshot.queues.size() == 3);
+
+  const auto* remote = snapshot.queue("remote");
+ REQUIRE(remote != nullptr);
+  REQUIRE(remote != nullptr);
+  REQUIRE(remote->enqueued == kEvents);
+  REQUIRE(remote->dequeued == kEvents);
+  REQUIRE(remote->depth == 0);
+
+  // Starts and Pings from the test thread, Pongs drained from the remote side
+  const auto* local = snapshot.queue("local");
+  REQUIRE(local != nullptr);
+  REQUIRE(local->enqueued == 3 * kEvents);
+  REQUIRE(local->dequeued == 3 * kEvents);
+  REQUIRE(local->depth == 0);
+
+  const auto* echo = inbox(snapshot, "Echo");
+  REQUIRE(echo != nullptr);
+  REQUIRE(echo->enqueued == kEvents);
+  REQUIRE(echo->dequeued == kEvents);
+  REQUIRE(echo->dropped == 0);
+}
+
+TEST_CASE("Metrics report depth, high-water mark and drops", "[metrics]")
+{
+  ev_loop::EventLoop<Sink, ev_loop::Metrics> loop;
+  loop.start();
+
+  SECTION("depth and high-water mark")
+  {
+    for (int idx = 0; idx < kEvents; ++idx) { loop.emit(Ping{ idx }); }
+    const auto queued_snapshot = loop.metrics().snapshot();
+    const auto* queued = queued_snapshot.queue("local");
+    REQUIRE(queued != nullptr);
+    REQUIRE(queued->depth == kEvents);
+    REQUIRE(queued->high_water == kEvents);
+
+    drain(loop);
+    const auto drained_snapshot = loop.metrics().snapshot();
+    const auto* drained = drained_snapshot.queue("local");
+    REQUIRE(drained != nullptr);
+    REQUIRE(drained->depth == 0);
+    REQUIRE(drained->high_water == kEvents);
+  }
+
+  SECTION("drops")
+  {
+    for (int idx = 0; idx < kLocalCapacity + kOverflow; ++idx) { loop.emit(Ping{ idx }); }
+    drain(loop);
+    const auto snapshot = loop.metrics().snapshot();
+    const auto* local = snapshot.queue("local");
+    REQUIRE(local != nullptr);
+    REQUIRE(local->dropped == kOverflow);
+    REQUIRE(local->dequeued == kLocalCapacity);
+    REQUIRE(local->depth == 0);
+  }
+
+  loop.stop();
+}
+
+TEST_CASE("Metrics separate wakeups from spins", "[metrics]")
+{
+  PipelineLoop loop;
+  loop.start();
+
+  SECTION("Spin never blocks the loop thread")
+  {
+    run_pipeline<PipelineLoop, ev_loop::Spin<PipelineLoop>>(loop);
+    const auto snapshot = loop.metrics().snapshot();
+    const auto* local = snapshot.queue("local");
+    REQUIRE(local != nullptr);
+    REQUIRE(local->wakeups == 0);
+    REQUIRE(local->spins == local->dequeued);
+  }
+
+  SECTION("an idle OwnThread receiver wakes up for its next event")
+  {
+    std::this_thread::sleep_for(kIdle);
+    loop.emit(Ping{ 1 });
+    ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+    const auto snapshot = loop.metrics().snapshot();
+    const auto* echo = inbox(snapshot, "Echo");
+    REQUIRE(echo != nullptr);
+    REQUIRE(echo->wakeups == 1);
+  }
+
+  SECTION("Wait wakes up for replies")
+  {
+    run_pipeline<PipelineLoop, ev_loop::Wait<PipelineLoop>>(loop);
+    const auto snapshot = loop.metrics().snapshot();
+    const auto* local = snapshot.queue("local");
+    REQUIRE(local != nullptr);
+    REQUIRE(local->wakeups + local->spins == local->dequeued);
+  }
+
+  loop.stop();
+}
+
+TEST_CASE("Metrics snapshots are safe while the loop runs", "[metrics]")
+{
+  PipelineLoop loop;
+  loop.start();
+  std::atomic<bool> done{ false };
+  std::uint64_t last = 0;
+  bool monotonic = true;
+  std::thread monitor([&] {
+    while (!done.load(std::memory_order_acquire)) {
+      const auto count = dispatched(loop.metrics().snapshot(), "Collector", "Pong");
+      monotonic = monotonic && count >= last;
+      last = count;
+    }
+  });
+  run_pipeline<PipelineLoop, ev_loop::Spin<PipelineLoop>>(loop);
+  done.store(true, std::memory_order_release);
+  monitor.join();
+  loop.stop();
+
+  REQUIRE(monotonic);
+  REQUIRE(dispatched(loop.metrics().snapshot(), "Collector", "Pong") == kEvents);
+}
+
+TEST_CASE("Metrics combine with an Observe policy", "[metrics]")
+{
+  using Loop = ev_loop::EventLoop<Echo, Collector, ev_loop::Metrics, ev_loop::Observe<ParkCounter>>;
+  Loop loop;
+  loop.start();
+  std::this_thread::sleep_for(kIdle);
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+  loop.stop();
+
+  REQUIRE(loop.observer().parks.load() >= 1);
+  REQUIRE(dispatched(loop.metrics().snapshot(), "Collector", "Pong") == 1);
+}
+
+// =============================================================================
+// OpenMetrics
+// =============================================================================
+
+TEST_CASE("Metrics render as OpenMetrics text", "[metrics]")
+{
+  PipelineLoop loop;
+  loop.start();
+  run_pipeline<PipelineLoop, ev_loop::Spin<PipelineLoop>>(loop);
+  loop.stop();
+
+  const std::string text = loop.metrics().snapshot().openmetrics();
+  REQUIRE(text.starts_with("# TYPE ev_loop_dispatched counter\n"));
+  REQUIRE(text.ends_with("# EOF\n"));
+  REQUIRE(text.find("# TYPE ev_loop_queue_high_water gauge\n") != std::string::npos);
+  REQUIRE(text.find("ev_loop_enqueued_total{queue=\"remote\"} 100\n") != std::string::npos);
+  REQUIRE(text.find("ev_loop_queue_depth{queue=\"local\"} 0\n") != std::string::npos);
+
+  SECTION("dump to a file")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "ev_loop_test_metrics.txt";
+    REQUIRE(loop.metrics().write_openmetrics(path.c_str()));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    REQUIRE(contents.str() == loop.metrics().snapshot().openmetrics());
+    std::filesystem::remove(path);
+  }
+
+  SECTION("unwritable path")
+  {
+    REQUIRE_FALSE(loop.metrics().write_openmetrics("/nonexistent-directory/metrics.txt"));
+  }
+}
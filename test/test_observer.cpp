@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <ev_loop/ev.hpp>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kRoundTrips = 50;
+constexpr int kOverflow = 10;
+constexpr int kLocalCapacity = 4096;
+constexpr auto kIdle = std::chrono::milliseconds{ 20 };
+
+struct Start
+{
+  int value;
+};
+
+struct Ping
+{
+  int value;
+};
+
+struct Pong
+{
+  int value;
+};
+
+// Forwards Start as Ping on the loop thread
+struct Relay
+{
+  using receives = ev_loop::type_list<Start>;
+  using emits = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  template<typename D> void on_event(Start start, D& dispatcher) { dispatcher.emit(Ping{ start.value }); }
+};
+
+template<typename Tag> struct Sink
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/) { ++received; }
+};
+
+using SinkA = Sink<struct ATag>;
+using SinkB = Sink<struct BTag>;
+
+// Answers Ping with Pong from its own thread
+struct Echo
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.value }); }
+};
+
+struct Collector
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++received; }
+};
+
+template<typename T> constexpr std::string_view kName = "?";
+template<> constexpr std::string_view kName<void> = "loop";
+template<> constexpr std::string_view kName<Start> = "Start";
+template<> constexpr std::string_view kName<Ping> = "Ping";
+template<> constexpr std::string_view kName<Pong> = "Pong";
+template<> constexpr std::string_view kName<Relay> = "Relay";
+template<> constexpr std::string_view kName<SinkA> = "SinkA";
+template<> constexpr std::string_view kName<SinkB> = "SinkB";
+template<> constexpr std::string_view kName<Echo> = "Echo";
+template<> constexpr std::string_view kName<Collector> = "Collector";
+
+constexpr std::string_view kind_name(ev_loop::QueueKind kind)
+{
+  switch (kind) {
+  case ev_loop::QueueKind::local:
+    return "local";
+  case ev_loop::QueueKind::remote:
+    return "remote";
+  case ev_loop::QueueKind::own_thread:
+    return "own_thread";
+  }
+  return "?";
+}
+
+// Records every hook as "hook kind owner event" - hooks arrive from several threads
+struct Recorder : ev_loop::NullObserver
+{
+  std::mutex mutex;
+  std::vector<std::string> log;
+  std::atomic<int> drops{ 0 };
+  std::atomic<int> parks{ 0 };
+  std::atomic<int> unparks{ 0 };
+
+  template<typename Owner, typename Event> void on_enqueue(ev_loop::QueueKind kind, std::size_t /*depth*/) noexcept
+  {
+    record("enqueue", kind_name(kind), kName<Owner>, kName<Event>);
+  }
+
+  template<typename Owner, typename Event> void on_dequeue(ev_loop::QueueKind kind) noexcept
+  {
+    record("dequeue", kind_name(kind), kName<Owner>, kName<Event>);
+  }
+
+  template<typename Owner, typename Event> void on_drop(ev_loop::QueueKind /*kind*/) noexcept
+  {
+    drops.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  template<typename Receiver, typename Event> void on_dispatch_begin() noexcept
+  {
+    record("begin", "", kName<Receiver>, kName<Event>);
+  }
+
+  template<typename Receiver, typename Event> void on_dispatch_end() noexcept
+  {
+    record("end", "", kName<Receiver>, kName<Event>);
+  }
+
+  void on_park() noexcept { parks.fetch_add(1, std::memory_order_relaxed); }
+  void on_unpark() noexcept { unparks.fetch_add(1, std::memory_order_relaxed); }
+
+  [[nodiscard]] int count(std::string_view entry)
+  {
+    const std::scoped_lock lock(mutex);
+    return static_cast<int>(std::ranges::count(log, entry));
+  }
+
+  void record(std::string_view hook, std::string_view kind, std::string_view owner, std::string_view event) noexcept
+  {
+    std::string entry{ hook };
+    for (const auto part : { kind, owner, event }) {
+      if (part.empty()) { continue; }
+      entry += ' ';
+      entry += part;
+    }
+    const std::scoped_lock lock(mutex);
+    log.push_back(std::move(entry));
+  }
+};
+
+using ev_loop::Observe;
+
+template<typename Loop, typename Strategy> void run_echo()
+{
+  Loop loop;
+  loop.start();
+  auto& collector = loop.template get<Collector>();
+  for (int idx = 0; idx < kRoundTrips; ++idx) {
+    loop.emit(Ping{ idx });
+    Strategy{ loop }.run_while([&] { return collector.received <= idx; });
+  }
+  loop.stop();
+
+  auto& recorder = loop.observer();
+  REQUIRE(recorder.count("enqueue own_thread Echo Ping") == kRoundTrips);
+  REQUIRE(recorder.count("dequeue own_thread Echo Ping") == kRoundTrips);
+  REQUIRE(recorder.count("begin Echo Ping") == kRoundTrips);
+  REQUIRE(recorder.count("end Echo Ping") == kRoundTrips);
+  REQUIRE(recorder.count("enqueue remote loop Pong") == kRoundTrips);
+  REQUIRE(recorder.count("begin Collector Pong") == kRoundTrips);
+  REQUIRE(recorder.parks.load() == recorder.unparks.load());
+}
+
+} // namespace
+
+// =============================================================================
+// Queue and dispatch hooks
+// =============================================================================
+
+TEST_CASE("Observer sees local enqueue, dequeue and dispatch in order", "[observer]")
+{
+  ev_loop::EventLoop<Relay, SinkA, Observe<Recorder>> loop;
+  loop.start();
+  loop.emit(Start{ 1 });
+  drain(loop);
+  loop.stop();
+
+  REQUIRE(loop.get<SinkA>().received == 1);
+  REQUIRE(loop.observer().log
+          == std::vector<std::string>{ "enqueue local loop Start",
+            "dequeue local loop Start",
+            "begin Relay Start",
+            "enqueue local loop Ping",
+            "end Relay Start",
+            "dequeue local loop Ping",
+            "begin SinkA Ping",
+            "end SinkA Ping" });
+}
+
+TEST_CASE("Observer brackets each receiver of a fanout", "[observer]")
+{
+  ev_loop::EventLoop<SinkA, SinkB, Observe<Recorder>> loop;
+  loop.start();
+  loop.emit(Ping{ 1 });
+  drain(loop);
+  loop.stop();
+
+  REQUIRE(loop.observer().log
+          == std::vector<std::string>{ "enqueue local loop Ping",
+            "dequeue local loop Ping",
+            "begin SinkA Ping",
+            "end SinkA Ping",
+            "begin SinkB Ping",
+            "end SinkB Ping" });
+}
+
+TEST_CASE("Observer sees OwnThread inboxes and the remote queue", "[observer]")
+{
+  using Loop = ev_loop::EventLoop<Echo, Collector, Observe<Recorder>>;
+  SECTION("Spin") { run_echo<Loop, ev_loop::Spin<Loop>>(); }
+  SECTION("Hybrid") { run_echo<Loop, ev_loop::Hybrid<Loop>>(); }
+}
+
+TEST_CASE("Observer counts events dropped by a full local queue", "[observer]")
+{
+  ev_loop::EventLoop<SinkA, Observe<Recorder>> loop;
+  loop.start();
+  for (int idx = 0; idx < kLocalCapacity + kOverflow; ++idx) { loop.emit(Ping{ idx }); }
+  drain(loop);
+  loop.stop();
+
+  REQUIRE(loop.get<SinkA>().received == kLocalCapacity);
+  REQUIRE(loop.observer().drops.load() == kOverflow);
+}
+
+// =============================================================================
+// Park / unpark
+// =============================================================================
+
+TEST_CASE("Observer sees Wait park and unpark", "[observer]")
+{
+  SECTION("condition variable")
+  {
+    using Loop = ev_loop::EventLoop<Echo, Collector, Observe<Recorder>>;
+    run_echo<Loop, ev_loop::Wait<Loop>>();
+  }
+
+#if EV_HAS_EVENTFD
+  SECTION("EventFdWakeup")
+  {
+    using Loop = ev_loop::EventLoop<Echo, Collector, ev_loop::EventFdWakeup, Observe<Recorder>>;
+    run_echo<Loop, ev_loop::Wait<Loop>>();
+  }
+
+  SECTION("FdSources")
+  {
+    using Loop = ev_loop::EventLoop<Echo, Collector, ev_loop::FdSources, Observe<Recorder>>;
+    run_echo<Loop, ev_loop::Wait<Loop>>();
+  }
+#endif
+}
+
+TEST_CASE("Observer sees OwnThread receivers park in their inbox", "[observer]")
+{
+  using Loop = ev_loop::EventLoop<Echo, Collector, Observe<Recorder>>;
+  Loop loop;
+  loop.start();
+  // Give Echo time to finish its spin phase and block
+  std::this_thread::sleep_for(kIdle);
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+  loop.stop();
+
+  // Spin never parks the loop thread, so every park came from Echo
+  REQUIRE(loop.observer().parks.load() >= 1);
+  REQUIRE(loop.observer().parks.load() == loop.observer().unparks.load());
+}
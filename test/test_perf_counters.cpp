@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <ev_loop/ev.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 1000;
+
+struct Ping
+{
+  int value;
+};
+
+struct Pong
+{
+  int value;
+};
+
+struct Echo
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.value }); }
+};
+
+struct Collector
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++received; }
+};
+
+template<typename Loop> void round_trips(Loop& loop, int count)
+{
+  for (int idx = 0; idx < count; ++idx) {
+    loop.emit(Ping{ idx });
+    ev_loop::Spin{ loop }.run_while([&] { return loop.template get<Collector>().received <= idx; });
+  }
+}
+
+// Counters are either unavailable (no permission, no PMU) or counted some user-space work
+void require_plausible(const ev_loop::PerfCounterSnapshot::Thread& thread)
+{
+  if (thread.instructions) { REQUIRE(*thread.instructions > 0); }
+  if (thread.cycles) { REQUIRE(*thread.cycles > 0); }
+  if (!thread.available()) {
+    REQUIRE_FALSE(thread.ipc().has_value());
+    REQUIRE_FALSE(thread.llc_misses.has_value());
+    REQUIRE_FALSE(thread.branch_misses.has_value());
+  }
+}
+
+} // namespace
+
+// =============================================================================
+// Per-thread counters
+// =============================================================================
+
+TEST_CASE("PerfCounters reports the loop thread and each OwnThread receiver", "[perf_counters]")
+{
+  ev_loop::EventLoop<Echo, Collector, ev_loop::PerfCounters> loop;
+  loop.start();
+  round_trips(loop, kEvents);
+
+  const auto snapshot = loop.perf_counters().snapshot();
+  const auto* thread = snapshot.thread("loop");
+  const auto* echo = snapshot.thread(ev_loop::detail::type_name<Echo>());
+  REQUIRE(thread != nullptr);
+  REQUIRE(echo != nullptr);
+  require_plausible(*thread);
+  require_plausible(*echo);
+  loop.stop();
+  REQUIRE(loop.get<Collector>().received == kEvents);
+}
+
+TEST_CASE("PerfCounters freezes the counts of stopped OwnThread receivers", "[perf_counters]")
+{
+  ev_loop::EventLoop<Echo, Collector, ev_loop::PerfCounters> loop;
+  loop.start();
+  round_trips(loop, kEvents);
+  loop.stop();
+
+  const auto before = loop.perf_counters().snapshot();
+  std::this_thread::sleep_for(std::chrono::milliseconds{ 5 });
+  const auto after = loop.perf_counters().snapshot();
+  const auto* echo_before = before.thread(ev_loop::detail::type_name<Echo>());
+  const auto* echo_after = after.thread(ev_loop::detail::type_name<Echo>());
+  REQUIRE(echo_before != nullptr);
+  REQUIRE(echo_after != nullptr);
+  REQUIRE(echo_before->cycles == echo_after->cycles);
+  REQUIRE(echo_before->instructions == echo_after->instructions);
+}
+
+TEST_CASE("PerfCounters combines with Utilization", "[perf_counters]")
+{
+  ev_loop::EventLoop<Echo, Collector, ev_loop::Utilization, ev_loop::PerfCounters> loop;
+  loop.start();
+  round_trips(loop, kEvents);
+  loop.stop();
+
+  const auto counters = loop.perf_counters().snapshot();
+  const auto utilization = loop.utilization().snapshot();
+  REQUIRE(counters.threads.size() == 2);
+  REQUIRE(utilization.threads.size() == 2);
+  REQUIRE(counters.thread("loop") != nullptr);
+  const auto* echo = utilization.thread(ev_loop::detail::type_name<Echo>());
+  REQUIRE(echo != nullptr);
+  REQUIRE(echo->dispatches == kEvents);
+}
+
+// =============================================================================
+// Table
+// =============================================================================
+
+TEST_CASE("PerfCounterSnapshot table shows counts, per-event ratios and n/a", "[perf_counters]")
+{
+  ev_loop::PerfCounterSnapshot snapshot;
+  snapshot.threads.push_back(
+    { .name = "loop", .cycles = 4000, .instructions = 8000, .llc_misses = 10, .branch_misses = std::nullopt });
+  snapshot.threads.push_back({ .name = "Worker",
+    .cycles = std::nullopt,
+    .instructions = std::nullopt,
+    .llc_misses = std::nullopt,
+    .branch_misses = std::nullopt });
+
+  REQUIRE(snapshot.threads[0].ipc() == 2.0);
+  REQUIRE_FALSE(snapshot.threads[1].available());
+
+  const std::string totals = snapshot.table();
+  REQUIRE(totals.find("instructions") != std::string::npos);
+  REQUIRE(totals.find("   4000     ") != std::string::npos);
+  REQUIRE(totals.find(" 2.00  ") != std::string::npos);
+  REQUIRE(totals.find("n/a  loop\n") != std::string::npos);
+  REQUIRE(totals.find("n/a  Worker\n") != std::string::npos);
+
+  const std::string per_event = snapshot.table(1000);
+  REQUIRE(per_event.find("cycles/ev") != std::string::npos);
+  REQUIRE(per_event.find(" 4.00  ") != std::string::npos);
+  REQUIRE(per_event.find(" 8.00  ") != std::string::npos);
+  REQUIRE(per_event.find(" 0.01  ") != std::string::npos);
+}
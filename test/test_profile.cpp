@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ev_loop/ev.hpp>
+#include <string>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 10;
+constexpr int kManyEvents = 1600;
+constexpr auto kDelay = std::chrono::milliseconds{ 1 };
+
+using test_receivers::Ping;
+using test_receivers::Pong;
+using test_receivers::Sink;
+using test_receivers::SlowSink;
+using test_receivers::Echo;
+using test_receivers::Collector;
+
+template<typename Loop> void send(Loop& loop, int count)
+{
+  ev_loop::Spin spin{ loop };
+  for (int idx = 0; idx < count; ++idx) {
+    loop.emit(Ping{ idx });
+    while (spin.poll()) {}
+  }
+}
+
+template<typename Loop> std::uint64_t samples_of_sink(Loop& loop)
+{
+  const auto snapshot = loop.profile().snapshot();
+  const auto* sink = snapshot.find(ev_loop::detail::type_name<Sink>(), ev_loop::detail::type_name<Ping>());
+  REQUIRE(sink != nullptr);
+  REQUIRE(sink->dispatches == kManyEvents);
+  return sink->samples;
+}
+
+} // namespace
+
+// =============================================================================
+// Ranking
+// =============================================================================
+
+TEST_CASE("Profile ranks the most expensive handler first", "[profile]")
+{
+  ev_loop::EventLoop<Sink, SlowSink, ev_loop::Profile<1>> loop;
+  loop.get<SlowSink>().delay = kDelay;
+  loop.start();
+  send(loop, kEvents);
+  loop.stop();
+
+  const auto snapshot = loop.profile().snapshot();
+  REQUIRE(snapshot.entries.size() == 2);
+  const auto& slow = snapshot.entries[0];
+  REQUIRE(slow.receiver.ends_with("SlowSink"));
+  REQUIRE(slow.event.ends_with("Ping"));
+  REQUIRE(slow.dispatches == kEvents);
+  REQUIRE(slow.samples == kEvents);
+  REQUIRE(slow.mean >= kDelay);
+  REQUIRE(slow.max >= slow.mean);
+  REQUIRE(slow.estimated_total >= kEvents * kDelay);
+  REQUIRE(snapshot.entries[1].receiver.ends_with("Sink"));
+
+  const std::string table = snapshot.table();
+  REQUIRE(table.find("SlowSink <- ") != std::string::npos);
+  REQUIRE(table.find("SlowSink <- ") < table.find("::Sink <- "));
+  REQUIRE(snapshot.table(1).find("::Sink <- ") == std::string::npos);
+}
+
+// =============================================================================
+// Sampling
+// =============================================================================
+
+TEST_CASE("Profile without jitter samples exactly every Period-th dispatch", "[profile]")
+{
+  ev_loop::EventLoop<Sink, ev_loop::Profile<16, false>> loop;
+  loop.start();
+  send(loop, kManyEvents);
+  loop.stop();
+
+  REQUIRE(samples_of_sink(loop) == kManyEvents / 16);
+}
+
+TEST_CASE("Profile with jitter samples one dispatch in Period on average", "[profile]")
+{
+  ev_loop::EventLoop<Sink, ev_loop::Profile<16>> loop;
+  loop.start();
+  send(loop, kManyEvents);
+  loop.stop();
+
+  const std::uint64_t samples = samples_of_sink(loop);
+  REQUIRE(samples >= 70);
+  REQUIRE(samples <= 130);
+}
+
+TEST_CASE("Profile counts dispatches that were never sampled", "[profile]")
+{
+  ev_loop::EventLoop<Sink, ev_loop::Profile<1000, false>> loop;
+  loop.start();
+  send(loop, kEvents);
+  loop.stop();
+
+  const auto snapshot = loop.profile().snapshot();
+  REQUIRE(snapshot.entries.size() == 1);
+  REQUIRE(snapshot.entries[0].dispatches == kEvents);
+  REQUIRE(snapshot.entries[0].samples == 0);
+  REQUIRE(snapshot.entries[0].estimated_total.count() == 0);
+}
+
+TEST_CASE("Profile covers OwnThread receivers", "[profile]")
+{
+  using Loop = ev_loop::EventLoop<Echo, Collector, ev_loop::Profile<1>>;
+  Loop loop;
+  loop.start();
+  for (int idx = 0; idx < kEvents; ++idx) { loop.emit(Ping{ idx }); }
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received < kEvents; });
+  loop.stop();
+
+  const auto snapshot = loop.profile().snapshot();
+  const auto* echo = snapshot.find(ev_loop::detail::type_name<Echo>(), ev_loop::detail::type_name<Ping>());
+  const auto* collector = snapshot.find(ev_loop::detail::type_name<Collector>(), ev_loop::detail::type_name<Pong>());
+  REQUIRE(echo != nullptr);
+  REQUIRE(collector != nullptr);
+  REQUIRE(echo->samples == kEvents);
+  REQUIRE(collector->samples == kEvents);
+}
+
+// =============================================================================
+// Hardware counters
+// =============================================================================
+
+TEST_CASE("Profile with Counters reads cycles and instructions of the sampled dispatches", "[profile]")
+{
+  ev_loop::EventLoop<Sink, Echo, Collector, ev_loop::Profile<1, false, true>> loop;
+  loop.start();
+  send(loop, kEvents);
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received < kEvents; });
+  loop.stop();
+
+  // Without a PMU, or under a strict perf_event_paranoid, the counts stay empty
+  const auto snapshot = loop.profile().snapshot();
+  REQUIRE(snapshot.entries.size() == 3);
+  for (const auto& entry : snapshot.entries) {
+    REQUIRE(entry.samples == kEvents);
+    REQUIRE(entry.cycles.has_value() == entry.instructions.has_value());
+    if (entry.cycles) {
+      REQUIRE(*entry.cycles > 0);
+      REQUIRE(*entry.instructions > 0);
+    }
+  }
+  const bool counted = snapshot.entries[0].cycles.has_value();
+  REQUIRE((snapshot.table().find("instructions") != std::string::npos) == counted);
+}
+
+TEST_CASE("Profile without Counters leaves cycles and instructions empty", "[profile]")
+{
+  ev_loop::EventLoop<Sink, ev_loop::Profile<1>> loop;
+  loop.start();
+  send(loop, kEvents);
+  loop.stop();
+
+  const auto snapshot = loop.profile().snapshot();
+  REQUIRE(snapshot.entries.size() == 1);
+  REQUIRE_FALSE(snapshot.entries[0].cycles.has_value());
+  REQUIRE_FALSE(snapshot.entries[0].instructions.has_value());
+  REQUIRE(snapshot.table().find("instructions") == std::string::npos);
+}
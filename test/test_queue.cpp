@@ -58,6 +58,16 @@ TEST_CASE("RingBuffer with small capacity", "[ring_buffer]")
     }
   }
 
+  SECTION("positions keep counting past the capacity")
+  {
+    for (int round = 0; round < kWraparoundRounds; ++round) {
+      ring_buffer.push(int{ round });
+      REQUIRE(ring_buffer.tail() == static_cast<std::size_t>(round) + 1);
+      REQUIRE(*ring_buffer.try_pop() == round);
+      REQUIRE(ring_buffer.head() == static_cast<std::size_t>(round) + 1);
+    }
+  }
+
   SECTION("full")
   {
     REQUIRE(ring_buffer.push(1));
@@ -12,6 +12,12 @@ TEST_CASE("RingBuffer::empty and size are noexcept", "[ring_buffer][constexpr]")
   STATIC_REQUIRE(noexcept(std::declval<const ev_loop::detail::RingBuffer<int>&>().size()));
 }
 
+TEST_CASE("RingBuffer::head and tail are noexcept", "[ring_buffer][constexpr]")
+{
+  STATIC_REQUIRE(noexcept(std::declval<const ev_loop::detail::RingBuffer<int>&>().head()));
+  STATIC_REQUIRE(noexcept(std::declval<const ev_loop::detail::RingBuffer<int>&>().tail()));
+}
+
 TEST_CASE("RingBuffer::commit_push is noexcept", "[ring_buffer][constexpr]")
 {
   STATIC_REQUIRE(noexcept(std::declval<ev_loop::detail::RingBuffer<int>&>().commit_push()));
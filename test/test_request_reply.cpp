@@ -0,0 +1,345 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <ev_loop/ev.hpp>
+#include <thread>
+#include <vector>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kRequestCount = 1000;
+constexpr std::size_t kTinyTable = 2;
+constexpr auto kTimeout = std::chrono::milliseconds{ 5 };
+
+struct Square
+{
+  ev_loop::correlation_id correlation_id = 0;
+  int value = 0;
+};
+
+struct Squared
+{
+  ev_loop::correlation_id correlation_id = 0;
+  int value = 0;
+};
+
+struct Kick
+{
+  int value;
+};
+
+// Issues requests from the loop thread and records the answers
+template<typename Tag> struct Requester
+{
+  using receives = ev_loop::type_list<Kick, Squared>;
+  using emits = ev_loop::type_list<Square>;
+  using thread_mode = ev_loop::SameThread;
+
+  std::vector<int> answers;
+  int unmatched = 0;
+  bool accepted = true;
+
+  template<typename D> void on_event(Kick kick, D& dispatcher)
+  {
+    accepted = dispatcher.template request<Squared>(Square{ .correlation_id = 0, .value = kick.value },
+                 [this](Squared reply) { answers.push_back(reply.value); })
+               != 0;
+  }
+
+  template<typename D> void on_event(Squared /*reply*/, D& /*dispatcher*/) { ++unmatched; }
+};
+
+using RequesterA = Requester<struct ATag>;
+using RequesterB = Requester<struct BTag>;
+
+// Issues requests with a deadline and records how each one ended
+struct TimedRequester
+{
+  using receives = ev_loop::type_list<Kick, Squared>;
+  using emits = ev_loop::type_list<Square>;
+  using thread_mode = ev_loop::SameThread;
+
+  struct Continuation
+  {
+    TimedRequester* self;
+    void operator()(Squared reply) const { self->answers.push_back(reply.value); }
+    void operator()(ev_loop::RequestStatus status) const { self->failures.push_back(status); }
+  };
+
+  std::vector<int> answers;
+  std::vector<ev_loop::RequestStatus> failures;
+  std::vector<ev_loop::correlation_id> issued;
+  int unmatched = 0;
+
+  template<typename D> void on_event(Kick kick, D& dispatcher)
+  {
+    issued.push_back(dispatcher.template request<Squared>(
+      Square{ .correlation_id = 0, .value = kick.value }, kTimeout, Continuation{ this }));
+  }
+
+  template<typename D> void on_event(Squared /*reply*/, D& /*dispatcher*/) { ++unmatched; }
+};
+
+template<typename Mode> struct Squarer
+{
+  using receives = ev_loop::type_list<Square>;
+  using emits = ev_loop::type_list<Squared>;
+  using thread_mode = Mode;
+
+  template<typename D> void on_event(Square request, D& dispatcher)
+  {
+    dispatcher.reply(request, Squared{ .correlation_id = 0, .value = request.value * request.value });
+  }
+};
+
+// Holds requests until told to answer, so the slot table can fill up
+struct DeferredSquarer
+{
+  using receives = ev_loop::type_list<Square>;
+  using emits = ev_loop::type_list<Squared>;
+  using thread_mode = ev_loop::SameThread;
+
+  std::vector<Square> held;
+
+  template<typename D> void on_event(Square request, D& /*dispatcher*/) { held.push_back(request); }
+};
+
+// Receives the reply type without ever issuing a request
+template<typename Mode> struct Bystander
+{
+  using receives = ev_loop::type_list<Squared>;
+  using thread_mode = Mode;
+
+  std::atomic<int> received{ 0 };
+
+  template<typename D> void on_event(Squared /*reply*/, D& /*dispatcher*/) { received.fetch_add(1); }
+};
+
+} // namespace
+
+// =============================================================================
+// Routing
+// =============================================================================
+
+TEST_CASE("Replies reach the continuation of the exact requester", "[request_reply]")
+{
+  using Loop =
+    ev_loop::EventLoop<RequesterA, RequesterB, Squarer<ev_loop::SameThread>, ev_loop::RequestReply<>>;
+  Loop loop;
+  loop.start();
+
+  loop.emit(Kick{ 3 });
+  drain(loop);
+
+  // Both requesters see Kick and issue their own request; each gets only its own reply
+  REQUIRE(loop.get<RequesterA>().answers == std::vector<int>{ 9 });
+  REQUIRE(loop.get<RequesterB>().answers == std::vector<int>{ 9 });
+  REQUIRE(loop.get<RequesterA>().unmatched == 0);
+  REQUIRE(loop.get<RequesterB>().unmatched == 0);
+
+  loop.stop();
+}
+
+TEST_CASE("Replies skip every other receiver of the reply type", "[request_reply]")
+{
+  using Loop = ev_loop::EventLoop<TimedRequester,
+    DeferredSquarer,
+    Bystander<ev_loop::SameThread>,
+    Bystander<ev_loop::OwnThread>,
+    ev_loop::RequestReply<>>;
+  Loop loop;
+  loop.start();
+  auto& requester = loop.get<TimedRequester>();
+  auto& local = loop.get<Bystander<ev_loop::SameThread>>();
+  auto& remote = loop.get<Bystander<ev_loop::OwnThread>>();
+
+  // An uncorrelated Squared reaches everyone; the OwnThread inbox is FIFO, so once the marker arrived any
+  // reply delivered there would have arrived too
+  const auto send_marker = [&](int expected) {
+    loop.emit(Squared{ .correlation_id = 0, .value = 0 });
+    ev_loop::Spin{ loop }.run_while([&] { return remote.received.load() < expected; });
+    drain(loop);
+  };
+
+  loop.emit(Kick{ 2 });
+  drain(loop);
+  loop.emit(Squared{ .correlation_id = requester.issued.back(), .value = 4 });
+  send_marker(1);
+  REQUIRE(requester.answers == std::vector<int>{ 4 });
+  REQUIRE(requester.unmatched == 1);
+  REQUIRE(local.received == 1);
+  REQUIRE(remote.received == 1);
+
+  // A late reply goes to the requester's on_event, still not to the bystanders
+  loop.emit(Kick{ 3 });
+  drain(loop);
+  REQUIRE(loop.cancel(requester.issued.back()));
+  loop.emit(Squared{ .correlation_id = requester.issued.back(), .value = 9 });
+  send_marker(2);
+  REQUIRE(requester.unmatched == 3);
+  REQUIRE(local.received == 2);
+  REQUIRE(remote.received == 2);
+
+  loop.stop();
+}
+
+TEST_CASE("Requests round-trip through an OwnThread responder", "[request_reply]")
+{
+  using Loop = ev_loop::EventLoop<RequesterA, Squarer<ev_loop::OwnThread>, ev_loop::RequestReply<4>>;
+  Loop loop;
+  loop.start();
+  auto& requester = loop.get<RequesterA>();
+
+  // More requests than slots: each one completes before the next is issued
+  for (int idx = 0; idx < kRequestCount; ++idx) {
+    loop.emit(Kick{ idx });
+    ev_loop::Wait{ loop }.run_while([&] { return requester.answers.size() <= static_cast<std::size_t>(idx); });
+  }
+
+  REQUIRE(requester.answers.size() == static_cast<std::size_t>(kRequestCount));
+  REQUIRE(requester.answers.back() == (kRequestCount - 1) * (kRequestCount - 1));
+  REQUIRE(requester.unmatched == 0);
+  loop.stop();
+}
+
+// =============================================================================
+// Slot table
+// =============================================================================
+
+TEST_CASE("Request slot table bounds outstanding requests", "[request_reply]")
+{
+  using Loop = ev_loop::EventLoop<RequesterA, DeferredSquarer, ev_loop::RequestReply<kTinyTable>>;
+  Loop loop;
+  loop.start();
+  auto& requester = loop.get<RequesterA>();
+  auto& squarer = loop.get<DeferredSquarer>();
+
+  loop.emit(Kick{ 1 });
+  loop.emit(Kick{ 2 });
+  drain(loop);
+  REQUIRE(requester.accepted);
+  REQUIRE(squarer.held.size() == kTinyTable);
+
+  SECTION("a full table rejects new requests without emitting")
+  {
+    loop.emit(Kick{ 3 });
+    drain(loop);
+    REQUIRE_FALSE(requester.accepted);
+    REQUIRE(squarer.held.size() == kTinyTable);
+  }
+
+  SECTION("answered slots are reused and stale ids are rejected")
+  {
+    const Square first = squarer.held.front();
+    loop.emit(Squared{ .correlation_id = first.correlation_id, .value = 1 });
+    drain(loop);
+    REQUIRE(requester.answers == std::vector<int>{ 1 });
+
+    // Same id again: the slot was released, so this is an unmatched reply
+    loop.emit(Squared{ .correlation_id = first.correlation_id, .value = 1 });
+    drain(loop);
+    REQUIRE(requester.unmatched == 1);
+
+    loop.emit(Kick{ 4 });
+    drain(loop);
+    REQUIRE(requester.accepted);
+    REQUIRE(squarer.held.back().correlation_id != first.correlation_id);
+  }
+
+  SECTION("uncorrelated events bypass the table")
+  {
+    loop.emit(Squared{ .correlation_id = 0, .value = 7 });
+    drain(loop);
+    REQUIRE(requester.unmatched == 1);
+    REQUIRE(requester.answers.empty());
+  }
+
+  loop.stop();
+}
+
+// =============================================================================
+// Timeouts and cancellation
+// =============================================================================
+
+TEST_CASE("Requests without a reply time out and free their slot", "[request_reply]")
+{
+  using Loop = ev_loop::EventLoop<TimedRequester, DeferredSquarer, ev_loop::RequestReply<kTinyTable>>;
+  Loop loop;
+  loop.start();
+  auto& requester = loop.get<TimedRequester>();
+
+  loop.emit(Kick{ 1 });
+  loop.emit(Kick{ 2 });
+  drain(loop);
+  REQUIRE(requester.issued.size() == kTinyTable);
+  REQUIRE(requester.issued.front() != 0);
+
+  // Wait parks until the earliest deadline instead of forever
+  ev_loop::Wait{ loop }.run_while([&] { return requester.failures.size() < kTinyTable; });
+  REQUIRE(requester.failures == std::vector{ ev_loop::RequestStatus::timed_out, ev_loop::RequestStatus::timed_out });
+  REQUIRE(requester.answers.empty());
+
+  // The slots are free again, and a reply that comes too late is unmatched
+  loop.emit(Kick{ 3 });
+  drain(loop);
+  REQUIRE(requester.issued.back() != 0);
+  const Square late = loop.get<DeferredSquarer>().held.front();
+  loop.emit(Squared{ .correlation_id = late.correlation_id, .value = 1 });
+  drain(loop);
+  REQUIRE(requester.unmatched == 1);
+  REQUIRE(requester.answers.empty());
+
+  loop.stop();
+}
+
+TEST_CASE("Cancelled requests tell their continuation and free their slot", "[request_reply]")
+{
+  using Loop = ev_loop::EventLoop<TimedRequester, DeferredSquarer, ev_loop::RequestReply<kTinyTable>>;
+  Loop loop;
+  loop.start();
+  auto& requester = loop.get<TimedRequester>();
+
+  loop.emit(Kick{ 1 });
+  drain(loop);
+  const ev_loop::correlation_id id = requester.issued.back();
+  REQUIRE(loop.cancel(id));
+  REQUIRE(requester.failures == std::vector{ ev_loop::RequestStatus::cancelled });
+  REQUIRE_FALSE(loop.cancel(id));
+
+  // Nothing is left to time out, and the reply falls through to on_event
+  std::this_thread::sleep_for(2 * kTimeout);
+  drain(loop);
+  REQUIRE(requester.failures.size() == 1);
+  loop.emit(Squared{ .correlation_id = id, .value = 1 });
+  drain(loop);
+  REQUIRE(requester.unmatched == 1);
+
+  loop.stop();
+}
+
+TEST_CASE("Cancelling drops continuations that only take the reply", "[request_reply]")
+{
+  using Loop = ev_loop::EventLoop<RequesterA, DeferredSquarer, ev_loop::RequestReply<1>>;
+  Loop loop;
+  loop.start();
+  auto& requester = loop.get<RequesterA>();
+
+  loop.emit(Kick{ 1 });
+  drain(loop);
+  REQUIRE(requester.accepted);
+  REQUIRE(loop.cancel(loop.get<DeferredSquarer>().held.front().correlation_id));
+
+  loop.emit(Kick{ 2 });
+  drain(loop);
+  REQUIRE(requester.accepted);
+  REQUIRE(requester.answers.empty());
+
+  loop.stop();
+}
@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <ev_loop/ev.hpp>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 50;
+constexpr auto kIdle = std::chrono::milliseconds{ 20 };
+
+struct Ping
+{
+  int value;
+};
+
+struct Pong
+{
+  int value;
+};
+
+struct Sink
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/) { ++received; }
+};
+
+struct Echo
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.value }); }
+};
+
+struct Collector
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++received; }
+};
+
+using EchoLoop = ev_loop::EventLoop<Echo, Collector, ev_loop::Trace>;
+
+std::filesystem::path trace_path()
+{
+  return std::filesystem::temp_directory_path() / "ev_loop_test_trace.json";
+}
+
+std::string read_and_remove(const std::filesystem::path& path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  file.close();
+  std::filesystem::remove(path);
+  return contents.str();
+}
+
+std::set<std::string> flow_ids(const std::string& text, const std::string& direction)
+{
+  const std::regex pattern("\"bind_id\":([0-9]+),\"" + direction + "\":true");
+  std::set<std::string> ids;
+  for (auto it = std::sregex_iterator(text.begin(), text.end(), pattern); it != std::sregex_iterator(); ++it) {
+    ids.insert((*it)[1].str());
+  }
+  return ids;
+}
+
+template<typename Loop, typename Strategy> void run_echo(Loop& loop)
+{
+  for (int idx = 0; idx < kEvents; ++idx) {
+    loop.emit(Ping{ idx });
+    Strategy{ loop }.run_while([&] { return loop.template get<Collector>().received <= idx; });
+  }
+}
+
+} // namespace
+
+// =============================================================================
+// Chrome trace output
+// =============================================================================
+
+TEST_CASE("Trace writes dispatch slices linked to their enqueue by flows", "[trace]")
+{
+  const auto path = trace_path();
+  EchoLoop loop;
+  loop.start();
+  {
+    ev_loop::TraceSession session(path.c_str());
+    run_echo<EchoLoop, ev_loop::Spin<EchoLoop>>(loop);
+    REQUIRE(session.dropped() == 0);
+  }
+  loop.stop();
+  const std::string text = read_and_remove(path);
+
+  REQUIRE(text.starts_with("{\"traceEvents\":["));
+  REQUIRE(text.ends_with("\"displayTimeUnit\":\"ns\"}\n"));
+  REQUIRE(count(text, "Echo\",\"cat\":\"dispatch\"") == kEvents);
+  REQUIRE(count(text, "Collector\",\"cat\":\"dispatch\"") == kEvents);
+  // Echo's thread is named after the receiver
+  REQUIRE(text.find("\"name\":\"thread_name\"") != std::string::npos);
+  REQUIRE(text.find("Echo\"}}") != std::string::npos);
+
+  // Ping: test thread -> Echo inbox; Pong: Echo thread -> remote queue -> Collector
+  const auto outgoing = flow_ids(text, "flow_out");
+  const auto incoming = flow_ids(text, "flow_in");
+  REQUIRE(incoming.size() == 2 * kEvents);
+  for (const auto& id : incoming) { REQUIRE(outgoing.contains(id)); }
+}
+
+TEST_CASE("Trace records parks of the loop and OwnThread receivers", "[trace]")
+{
+  const auto path = trace_path();
+  EchoLoop loop;
+  loop.start();
+  {
+    ev_loop::TraceSession session(path.c_str());
+    // Echo parks in its inbox once its spin phase runs out
+    std::this_thread::sleep_for(kIdle);
+    run_echo<EchoLoop, ev_loop::Wait<EchoLoop>>(loop);
+  }
+  loop.stop();
+  const std::string text = read_and_remove(path);
+
+  REQUIRE(count(text, "\"name\":\"park\"") >= 1);
+}
+
+TEST_CASE("Trace records only loops with the Trace option while a session is active", "[trace]")
+{
+  const auto path = trace_path();
+  EchoLoop traced;
+  ev_loop::EventLoop<Sink> untraced;
+  traced.start();
+  untraced.start();
+  // Before the session: not recorded
+  run_echo<EchoLoop, ev_loop::Spin<EchoLoop>>(traced);
+  {
+    ev_loop::TraceSession session(path.c_str());
+    untraced.emit(Ping{ 1 });
+    ev_loop::Spin spin{ untraced };
+    while (spin.poll()) {}
+    session.flush();
+  }
+  traced.stop();
+  untraced.stop();
+  const std::string text = read_and_remove(path);
+
+  REQUIRE(count(text, "\"cat\":\"dispatch\"") == 0);
+  REQUIRE(count(text, "\"cat\":\"enqueue\"") == 0);
+}
+
+TEST_CASE("Only one TraceSession can be active", "[trace]")
+{
+  const auto path = trace_path();
+  {
+    const ev_loop::TraceSession session(path.c_str());
+    REQUIRE_THROWS_AS(ev_loop::TraceSession(path.c_str()), std::system_error);
+  }
+  std::filesystem::remove(path);
+
+  REQUIRE_THROWS_AS(ev_loop::TraceSession("/nonexistent-directory/trace.json"), std::system_error);
+  // A failed session leaves the slot free
+  {
+    const ev_loop::TraceSession session(path.c_str());
+  }
+  std::filesystem::remove(path);
+}
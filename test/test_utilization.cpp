@@ -0,0 +1,205 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <ev_loop/ev.hpp>
+#include <thread>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr int kEvents = 10;
+constexpr auto kDelay = test_receivers::SlowSink::default_delay;
+constexpr auto kIdle = std::chrono::milliseconds{ 50 };
+
+using test_receivers::Ping;
+using test_receivers::SlowSink;
+using test_receivers::Echo;
+using test_receivers::Collector;
+
+struct ParkCounter : ev_loop::NullObserver
+{
+  std::atomic<int> parks{ 0 };
+  void on_park() noexcept { parks.fetch_add(1, std::memory_order_relaxed); }
+};
+
+using EchoLoop = ev_loop::EventLoop<Echo, Collector, ev_loop::Utilization>;
+
+// Every part of a thread's wall time is accounted for exactly once
+void require_consistent(const ev_loop::UtilizationSnapshot::Thread& thread)
+{
+  REQUIRE(thread.handler + thread.parked + thread.spinning >= thread.wall);
+  REQUIRE(thread.handler <= thread.wall);
+  REQUIRE(thread.busy() >= 0.0);
+  REQUIRE(thread.busy() <= 1.0);
+}
+
+} // namespace
+
+// =============================================================================
+// Handler and parked time
+// =============================================================================
+
+TEST_CASE("Utilization measures handler time of the loop thread", "[utilization]")
+{
+  ev_loop::EventLoop<SlowSink, ev_loop::Utilization> loop;
+  loop.start();
+  for (int idx = 0; idx < kEvents; ++idx) { loop.emit(Ping{ idx }); }
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<SlowSink>().received < kEvents; });
+  loop.stop();
+
+  const auto snapshot = loop.utilization().snapshot();
+  const auto* thread = snapshot.thread("loop");
+  REQUIRE(thread != nullptr);
+  REQUIRE(thread->dispatches == kEvents);
+  REQUIRE(thread->handler >= kEvents * kDelay);
+  REQUIRE(thread->busy() > 0.5);
+  require_consistent(*thread);
+#if EV_HAS_EVENTFD
+  REQUIRE(thread->cpu.count() > 0);
+#endif
+}
+
+TEST_CASE("Utilization reports idle OwnThread receivers as parked", "[utilization]")
+{
+  EchoLoop loop;
+  loop.start();
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+  // Echo's inbox parks once its spin phase runs out
+  std::this_thread::sleep_for(kIdle);
+
+  const auto snapshot = loop.utilization().snapshot();
+  const auto* echo = snapshot.thread(ev_loop::detail::type_name<Echo>());
+  REQUIRE(echo != nullptr);
+  REQUIRE(echo->dispatches == 1);
+  REQUIRE(echo->parked > std::chrono::nanoseconds{ 0 });
+  REQUIRE(echo->busy() < 0.5);
+  require_consistent(*echo);
+  loop.stop();
+}
+
+TEST_CASE("Utilization counts the loop thread parked in Wait", "[utilization]")
+{
+  EchoLoop loop;
+  loop.start();
+  std::thread producer([&] {
+    std::this_thread::sleep_for(kIdle);
+    loop.emit(Ping{ 1 });
+  });
+  ev_loop::Wait{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+  producer.join();
+  loop.stop();
+
+  const auto snapshot = loop.utilization().snapshot();
+  const auto* thread = snapshot.thread("loop");
+  REQUIRE(thread != nullptr);
+  REQUIRE(thread->parked > std::chrono::nanoseconds{ 0 });
+  require_consistent(*thread);
+}
+
+TEST_CASE("Utilization freezes the accounts of stopped OwnThread receivers", "[utilization]")
+{
+  EchoLoop loop;
+  loop.start();
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+  loop.stop();
+
+  const auto before = loop.utilization().snapshot();
+  std::this_thread::sleep_for(kDelay);
+  const auto after = loop.utilization().snapshot();
+  const auto* echo_before = before.thread(ev_loop::detail::type_name<Echo>());
+  const auto* echo_after = after.thread(ev_loop::detail::type_name<Echo>());
+  REQUIRE(echo_before != nullptr);
+  REQUIRE(echo_after != nullptr);
+  REQUIRE(echo_before->wall == echo_after->wall);
+  REQUIRE(echo_before->cpu == echo_after->cpu);
+}
+
+TEST_CASE("Utilization freezes the loop thread when the loop stops", "[utilization]")
+{
+  ev_loop::EventLoop<SlowSink, ev_loop::Utilization> loop;
+  loop.start();
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<SlowSink>().received == 0; });
+  loop.stop();
+
+  const auto before = loop.utilization().snapshot();
+  std::this_thread::sleep_for(kIdle);
+  const auto after = loop.utilization().snapshot();
+  const auto* thread_before = before.thread("loop");
+  const auto* thread_after = after.thread("loop");
+  REQUIRE(thread_before != nullptr);
+  REQUIRE(thread_after != nullptr);
+  REQUIRE(thread_before->wall == thread_after->wall);
+  REQUIRE(thread_after->busy() > 0.5);
+
+  // Running again starts the loop thread's accounts afresh
+  loop.start();
+  loop.emit(Ping{ 2 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<SlowSink>().received < 2; });
+  loop.stop();
+  const auto again = loop.utilization().snapshot();
+  REQUIRE(again.threads.size() == 1);
+  REQUIRE(again.threads.front().dispatches == 1);
+  require_consistent(again.threads.front());
+}
+
+TEST_CASE("Utilization keeps separate accounts for loops polled by one thread", "[utilization]")
+{
+  ev_loop::EventLoop<SlowSink, ev_loop::Utilization> first;
+  ev_loop::EventLoop<SlowSink, ev_loop::Utilization> second;
+  first.start();
+  second.start();
+  for (int idx = 0; idx < kEvents; ++idx) {
+    first.emit(Ping{ idx });
+    second.emit(Ping{ idx });
+    second.emit(Ping{ idx });
+    while (ev_loop::Spin{ first }.poll() || ev_loop::Spin{ second }.poll()) {}
+  }
+  first.stop();
+  second.stop();
+
+  const auto first_snapshot = first.utilization().snapshot();
+  const auto second_snapshot = second.utilization().snapshot();
+  const auto* first_thread = first_snapshot.thread("loop");
+  const auto* second_thread = second_snapshot.thread("loop");
+  REQUIRE(first_thread != nullptr);
+  REQUIRE(second_thread != nullptr);
+  REQUIRE(first_thread->dispatches == kEvents);
+  REQUIRE(second_thread->dispatches == 2 * kEvents);
+}
+
+// =============================================================================
+// Composition
+// =============================================================================
+
+TEST_CASE("Utilization combines with Metrics and an Observe policy", "[utilization]")
+{
+  using Loop =
+    ev_loop::EventLoop<Echo, Collector, ev_loop::Metrics, ev_loop::Utilization, ev_loop::Observe<ParkCounter>>;
+  Loop loop;
+  loop.start();
+  std::this_thread::sleep_for(kIdle);
+  loop.emit(Ping{ 1 });
+  ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+  loop.stop();
+
+  REQUIRE(loop.observer().parks.load() >= 1);
+  const auto metrics = loop.metrics().snapshot();
+  const auto* remote = metrics.queue("remote");
+  REQUIRE(remote != nullptr);
+  REQUIRE(remote->dequeued == 1);
+  const auto snapshot = loop.utilization().snapshot();
+  const auto* echo = snapshot.thread(ev_loop::detail::type_name<Echo>());
+  const auto* thread = snapshot.thread("loop");
+  REQUIRE(echo != nullptr);
+  REQUIRE(thread != nullptr);
+  REQUIRE(echo->dispatches == 1);
+  REQUIRE(thread->dispatches == 1);
+}
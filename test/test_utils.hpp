@@ -1,13 +1,27 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <ev_loop/ev.hpp>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <utility>
 
+#if EV_HAS_EVENTFD
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // =============================================================================
 // Waitable mixin for OwnThread receivers (CRTP)
 // =============================================================================
@@ -132,3 +146,136 @@ struct TrackedString
 
   bool operator==(const TrackedString& other) const { return value == other.value; }
 };
+
+// =============================================================================
+// Receivers for the instrumentation tests: Ping -> Echo (OwnThread) -> Pong -> Collector
+// =============================================================================
+
+namespace test_receivers {
+
+struct Ping
+{
+  int value;
+};
+
+struct Pong
+{
+  int value;
+};
+
+struct Sink
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/) { ++received; }
+};
+
+// Blocks the loop thread for delay per event
+struct SlowSink
+{
+  using receives = ev_loop::type_list<Ping>;
+  using thread_mode = ev_loop::SameThread;
+
+  static constexpr std::chrono::milliseconds default_delay{ 5 };
+
+  std::chrono::milliseconds delay = default_delay;
+  int received = 0;
+
+  template<typename D> void on_event(Ping /*ping*/, D& /*dispatcher*/)
+  {
+    std::this_thread::sleep_for(delay);
+    ++received;
+  }
+};
+
+struct Echo
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher) { dispatcher.emit(Pong{ ping.value }); }
+};
+
+struct Collector
+{
+  using receives = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::SameThread;
+
+  int received = 0;
+
+  template<typename D> void on_event(Pong /*pong*/, D& /*dispatcher*/) { ++received; }
+};
+
+} // namespace test_receivers
+
+// =============================================================================
+// Run the loop from the test thread until its queues are empty
+// =============================================================================
+
+template<typename Loop> void drain(Loop& loop)
+{
+  ev_loop::Spin spin{ loop };
+  while (spin.poll()) {}
+}
+
+// =============================================================================
+// Text and pipe helpers
+// =============================================================================
+
+// Non-overlapping occurrences of needle in text
+inline std::size_t count(const std::string& text, std::string_view needle)
+{
+  std::size_t found = 0;
+  for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size())) {
+    ++found;
+  }
+  return found;
+}
+
+#if EV_HAS_EVENTFD
+// RAII pipe pair. capacity > 0 grows the pipe (best effort) so that much can be written without a reader.
+struct Pipe
+{
+  std::array<int, 2> fds{ -1, -1 };
+
+  explicit Pipe(int flags = O_CLOEXEC, int capacity = 0)
+  {
+    if (::pipe2(fds.data(), flags) != 0) { throw std::system_error(errno, std::system_category(), "pipe2"); }
+    if (capacity > 0) { std::ignore = ::fcntl(fds[1], F_SETPIPE_SZ, capacity); }
+  }
+
+  Pipe(const Pipe&) = delete;
+  Pipe& operator=(const Pipe&) = delete;
+  Pipe(Pipe&&) = delete;
+  Pipe& operator=(Pipe&&) = delete;
+
+  ~Pipe()
+  {
+    for (const int fd : fds) {
+      if (fd >= 0) { ::close(fd); }
+    }
+  }
+
+  [[nodiscard]] int read_end() const { return fds[0]; }
+  [[nodiscard]] int write_end() const { return fds[1]; }
+  [[nodiscard]] bool send(char byte) const { return ::write(fds[1], &byte, 1) == 1; }
+
+  // Close the write end and read until EOF; needs a blocking read end
+  std::string read_all()
+  {
+    ::close(fds[1]);
+    fds[1] = -1;
+    std::string text;
+    std::array<char, 4096> buffer{};
+    ssize_t got = 0;
+    while ((got = ::read(fds[0], buffer.data(), buffer.size())) > 0) {
+      text.append(buffer.data(), static_cast<std::size_t>(got));
+    }
+    return text;
+  }
+};
+#endif
@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <ev_loop/ev.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "test_utils.hpp"
+
+// =============================================================================
+// Test helper types
+// =============================================================================
+
+namespace {
+
+constexpr auto kThreshold = std::chrono::milliseconds{ 10 };
+constexpr auto kInterval = std::chrono::milliseconds{ 1 };
+constexpr auto kStall = std::chrono::milliseconds{ 60 };
+// Far above scheduling jitter, for the cases that must not report
+constexpr auto kQuietThreshold = std::chrono::milliseconds{ 1000 };
+
+using test_receivers::Ping;
+using test_receivers::Pong;
+using test_receivers::Sink;
+using test_receivers::SlowSink;
+using test_receivers::Echo;
+using test_receivers::Collector;
+
+// Blocks its own thread for kStall
+struct SlowEcho
+{
+  using receives = ev_loop::type_list<Ping>;
+  using emits = ev_loop::type_list<Pong>;
+  using thread_mode = ev_loop::OwnThread;
+
+  template<typename D> void on_event(Ping ping, D& dispatcher)
+  {
+    std::this_thread::sleep_for(kStall);
+    dispatcher.emit(Pong{ ping.value });
+  }
+};
+
+// Thread-safe copy of every report
+struct Reports
+{
+  std::mutex mutex;
+  std::vector<ev_loop::StallReport> reports;
+
+  ev_loop::WatchdogConfig config(std::chrono::milliseconds threshold = kThreshold)
+  {
+    return { .threshold = threshold, .interval = kInterval, .on_stall = [this](const ev_loop::StallReport& report) {
+              const std::scoped_lock lock(mutex);
+              reports.push_back(report);
+            } };
+  }
+
+  std::vector<ev_loop::StallReport> take()
+  {
+    const std::scoped_lock lock(mutex);
+    return reports;
+  }
+};
+
+} // namespace
+
+// =============================================================================
+// Slow handlers
+// =============================================================================
+
+TEST_CASE("Watchdog reports a handler blocking the loop thread once", "[watchdog]")
+{
+  ev_loop::EventLoop<Sink, SlowSink, ev_loop::Watchdog> loop;
+  loop.get<SlowSink>().delay = kStall;
+  Reports reports;
+  loop.start();
+  {
+    ev_loop::StallWatchdog watchdog(loop, reports.config());
+    loop.emit(Ping{ 1 });
+    ev_loop::Spin{ loop }.run_while([&] { return loop.get<SlowSink>().received == 0; });
+  }
+  loop.stop();
+
+  const auto seen = reports.take();
+  REQUIRE(seen.size() == 1);
+  REQUIRE(seen[0].kind == ev_loop::StallReport::Kind::slow_handler);
+  REQUIRE(seen[0].thread == "loop");
+  REQUIRE(seen[0].receiver.ends_with("SlowSink"));
+  REQUIRE(seen[0].event.ends_with("Ping"));
+  REQUIRE(seen[0].duration >= kThreshold);
+}
+
+TEST_CASE("Watchdog reports a slow OwnThread handler on its own thread", "[watchdog]")
+{
+  ev_loop::EventLoop<SlowEcho, Collector, ev_loop::Watchdog> loop;
+  Reports reports;
+  loop.start();
+  {
+    ev_loop::StallWatchdog watchdog(loop, reports.config());
+    loop.emit(Ping{ 1 });
+    ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+    REQUIRE(watchdog.stalls() == 1);
+  }
+  loop.stop();
+
+  const auto seen = reports.take();
+  REQUIRE(seen.size() == 1);
+  REQUIRE(seen[0].kind == ev_loop::StallReport::Kind::slow_handler);
+  REQUIRE(seen[0].thread.ends_with("SlowEcho"));
+  REQUIRE(seen[0].receiver == seen[0].thread);
+}
+
+// =============================================================================
+// Stuck queues
+// =============================================================================
+
+TEST_CASE("Watchdog reports a loop queue nobody drains", "[watchdog]")
+{
+  ev_loop::EventLoop<Echo, Collector, ev_loop::Watchdog> loop;
+  Reports reports;
+  loop.start();
+  {
+    ev_loop::StallWatchdog watchdog(loop, reports.config());
+    // Echo answers into the remote queue, which stays full while nothing polls the loop
+    loop.emit(Ping{ 1 });
+    std::this_thread::sleep_for(kStall);
+    ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received == 0; });
+    std::this_thread::sleep_for(kStall);
+  }
+  loop.stop();
+
+  const auto seen = reports.take();
+  REQUIRE(seen.size() == 1);
+  REQUIRE(seen[0].kind == ev_loop::StallReport::Kind::stuck_queue);
+  REQUIRE(seen[0].thread == "loop");
+}
+
+TEST_CASE("Watchdog stays quiet while the loop keeps up", "[watchdog]")
+{
+  ev_loop::EventLoop<Echo, Collector, ev_loop::Watchdog> loop;
+  Reports reports;
+  loop.start();
+  {
+    const ev_loop::StallWatchdog watchdog(loop, reports.config(kQuietThreshold));
+    const auto deadline = std::chrono::steady_clock::now() + kStall;
+    int sent = 0;
+    while (std::chrono::steady_clock::now() < deadline) {
+      loop.emit(Ping{ sent++ });
+      ev_loop::Spin{ loop }.run_while([&] { return loop.get<Collector>().received < sent; });
+    }
+    // Idle, with empty queues
+    std::this_thread::sleep_for(kStall);
+  }
+  loop.stop();
+
+  REQUIRE(reports.take().empty());
+}
+
+// =============================================================================
+// Stamps
+// =============================================================================
+
+TEST_CASE("DispatchStamp publishes the start tick and label together", "[watchdog]")
+{
+  ev_loop::detail::DispatchStamp stamp;
+  REQUIRE(stamp.running().started == 0);
+  REQUIRE(stamp.running().label == nullptr);
+
+  stamp.begin<Sink, Ping>();
+  const auto running = stamp.running();
+  REQUIRE(running.started != 0);
+  REQUIRE(running.label == &ev_loop::detail::trace_label<Sink, Ping>);
+
+  stamp.end();
+  REQUIRE(stamp.running().started == 0);
+  REQUIRE(stamp.running().label == running.label);
+  REQUIRE(stamp.completed.load() == 1);
+  REQUIRE(stamp.sequence.load() % 2 == 0);
+}
+
+TEST_CASE("OwnThread inboxes report a backlog without locking", "[watchdog]")
+{
+  ev_loop::detail::InboxBacklog backlog;
+  REQUIRE_FALSE(backlog.pending());
+  backlog.pushed.store(2);
+  backlog.popped.store(1);
+  REQUIRE(backlog.pending());
+  backlog.popped.store(2);
+  REQUIRE_FALSE(backlog.pending());
+
+  // A pop counted before its push is not a backlog
+  backlog.popped.store(3);
+  REQUIRE_FALSE(backlog.pending());
+}